@@ -0,0 +1,79 @@
+#ifndef BENCHMARKS__BENCH_H
+#define BENCHMARKS__BENCH_H
+
+// Tiny timing harness shared by the micro-benchmarks.
+//
+// Each benchmark body is run repeatedly until at least minSeconds have
+// passed, and the caller turns the iteration count into a rate.
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace bench
+{
+
+inline double now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart / frequency.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+// Result of run(): how many times the body ran and for how long
+struct Timing {
+    unsigned long iterations;
+    double seconds;
+
+    inline double perSecond() const
+    {
+        return iterations / seconds;
+    }
+
+    inline double nsPerIteration() const
+    {
+        return seconds * 1e9 / iterations;
+    }
+};
+
+// Call body() in batches until minSeconds have elapsed
+template <typename Body>
+Timing run(Body &body, double minSeconds = 0.5)
+{
+    Timing t;
+    unsigned long batch = 1;
+    double start = now();
+
+    t.iterations = 0;
+
+    do {
+        for (unsigned long i = 0; i < batch; i++) {
+            body();
+        }
+
+        t.iterations += batch;
+
+        if (batch < (1UL << 20)) {
+            batch *= 2;
+        }
+
+        t.seconds = now() - start;
+    } while (t.seconds < minSeconds);
+
+    return t;
+}
+
+} // namespace bench
+
+#endif // BENCHMARKS__BENCH_H
@@ -0,0 +1,231 @@
+// Throughput baseline for the display layer: the pixel kernels behind
+// LegacySurface::maskCopy(), filter() and Xor copies against the
+// byte-at-a-time loops they replaced, then the LegacySurface operations
+// the game uses most, on full 320x200 surfaces.
+//
+// usage: display_bench [seconds per case]
+
+#include "display/legacy_surface.h"
+#include "display/pixel_kernels.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using display::LegacySurface;
+using display::PixelKernels;
+
+static const unsigned int WIDTH = 320;
+static const unsigned int HEIGHT = 200;
+static const unsigned int PIXELS = WIDTH * HEIGHT;
+
+static std::vector<uint8_t> source(PIXELS);
+static std::vector<uint8_t> target(PIXELS);
+
+// The old LegacySurface::maskCopy() loop, deciding the mode per pixel
+struct LegacyMask {
+    LegacyMask(LegacySurface::MaskSource m) : mode(m) {}
+
+    void operator()()
+    {
+        const char maskValue = 0;
+        const char offset = 16;
+
+        for (unsigned int i = 0; i < PIXELS; i++) {
+            const char *src = (const char *)&source[0] + i;
+            char *dst = (char *)&target[0] + i;
+
+            switch (mode) {
+            case LegacySurface::SourceEqual:
+                if (*src == maskValue) {
+                    *dst = (*src) + offset;
+                }
+
+                break;
+
+            case LegacySurface::SourceNotEqual:
+                if (*src != maskValue) {
+                    *dst = (*src) + offset;
+                }
+
+                break;
+
+            case LegacySurface::DestinationEqual:
+                if (*dst == maskValue) {
+                    *dst = (*src) + offset;
+                }
+
+                break;
+
+            case LegacySurface::DestinationNotEqual:
+                if (*dst != maskValue) {
+                    *dst = (*src) + offset;
+                }
+
+                break;
+            }
+        }
+    }
+
+    LegacySurface::MaskSource mode;
+};
+
+// The old copyTo(..., Xor) inner loop
+struct LegacyXor {
+    void operator()()
+    {
+        for (unsigned int i = 0; i < PIXELS; i++) {
+            target[i] ^= source[i];
+        }
+    }
+};
+
+struct KernelMask {
+    KernelMask(const PixelKernels &k) : kernels(k) {}
+
+    void operator()()
+    {
+        kernels.maskCopy(&target[0], &source[0], PIXELS, 0,
+                         PixelKernels::SourceNotEqual, 16);
+    }
+
+    const PixelKernels &kernels;
+};
+
+struct KernelFilter {
+    KernelFilter(const PixelKernels &k) : kernels(k) {}
+
+    void operator()()
+    {
+        kernels.filter(&target[0], PIXELS, 0, 16, PixelKernels::NotEqual);
+    }
+
+    const PixelKernels &kernels;
+};
+
+struct KernelXor {
+    KernelXor(const PixelKernels &k) : kernels(k) {}
+
+    void operator()()
+    {
+        kernels.xorCopy(&target[0], &source[0], PIXELS);
+    }
+
+    const PixelKernels &kernels;
+};
+
+// LegacySurface operations, each covering a full screen
+struct SurfaceCase {
+    enum Op {
+        FillRect,
+        CopyTo,
+        CopyToXor,
+        MaskCopy,
+        Filter,
+        ScaleTo,
+        Line
+    };
+
+    SurfaceCase(Op o, LegacySurface &s, LegacySurface &d, LegacySurface &h)
+        : op(o), src(s), dst(d), half(h) {}
+
+    void operator()()
+    {
+        switch (op) {
+        case FillRect:
+            dst.fillRect(0, 0, WIDTH - 1, HEIGHT - 1, 5);
+            break;
+
+        case CopyTo:
+            src.copyTo(&dst, 0, 0);
+            break;
+
+        case CopyToXor:
+            src.copyTo(&dst, 0, 0, LegacySurface::Xor);
+            break;
+
+        case MaskCopy:
+            dst.maskCopy(&src, 0, LegacySurface::SourceNotEqual, 16);
+            break;
+
+        case Filter:
+            dst.filter(0, 16, LegacySurface::NotEqual);
+            break;
+
+        case ScaleTo:
+            src.scaleTo(&half);
+            break;
+
+        case Line:
+            // One line per row, as wide as the screen
+            for (unsigned int y = 0; y < HEIGHT; y++) {
+                dst.line(0, y, WIDTH - 1, HEIGHT - 1 - y, 9);
+            }
+
+            break;
+        }
+
+        dst.clearDirty();
+    }
+
+    Op op;
+    LegacySurface &src;
+    LegacySurface &dst;
+    LegacySurface &half;
+};
+
+static void report(const char *group, const char *name, const bench::Timing &t)
+{
+    printf("%-10s %-12s %10.1f Mpixel/s  %8.1f us/frame\n", group, name,
+           PIXELS * t.perSecond() / 1e6, t.seconds * 1e6 / t.iterations);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+
+    // Mostly zero, like the sprite sheets maskCopy() is used on
+    for (unsigned int i = 0; i < PIXELS; i++) {
+        source[i] = (rand() % 4 == 0) ? rand() & 0xff : 0;
+        target[i] = rand() & 0xff;
+    }
+
+    LegacyMask legacyMask(LegacySurface::SourceNotEqual);
+    LegacyXor legacyXor;
+    report("maskCopy", "legacy", bench::run(legacyMask, seconds));
+    report("xor", "legacy", bench::run(legacyXor, seconds));
+
+    for (int k = PixelKernels::Scalar; k <= PixelKernels::AVX2; k++) {
+        PixelKernels::Kernel kernel = (PixelKernels::Kernel) k;
+
+        if (!PixelKernels::supported(kernel)) {
+            continue;
+        }
+
+        PixelKernels kernels(kernel);
+        KernelMask mask(kernels);
+        KernelFilter filter(kernels);
+        KernelXor xorCopy(kernels);
+        report("maskCopy", PixelKernels::kernelName(kernel), bench::run(mask, seconds));
+        report("filter", PixelKernels::kernelName(kernel), bench::run(filter, seconds));
+        report("xor", PixelKernels::kernelName(kernel), bench::run(xorCopy, seconds));
+    }
+
+    LegacySurface src(WIDTH, HEIGHT);
+    LegacySurface dst(WIDTH, HEIGHT);
+    LegacySurface half(WIDTH / 2, HEIGHT / 2);
+    src.clear(0);
+    src.fillRect(40, 40, 279, 159, 3);
+
+    const char *names[] = {
+        "fillRect", "copyTo", "copyTo xor", "maskCopy", "filter", "scaleTo", "line"
+    };
+
+    for (int op = SurfaceCase::FillRect; op <= SurfaceCase::Line; op++) {
+        SurfaceCase c((SurfaceCase::Op) op, src, dst, half);
+        report("surface", names[op], bench::run(c, seconds));
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Measures drawing 10,000 strings with the stroke font the way
+// draw_string() used to, one line per stroke and a call per pixel,
+// against blitting the same strings from the glyph atlas.
+//
+// usage: glyph_bench [seconds per variant]
+
+#include "game/glyph_atlas.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+static const int WIDTH = 320;
+static const int HEIGHT = 200;
+static const int STRINGS = 10000;
+
+static const char *const text[] = {
+    "DIRECTOR OF THE SPACE PROGRAM",
+    "MERCURY: 3 SAFETY 87%",
+    "PROGRAM NAME: ATLAS-CENTAUR",
+    "1964 FALL  BUDGET: 125 MB",
+    "LUNAR ORBITAL ACTIVITY (LOA)",
+    "WHAT SHOULD WE DO NEXT?",
+};
+
+static const int TEXT_COUNT = sizeof(text) / sizeof(text[0]);
+
+static std::vector<char> screen(WIDTH * HEIGHT);
+
+// Stand-in for LegacySurface::setPixel(): grow the dirty area, then write
+struct Target {
+    int left, top, right, bottom;
+    char color;
+};
+
+static void plot(struct glyph_pen *pen, int x, int y)
+{
+    Target *target = static_cast<Target *>(pen->data);
+
+    target->left = std::min(target->left, x);
+    target->top = std::min(target->top, y);
+    target->right = std::max(target->right, x + 1);
+    target->bottom = std::max(target->bottom, y + 1);
+    screen[y * WIDTH + x] = target->color;
+}
+
+struct StrokeStrings {
+    void operator()()
+    {
+        Target target = { WIDTH, HEIGHT, 0, 0, 11 };
+
+        for (int i = 0; i < STRINGS; i++) {
+            const char *s = text[i % TEXT_COUNT];
+            struct glyph_pen pen = { 2 + i % 100, 8 + i % 180, plot, &target };
+
+            for (size_t n = 0; n < strlen(s); n++) {
+                glyph_stroke(&pen, s[n]);
+            }
+        }
+    }
+};
+
+struct AtlasStrings {
+    void operator()()
+    {
+        struct glyph_rect touched;
+
+        for (int i = 0; i < STRINGS; i++) {
+            const char *s = text[i % TEXT_COUNT];
+            int x = 2 + i % 100, y = 8 + i % 180;
+
+            glyph_draw(&screen[0], WIDTH, WIDTH, HEIGHT, &x, &y,
+                       s, strlen(s), 11, &touched);
+        }
+    }
+};
+
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+
+    StrokeStrings strokes;
+    AtlasStrings atlas;
+
+    // Build the atlas up front so it isn't counted
+    glyph_get('A');
+
+    bench::Timing before = bench::run(strokes, seconds);
+    bench::Timing after = bench::run(atlas, seconds);
+
+    printf("%-8s %10.3f ms per %d strings\n", "strokes",
+           before.nsPerIteration() / 1e6, STRINGS);
+    printf("%-8s %10.3f ms per %d strings\n", "atlas",
+           after.nsPerIteration() / 1e6, STRINGS);
+    printf("speedup  %.1fx\n", after.perSecond() / before.perSecond());
+
+    return screen[0] == 1;
+}
@@ -0,0 +1,134 @@
+// Compares reading Ogg files through stdio and ogg_sync, as mm_open()
+// does, with parsing pages in place from mm_open_mapped(): bytes copied
+// before the Ogg layer sees them, time from open to the first decoded
+// frame, and time to decode every file to its end.
+//
+// usage: media_bench <video dir> [passes]
+
+#include "game/mmfile.h"
+#include "bench.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+static void find_files(const std::string &dir, std::vector<std::string> &files)
+{
+    DIR *d = opendir(dir.c_str());
+    struct dirent *ent;
+
+    if (!d) {
+        return;
+    }
+
+    while ((ent = readdir(d)) != NULL) {
+        std::string name = ent->d_name;
+        size_t len = name.size();
+
+        if (name[0] == '.') {
+            continue;
+        }
+
+        if (len > 4 && name.compare(len - 4, 4, ".ogg") == 0) {
+            files.push_back(dir + "/" + name);
+        } else {
+            find_files(dir + "/" + name, files);
+        }
+    }
+
+    closedir(d);
+}
+
+// Decode one frame of video, or one buffer of audio for voice files
+static int decode_one(mm_file *mf)
+{
+    static char audio[16384];
+
+    if (mf->video) {
+        return mm_decode_video_frame(mf);
+    }
+
+    return mm_decode_audio(mf, audio, sizeof(audio));
+}
+
+struct Totals {
+    Totals() : files(0), failed(0), copied(0), first(0), all(0) {}
+
+    unsigned files;
+    unsigned failed;
+    double copied;
+    double first;
+    double all;
+};
+
+static void play(const std::string &path, bool mapped, Totals &totals)
+{
+    mm_file mf;
+    double start = bench::now();
+    int rv = mapped ? mm_open_mapped(&mf, path.c_str())
+             : mm_open(&mf, path.c_str());
+
+    if (rv <= 0) {
+        totals.failed++;
+        return;
+    }
+
+    decode_one(&mf);
+    totals.first += bench::now() - start;
+
+    while (decode_one(&mf) > 0)
+        ;
+
+    totals.all += bench::now() - start;
+    totals.copied += mf.copied;
+    totals.files++;
+    mm_close(&mf);
+}
+
+static void report(const char *name, const Totals &t, unsigned passes)
+{
+    printf("%-8s %4u files %3u failed  %8.2f MB copied  "
+           "%7.3f ms to first frame  %8.1f ms to end\n",
+           name, t.files / passes, t.failed / passes,
+           t.copied / passes / 1e6, t.first * 1e3 / t.files,
+           t.all * 1e3 / passes);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <video dir> [passes]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned passes = (argc > 2) ? atoi(argv[2]) : 3;
+    std::vector<std::string> files;
+    Totals warmup, stdio, mapped;
+
+    find_files(argv[1], files);
+
+    if (files.empty() || passes < 1) {
+        fprintf(stderr, "no .ogg files under %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    // Read everything once so both variants find it in the page cache
+    for (size_t i = 0; i < files.size(); i++) {
+        play(files[i], false, warmup);
+    }
+
+    for (unsigned pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < files.size(); i++) {
+            play(files[i], false, stdio);
+            play(files[i], true, mapped);
+        }
+    }
+
+    report("stdio", stdio, passes);
+    report("mapped", mapped, passes);
+    return EXIT_SUCCESS;
+}
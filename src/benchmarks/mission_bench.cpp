@@ -0,0 +1,90 @@
+// Measures GetMissionPlan() against the old way of opening MISSION.DAT
+// and reading one record on every call.
+//
+// usage: mission_bench <gamedata dir> [seconds per variant]
+
+#include "game/Buzz_inc.h"
+#include "game/options.h"
+#include "game/mission_util.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// fs.cpp finds files through the options normally set up by options.cpp
+game_options options;
+
+// Codes cycled through by both variants
+static const int MISSION_CODES = 60;
+
+static int sink;
+
+// The old GetMissionPlan() body
+struct LegacyPlan {
+    LegacyPlan() : code(0) {}
+
+    void operator()()
+    {
+        struct mStr mission;
+        FILE *fin = sOpen("MISSION.DAT", "rb", 0);
+
+        fseek(fin, code * (sizeof(struct mStr)), SEEK_SET);
+
+        if (fread(&mission, sizeof(struct mStr), 1, fin) == 1) {
+            sink += mission.Doc;
+        }
+
+        fclose(fin);
+        code = (code + 1) % MISSION_CODES;
+    }
+
+    int code;
+};
+
+struct TablePlan {
+    TablePlan() : code(0) {}
+
+    void operator()()
+    {
+        sink += GetMissionPlan(code).Doc;
+        code = (code + 1) % MISSION_CODES;
+    }
+
+    int code;
+};
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gamedata dir> [seconds]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+
+    options.dir_gamedata = argv[1];
+    options.dir_savegame = argv[1];
+
+    FILE *probe = sOpen("MISSION.DAT", "rb", 0);
+
+    if (!probe) {
+        fprintf(stderr, "no MISSION.DAT under %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    fclose(probe);
+
+    LegacyPlan legacy;
+    TablePlan table;
+    bench::Timing before = bench::run(legacy, seconds);
+    bench::Timing after = bench::run(table, seconds);
+
+    printf("%-8s %14s %12s\n", "variant", "calls/s", "ns/call");
+    printf("%-8s %14.0f %12.1f\n", "legacy",
+           before.perSecond(), before.nsPerIteration());
+    printf("%-8s %14.0f %12.1f\n", "table",
+           after.perSecond(), after.nsPerIteration());
+    printf("speedup  %.1fx\n", after.perSecond() / before.perSecond());
+
+    return sink == -1;
+}
@@ -0,0 +1,109 @@
+// Measures the cost of mixing PCM the way audio_callback() does, without
+// opening an audio device: N channels of 11025 Hz mono 16-bit samples are
+// mixed into one callback-sized buffer.
+//
+// usage: mixer_bench [channels] [seconds per kernel]
+
+#include "game/mixer.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// audio_desired.samples in av_setup()
+static const unsigned int BUFFER_SAMPLES = 2048;
+
+// The old audio_callback() inner loop
+struct LegacyMix {
+    LegacyMix(std::vector<std::vector<int16_t> > &s, std::vector<int16_t> &o)
+        : sources(s), out(o) {}
+
+    void operator()()
+    {
+        memset(&out[0], 0, out.size() * sizeof(int16_t));
+
+        for (unsigned int ch = 0; ch < sources.size(); ch++) {
+            const int16_t *src = &sources[ch][0];
+            int16_t *dst = &out[0];
+            unsigned int volume = 128;
+
+            for (unsigned int i = 0; i < out.size(); ++i) {
+                dst[i] += src[i] * volume / 128 / sources.size();
+            }
+        }
+    }
+
+    std::vector<std::vector<int16_t> > &sources;
+    std::vector<int16_t> &out;
+};
+
+struct Mix {
+    Mix(std::vector<std::vector<int16_t> > &s, std::vector<int16_t> &o)
+        : sources(s), out(o), voices(s.size())
+    {
+        for (unsigned int ch = 0; ch < voices.size(); ch++) {
+            mixer_init_voice(&voices[ch], mixer_gain(128, 128, voices.size()));
+        }
+    }
+
+    void operator()()
+    {
+        memset(&out[0], 0, out.size() * sizeof(int16_t));
+
+        for (unsigned int ch = 0; ch < sources.size(); ch++) {
+            mixer_mix(&out[0], &sources[ch][0], out.size(), &voices[ch]);
+        }
+    }
+
+    std::vector<std::vector<int16_t> > &sources;
+    std::vector<int16_t> &out;
+    std::vector<mixer_voice> voices;
+};
+
+static void report(const char *name, unsigned int channels, const bench::Timing &t)
+{
+    double samples = (double) t.iterations * BUFFER_SAMPLES;
+    double ns = t.seconds * 1e9 / samples;
+
+    // one callback buffer holds BUFFER_SAMPLES / 11025 seconds of audio
+    printf("%-8s %2u channels  %7.3f ns/sample  %6.2f us/callback  (%.4f%% of real time)\n",
+           name, channels, ns, ns * BUFFER_SAMPLES / 1e3,
+           ns * 11025 / 1e9 * 100);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int channels = (argc > 1) ? atoi(argv[1]) : 2;
+    double seconds = (argc > 2) ? atof(argv[2]) : 0.5;
+
+    if (channels < 1) {
+        channels = 1;
+    }
+
+    std::vector<std::vector<int16_t> > sources(channels, std::vector<int16_t>(BUFFER_SAMPLES));
+    std::vector<int16_t> out(BUFFER_SAMPLES);
+
+    for (unsigned int ch = 0; ch < channels; ch++) {
+        for (unsigned int i = 0; i < BUFFER_SAMPLES; i++) {
+            sources[ch][i] = (int16_t)(rand() - RAND_MAX / 2);
+        }
+    }
+
+    LegacyMix legacy(sources, out);
+    report("legacy", channels, bench::run(legacy, seconds));
+
+    mixer_use_scalar(1);
+    Mix scalar(sources, out);
+    report(mixer_kernel_name(), channels, bench::run(scalar, seconds));
+
+    mixer_use_scalar(0);
+
+    if (strcmp(mixer_kernel_name(), "scalar") != 0) {
+        Mix simd(sources, out);
+        report(mixer_kernel_name(), channels, bench::run(simd, seconds));
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Measures building the load screen's file list from a directory of
+// generated saves: the old open-and-read-every-header scan against
+// ReadSaveCatalog() with a cold and a warm catalog.
+//
+// usage: save_catalog_bench <empty scratch dir> [saves]
+
+#include "game/Buzz_inc.h"
+#include "game/options.h"
+#include "game/save_catalog.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// fs.cpp finds files through the options normally set up by options.cpp
+game_options options;
+
+static int sink;
+
+static void make_saves(int count)
+{
+    char name[32];
+    char payload[4096];
+    SaveFileHdr header;
+
+    memset(payload, 0x55, sizeof(payload));
+
+    for (int i = 0; i < count; i++) {
+        memset(&header, 0, sizeof(header));
+        header.ID = RaceIntoSpace_Signature;
+        snprintf(header.Name, sizeof(header.Name), "GAME %05d", count - i);
+        header.Country[0] = (i % 10 == 0) ? 8 : 0;
+        header.Country[1] = 1;
+        header.dataSize = sizeof(payload);
+
+        snprintf(name, sizeof(name), "B%05d.SAV", i);
+        FILE *f = sOpen(name, "wb", FT_SAVE);
+
+        if (!f) {
+            fprintf(stderr, "can't create %s\n", name);
+            exit(EXIT_FAILURE);
+        }
+
+        fwrite(&header, sizeof(header), 1, f);
+        fwrite(payload, sizeof(payload), 1, f);
+        fclose(f);
+    }
+}
+
+// The old GenerateTables() loop, without its 100 file limit
+struct LegacyScan {
+    void operator()()
+    {
+        struct ffblk ffblk;
+        SaveFileHdr header;
+
+        for (int done = first_saved_game(&ffblk); !done;
+             done = next_saved_game(&ffblk)) {
+            FILE *fin = sOpen(ffblk.ff_name, "rb", FT_SAVE);
+
+            if (fin == NULL) {
+                continue;
+            }
+
+            fread(&header, 1, sizeof(header), fin);
+            fclose(fin);
+            sink += header.Name[5];
+        }
+    }
+};
+
+struct CatalogScan {
+    void operator()()
+    {
+        sink += ReadSaveCatalog().size();
+    }
+};
+
+static void report(const char *variant, const bench::Timing &t, int saves)
+{
+    printf("%-14s %10.2f ms/list %12.0f saves/s\n", variant,
+           t.nsPerIteration() / 1e6, t.perSecond() * saves);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <empty scratch dir> [saves]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int count = (argc > 2) ? atoi(argv[2]) : 5000;
+
+    options.dir_gamedata = argv[1];
+    options.dir_savegame = argv[1];
+
+    make_saves(count);
+    printf("%d saves in %s\n", count, argv[1]);
+
+    LegacyScan legacy;
+    CatalogScan catalog;
+
+    bench::Timing before = bench::run(legacy, 1.0);
+    report("legacy", before, count);
+
+    // The first catalog read opens every save and writes the catalog
+    double start = bench::now();
+    catalog();
+    bench::Timing cold = {1, bench::now() - start};
+    report("catalog cold", cold, count);
+
+    bench::Timing warm = bench::run(catalog, 1.0);
+    report("catalog warm", warm, count);
+
+    printf("speedup  %.1fx\n", warm.perSecond() / before.perSecond());
+
+    remove_savedat("SAVES.CAT");
+
+    for (int i = 0; i < count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "B%05d.SAV", i);
+        remove_savedat(name);
+    }
+
+    return sink == -1;
+}
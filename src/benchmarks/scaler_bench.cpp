@@ -0,0 +1,122 @@
+// Measures the display::Scaler kernels against the per-pixel 2x scaler
+// av_sync() used to run on every frame, plus the fused palette lookup path.
+//
+// usage: scaler_bench [seconds per kernel]
+
+#include "display/scaler.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using display::Scaler;
+
+static const unsigned int WIDTH = 320;
+static const unsigned int HEIGHT = 200;
+
+static std::vector<uint8_t> source(WIDTH * HEIGHT);
+static std::vector<uint8_t> target(WIDTH * HEIGHT * Scaler::MAX_FACTOR * Scaler::MAX_FACTOR * 4);
+static uint32_t colors[256];
+
+// The old SDL_Scale2x() inner loop for 1 byte per pixel
+struct LegacyScale2x {
+    void operator()()
+    {
+        const unsigned int pitch = WIDTH * 2;
+
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                const uint8_t *from = &source[0] + y * WIDTH + x;
+                uint8_t *to = &target[0] + 2 * y * pitch + 2 * x;
+
+                *to = *from;
+                *(to + 1) = *from;
+                *(to + pitch) = *from;
+                *(to + pitch + 1) = *from;
+            }
+        }
+    }
+};
+
+struct ScaleFrame {
+    ScaleFrame(const Scaler &s) : scaler(s) {}
+
+    void operator()()
+    {
+        scaler.scale(&source[0], WIDTH, &target[0], WIDTH * scaler.factor(),
+                     0, 0, WIDTH, HEIGHT);
+    }
+
+    const Scaler &scaler;
+};
+
+// Palette lookup straight into a 32bpp display, as av_sync() does
+struct ConvertFrame {
+    ConvertFrame(const Scaler &s) : scaler(s) {}
+
+    void operator()()
+    {
+        scaler.scaleConvert(&source[0], WIDTH, &target[0], WIDTH * scaler.factor() * 4, 4,
+                            colors, 0, 0, WIDTH, HEIGHT);
+    }
+
+    const Scaler &scaler;
+};
+
+static void report(const char *name, unsigned int factor, const bench::Timing &t)
+{
+    double pixels = (double) WIDTH * HEIGHT * factor * factor;
+
+    printf("%-12s %ux  %10.1f Mpixel/s  %8.1f us/frame\n",
+           name, factor, pixels * t.perSecond() / 1e6, t.seconds * 1e6 / t.iterations);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+
+    for (unsigned int i = 0; i < source.size(); i++) {
+        source[i] = rand() & 0xff;
+    }
+
+    for (unsigned int i = 0; i < 256; i++) {
+        colors[i] = (i << 16) | (i << 8) | i;
+    }
+
+    LegacyScale2x legacy;
+    report("legacy", 2, bench::run(legacy, seconds));
+
+    for (unsigned int factor = Scaler::MIN_FACTOR; factor <= Scaler::MAX_FACTOR; factor++) {
+        for (int k = Scaler::Scalar; k <= Scaler::AVX2; k++) {
+            Scaler::Kernel kernel = (Scaler::Kernel) k;
+
+            if (!Scaler::supported(kernel)) {
+                continue;
+            }
+
+            Scaler scaler(factor, kernel);
+            ScaleFrame frame(scaler);
+            report(Scaler::kernelName(kernel), factor, bench::run(frame, seconds));
+        }
+    }
+
+    for (unsigned int factor = Scaler::MIN_FACTOR; factor <= Scaler::MAX_FACTOR; factor++) {
+        for (int k = Scaler::Scalar; k <= Scaler::AVX2; k++) {
+            Scaler::Kernel kernel = (Scaler::Kernel) k;
+            char name[16];
+
+            if (!Scaler::supported(kernel)) {
+                continue;
+            }
+
+            Scaler scaler(factor, kernel);
+            ConvertFrame frame(scaler);
+            snprintf(name, sizeof(name), "lut32/%s", Scaler::kernelName(kernel));
+            report(name, factor, bench::run(frame, seconds));
+        }
+    }
+
+    return 0;
+}
@@ -19,7 +19,7 @@ Graphics graphics;
 
 Graphics::Graphics():
     _screen(NULL),
-    _scaledScreen(NULL),
+    _scaler(NULL),
     _display(NULL),
     _video(NULL),
     _news(NULL)
@@ -36,8 +36,11 @@ LegacySurface *Graphics::legacyScreen()
     return _screen;
 }
 
-void Graphics::create(const std::string &title, bool fullscreen)
+void Graphics::create(const std::string &title, bool fullscreen, unsigned int scale)
 {
+    if (scale < Scaler::MIN_FACTOR || scale > Scaler::MAX_FACTOR) {
+        throw std::invalid_argument("unsupported display scale");
+    }
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0) {
         throw std::runtime_error(SDL_GetError());
@@ -52,19 +55,15 @@ void Graphics::create(const std::string &title, bool fullscreen)
 
 
 
-    _display = SDL_SetVideoMode(WIDTH * SCALE, HEIGHT * SCALE, 24, 0);
+    // 32bpp so the legacy screen can be converted with whole-word stores
+    _display = SDL_SetVideoMode(WIDTH * scale, HEIGHT * scale, 32, 0);
 
     if (!_display) {
         throw std::runtime_error(SDL_GetError());
     }
 
     _screen = new LegacySurface(WIDTH, HEIGHT);
-
-    _scaledScreen = SDL_CreateRGBSurface(SDL_SWSURFACE, WIDTH * SCALE, HEIGHT * SCALE, 8, 0, 0, 0, 0);
-
-    if (!_scaledScreen) {
-        throw std::runtime_error(SDL_GetError());
-    }
+    _scaler = new Scaler(scale);
 
     _video = SDL_CreateYUVOverlay(VIDEO_WIDTH, VIDEO_HEIGHT, SDL_YV12_OVERLAY, _display);
 
@@ -87,18 +86,18 @@ void Graphics::destroy()
     SDL_FreeYUVOverlay(_video);
     SDL_FreeYUVOverlay(_news);
 
-    SDL_FreeSurface(_scaledScreen);
-
     if (_screen) {
         delete _screen;
         _screen = NULL;
     }
 
+    delete _scaler;
+    _scaler = NULL;
+
     SDL_FreeSurface(_display);
 
     _video = NULL;
     _news = NULL;
-    _scaledScreen = NULL;
     _screen = NULL;
     _display = NULL;
 }
@@ -113,28 +112,4 @@ void Graphics::setBackgroundColor(char color)
     _backgroundColor = color;
 }
 
-/*
-void Display::present() {
-    doScale();
-    SDL_BlitSurface( _scaledScreen, NULL, _display, NULL );
-    SDL_UpdateRect( _display, 0, 0, 0, 0 );
-}
-
-void Display::doScale() {
-
-    for (int x = 0; x < WIDTH; x++ ) {
-        for (int y = 0; y < HEIGHT; y++) {
-
-            uint8_t * from = (uint8_t *)_screen->pixels + ((y * WIDTH) + x);
-            uint8_t * to = (uint8_t *)_scaledScreen->pixels + ((y * 2) * (WIDTH * 2) + (x * 2));
-
-            *to = *from;
-            *(to + 1) = *from;
-            *(to + (WIDTH * 2)) = *from;
-            *(to + (WIDTH * 2)+1) = *from;
-        }
-    }
-}
-*/
-
 };
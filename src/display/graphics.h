@@ -8,6 +8,7 @@
 #include "deprecated.h"
 #include "palette.h"
 #include "legacy_surface.h"
+#include "scaler.h"
 
 namespace display
 {
@@ -22,18 +23,25 @@ public:
 
     static const int WIDTH = 320;
     static const int HEIGHT = 200;
-    static const int SCALE = 2;
+    static const int DEFAULT_SCALE = 2;
     static const int VIDEO_WIDTH = 160;
     static const int VIDEO_HEIGHT = 100;
     static const int NEWS_WIDTH = 312;
     static const int NEWS_HEIGHT = 106;
 
-    void create(const std::string &title, bool fullscreen);
+    void create(const std::string &title, bool fullscreen, unsigned int scale = DEFAULT_SCALE);
     void destroy();
 
-    SDL_Surface *scaledScreenSurface() const
+    // Integer factor between the legacy screen and the display
+    unsigned int scale() const
     {
-        return _scaledScreen;
+        return _scaler ? _scaler->factor() : DEFAULT_SCALE;
+    }
+
+    // Scales the legacy screen into displaySurface()
+    const Scaler &scaler() const
+    {
+        return *_scaler;
     }
 
     SDL_Surface *displaySurface() const
@@ -83,7 +91,7 @@ public:
 
 private:
     LegacySurface *_screen;
-    SDL_Surface *_scaledScreen;
+    Scaler *_scaler;
     SDL_Surface *_display;
     SDL_Overlay *_video;
     SDL_Overlay *_news;
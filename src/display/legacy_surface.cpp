@@ -1,4 +1,5 @@
 #include "legacy_surface.h"
+#include "pixel_kernels.h"
 
 #include <assert.h>
 
@@ -8,6 +9,22 @@
 namespace display
 {
 
+// The pixel kernels take the same test modes, in the same order
+BOOST_STATIC_ASSERT((int)LegacySurface::SourceEqual == (int)PixelKernels::SourceEqual);
+BOOST_STATIC_ASSERT((int)LegacySurface::DestinationEqual == (int)PixelKernels::DestinationEqual);
+BOOST_STATIC_ASSERT((int)LegacySurface::SourceNotEqual == (int)PixelKernels::SourceNotEqual);
+BOOST_STATIC_ASSERT((int)LegacySurface::DestinationNotEqual == (int)PixelKernels::DestinationNotEqual);
+BOOST_STATIC_ASSERT((int)LegacySurface::Equal == (int)PixelKernels::Equal);
+BOOST_STATIC_ASSERT((int)LegacySurface::NotEqual == (int)PixelKernels::NotEqual);
+BOOST_STATIC_ASSERT((int)LegacySurface::Any == (int)PixelKernels::Any);
+
+// Kernels for the running CPU, chosen on first use
+static const PixelKernels &kernels()
+{
+    static const PixelKernels best;
+    return best;
+}
+
 LegacySurface::LegacySurface(unsigned int width, unsigned int height) :
     Surface(NULL),   // see note below
     _hasValidPalette(false)
@@ -30,13 +47,12 @@ LegacySurface::~LegacySurface()
 
 void LegacySurface::clear(char colour)
 {
-    _dirty = true;
+    markDirty();
     SDL_FillRect(_screen, NULL, colour);
 }
 
 void LegacySurface::fillRect(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, char color)
 {
-    _dirty = true;
     SDL_Rect r;
     unsigned int left = std::min(x1, x2);
     unsigned int right = std::max(x1, x2);
@@ -54,19 +70,18 @@ void LegacySurface::fillRect(unsigned int x1, unsigned int y1, unsigned int x2,
 
 void LegacySurface::fillRect(const SDL_Rect &area, char color)
 {
-    _dirty = true;
+    markDirty(area.x, area.y, area.w, area.h);
     SDL_FillRect(_screen, const_cast<SDL_Rect *>(&area), color);
 }
 
 void LegacySurface::setPixel(unsigned int x, unsigned int y, char color)
 {
-    _dirty = true;
+    markDirty(x, y, 1, 1);
     *((char *)(_screen->pixels) + (y * _screen->pitch) + x) = color;
 }
 
 char LegacySurface::getPixel(unsigned int x, unsigned int y)
 {
-    _dirty = true;
     assert(x >= 0 && x < width());
     assert(y >= 0 && y < height());
 
@@ -75,7 +90,6 @@ char LegacySurface::getPixel(unsigned int x, unsigned int y)
 
 void LegacySurface::outlineRect(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, char color)
 {
-    _dirty = true;
     line(x1, y1, x2, y1, color);
     line(x2, y1, x2, y2, color);
     line(x2, y2, x1, y2, color);
@@ -84,13 +98,16 @@ void LegacySurface::outlineRect(unsigned int x1, unsigned int y1, unsigned int x
 
 void LegacySurface::line(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, char color)
 {
-    _dirty = true;
     int deltax, deltay;
     int error;
     int ystep;
     int x, y;
     int steep;
 
+    // mark the bounding box once instead of once per pixel
+    markDirty(std::min(x1, x2), std::min(y1, y2),
+              std::abs((int)(x2 - x1)) + 1, std::abs((int)(y2 - y1)) + 1);
+
     steep = std::abs((int)(y2 - y1)) > std::abs((int)(x2 - x1));
 
     if (steep) {
@@ -115,11 +132,13 @@ void LegacySurface::line(unsigned int x1, unsigned int y1, unsigned int x2, unsi
         ystep = -1;
     }
 
+    char *pixels = (char *)_screen->pixels;
+
     for (x = (int)x1; x <= (int)x2; x++) {
         if (steep) {
-            setPixel(y, x, color);
+            pixels[x * _screen->pitch + y] = color;
         } else {
-            setPixel(x, y, color);
+            pixels[y * _screen->pitch + x] = color;
         }
 
         error = error + deltay;
@@ -134,17 +153,19 @@ void LegacySurface::line(unsigned int x1, unsigned int y1, unsigned int x2, unsi
 void LegacySurface::checkPaletteCompatibility(const LegacySurface *other)
 {
     if (hasValidPalette() && other->hasValidPalette()) {
-        const PaletteInterface *otherPalette = other->_palette;
-
-        for (int i = 0; i < 256; i++) {
-            const Color myColor(_palette->get(i));
-            const Color otherColor(otherPalette->get(i));
-
-            // if this assertion blows up, you're probably doing a drawing operation
-            // without having copied around a palette first
-            assert(myColor.rgba() == otherColor.rgba());
+#ifndef NDEBUG
+#ifdef DISPLAY_VALIDATE_PALETTES
+        validatePalette(other);
+#else
+
+        // Equal palettes have equal hashes; only look closer if they don't
+        if (_palette->hash() != other->_palette->hash()) {
+            validatePalette(other);
         }
 
+#endif
+#endif
+
     } else if (!hasValidPalette() && other->hasValidPalette()) {
         palette().copy_from(*other->_palette);
 
@@ -169,12 +190,24 @@ void LegacySurface::checkPaletteCompatibility(LegacySurface *other)
     }
 }
 
+void LegacySurface::validatePalette(const LegacySurface *other) const
+{
+    const PaletteInterface *otherPalette = other->_palette;
+
+    for (int i = 0; i < 256; i++) {
+        const Color myColor(_palette->get(i));
+        const Color otherColor(otherPalette->get(i));
+
+        // if this assertion blows up, you're probably doing a drawing operation
+        // without having copied around a palette first
+        assert(myColor.rgba() == otherColor.rgba());
+    }
+}
+
 void LegacySurface::copyFrom(const LegacySurface *surface, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
     checkPaletteCompatibility(surface);
 
-    _dirty = true;
-
     SDL_Rect src;
     SDL_Rect dst;
 
@@ -183,6 +216,8 @@ void LegacySurface::copyFrom(const LegacySurface *surface, unsigned int x1, unsi
     src.w = (x2 - x1) + 1;
     src.h = (y2 - y1) + 1;
 
+    markDirty(0, 0, src.w, src.h);
+
     dst.x = 0;
     dst.y = 0;
     dst.w = src.w;
@@ -195,9 +230,7 @@ void LegacySurface::copyTo(LegacySurface *surface, unsigned int x, unsigned int
 {
     checkPaletteCompatibility(surface);
 
-    surface->_dirty = true;
-
-    int row, col, from_idx, to_idx;
+    int row, from_idx, to_idx;
     int clip_x, clip_y;
 
     assert(surface);
@@ -208,6 +241,8 @@ void LegacySurface::copyTo(LegacySurface *surface, unsigned int x, unsigned int
     clip_y = std::min(height() + y, surface->height()) - y;
     clip_x = std::min(width() + x, surface->width()) - x;
 
+    surface->markDirty(x, y, clip_x, clip_y);
+
     switch (operation) {
     case Set:
         for (row = 0; row < clip_y; row++) {
@@ -226,11 +261,9 @@ void LegacySurface::copyTo(LegacySurface *surface, unsigned int x, unsigned int
             from_idx = row * width();
             to_idx = (y + row) * surface->width() + x;
 
-            for (col = 0; col < clip_x; col++) {
-                char *dst = (char *)surface->_screen->pixels + (to_idx + col);
-                char *src = ((char *)_screen->pixels) + (from_idx + col);
-                *dst ^= *src;
-            }
+            uint8_t *dst = (uint8_t *)surface->_screen->pixels + to_idx;
+            const uint8_t *src = (const uint8_t *)_screen->pixels + from_idx;
+            kernels().xorCopy(dst, src, clip_x);
         }
 
         break;
@@ -261,6 +294,8 @@ void LegacySurface::copyTo(LegacySurface *surface, unsigned int srcX, unsigned i
     clip_y = std::min(copy_height + destY1, surface->height()) - destY1;
     clip_x = std::min(copy_width  + destX1, surface->width()) - destX1;
 
+    surface->markDirty(destX1, destY1, clip_x, clip_y);
+
     for (row = 0; row < clip_y; row++) {
         from_idx = (srcY + row) * width() + srcX;
         to_idx = (destY1 + row) * surface->width() + destX1;
@@ -275,6 +310,10 @@ void LegacySurface::scaleTo(const LegacySurface *surface)
 {
     checkPaletteCompatibility(surface);
 
+    // scaleTo() has always written through a const pointer; keep its
+    // signature and just record the damage
+    const_cast<LegacySurface *>(surface)->markDirty();
+
     int dest_row, dest_col, dest_idx;
     int src_row, src_col, src_idx;
 
@@ -317,6 +356,8 @@ void LegacySurface::copyFrom(const LegacySurface *surface, unsigned int srcX1, u
     assert(copy_width  <= (int)width());
     assert(copy_height <= (int)height());
 
+    markDirty(dstX, dstY, copy_width, copy_height);
+
     for (row = 0; row < copy_height; row++) {
         from_idx = (srcY1 + row) * surface->width() + srcX1;
         to_idx = (dstY + row) * width() + dstX;
@@ -334,71 +375,19 @@ void LegacySurface::maskCopy(const LegacySurface *source, char maskValue, MaskSo
     assert(source->width() == width());
     assert(source->height() == height());
 
-    unsigned int size = (width() * height());
-
-    for (unsigned int i = 0; i < size; i++) {
-        const char *src = (const char *)source->_screen->pixels + i;
-        char *dst = (char *)_screen->pixels + i;
-
-        switch (maskSource) {
-        case SourceEqual:
-            if (*src == maskValue) {
-                *dst = (*src) + offset;
-            }
-
-            break;
-
-        case SourceNotEqual:
-            if (*src != maskValue) {
-                *dst = (*src) + offset;
-            }
-
-            break;
-
-        case DestinationEqual:
-            if (*dst == maskValue) {
-                *dst = (*src) + offset;
-            }
-
-            break;
-
-        case DestinationNotEqual:
-            if (*dst != maskValue) {
-                *dst = (*src) + offset;
-            }
+    markDirty();
 
-            break;
-        }
-    }
+    kernels().maskCopy((uint8_t *)_screen->pixels, (const uint8_t *)source->_screen->pixels,
+                       width() * height(), maskValue,
+                       static_cast<PixelKernels::MaskTest>(maskSource), offset);
 }
 
 void LegacySurface::filter(char testValue, char offset, FilterTest filterTest)
 {
-    unsigned int size = (width() * height());
-
-    for (unsigned int i = 0; i < size; i++) {
-        char *src = (char *)_screen->pixels + i;
-
-        switch (filterTest) {
-        case Equal:
-            if (*src == testValue) {
-                *src += offset;
-            }
-
-            break;
+    markDirty();
 
-        case NotEqual:
-            if (*src != testValue) {
-                *src += offset;
-            }
-
-            break;
-
-        case Any:
-            *src += offset;
-            break;
-        }
-    }
+    kernels().filter((uint8_t *)_screen->pixels, width() * height(), testValue, offset,
+                     static_cast<PixelKernels::FilterTest>(filterTest));
 }
 
 void LegacySurface::setTransparentColor(int color)
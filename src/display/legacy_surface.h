@@ -42,8 +42,11 @@ public:
         Any
     };
 
+    // Callers may write anywhere in the buffer, so the whole surface is
+    // considered dirty afterwards.
     inline char *pixels()
     {
+        markDirty();
         return _pixels;
     };
 
@@ -87,13 +90,18 @@ public:
     // Set a color as transparent, or -1 to disable transaprency
     void setTransparentColor(int color = -1);
 
+    // Assert that every color of both palettes is the same. Blits only do
+    // this when the palette hashes differ, or on every call when built with
+    // DISPLAY_VALIDATE_PALETTES; release builds skip the check entirely.
+    void validatePalette(const LegacySurface *other) const;
+
 private:
     char *_pixels;
     display::SDLPaletteWrapper *_palette;
     bool _hasValidPalette;
 
     // Whenever we're copying between two surfaces, we call this function to check their palettes.
-    // If both surfaces have valid palettes, it compares them for equality and raises an assertion
+    // If both surfaces have valid palettes, debug builds compare their hashes and raise an assertion
     // failure if they're different. If only one of the surfaces has a valid palette, it copies the
     // palette prior to performing a draw operation.
     void checkPaletteCompatibility(const LegacySurface *other);
@@ -12,19 +12,53 @@ PaletteInterface::~PaletteInterface()
 {
 }
 
+bool PaletteInterface::matches(const PaletteInterface &other) const
+{
+    for (int i = 0; i < 256; i++) {
+        if (get(i).rgba() != other.get(i).rgba()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The hash of a palette is the sum of its entries' hashes, so set() can
+// update it by swapping out a single term.
+uint64_t PaletteInterface::entryHash(uint8_t index, const Color &color)
+{
+    // splitmix64 finalizer over the position and color
+    uint64_t z = ((uint64_t)index << 32) | color.rgba();
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
 
 Palette::Palette()
 {
     memset(colors, 0, sizeof(colors));
+
+    for (int i = 0; i < 256; i++) {
+        _hash += entryHash(i, colors[i]);
+    }
 }
 
 Palette::Palette(const Palette &copy)
 {
     memcpy(colors, copy.colors, sizeof(colors));
+    _hash = copy._hash;
 }
 
 Palette::Palette(const PaletteInterface &copy)
 {
+    memset(colors, 0, sizeof(colors));
+
+    for (int i = 0; i < 256; i++) {
+        _hash += entryHash(i, colors[i]);
+    }
+
     for (int i = 0; i < 256; i++) {
         set(i, copy.get(i));
     }
@@ -36,7 +70,10 @@ Palette::~Palette()
 
 void Palette::set(uint8_t index, const Color &color)
 {
-    colors[index] = color;
+    if (colors[index].rgba() != color.rgba()) {
+        changed(index, colors[index], color);
+        colors[index] = color;
+    }
 }
 
 const Color Palette::get(uint8_t index) const
@@ -51,6 +88,10 @@ SDLPaletteWrapper::SDLPaletteWrapper(SDL_Surface *sdl_surface)
     assert(sdl_surface != NULL);
     assert(sdl_surface->format != NULL);
     assert(sdl_surface->format->palette != NULL);
+
+    for (int i = 0; i < _sdl_surface->format->palette->ncolors; i++) {
+        _hash += entryHash(i, get(i));
+    }
 }
 
 SDLPaletteWrapper::~SDLPaletteWrapper()
@@ -61,6 +102,15 @@ void SDLPaletteWrapper::set(uint8_t index, const Color &color)
 {
     assert(index < _sdl_surface->format->palette->ncolors);
 
+    const SDL_Color &current = _sdl_surface->format->palette->colors[index];
+
+    if (current.r == color.r && current.g == color.g && current.b == color.b) {
+        return;
+    }
+
+    // get() reports every color with the same alpha
+    changed(index, get(index), Color(color.r, color.g, color.b));
+
     SDL_Color sdl_color;
     sdl_color.r = color.r;
     sdl_color.g = color.g;
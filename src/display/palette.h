@@ -13,6 +13,8 @@ namespace display
 class PaletteInterface
 {
 public:
+    PaletteInterface()
+        : _version(0), _hash(0) {};
     virtual ~PaletteInterface();
 
     virtual void set(uint8_t index, const Color &color) = 0;
@@ -22,6 +24,11 @@ public:
     {
         assert(start <= end);
 
+        // Nothing would change
+        if (start == 0 && end == 255 && _hash == other._hash) {
+            return;
+        }
+
         for (int i = start; i <= end; i++) {
             const Color &color = other.get(i);
             set(i, color);
@@ -32,6 +39,38 @@ public:
     {
         return get(index);
     };
+
+    // Incremented every time set() actually changes a color, so consumers
+    // can cache anything derived from the palette.
+    inline unsigned int version() const
+    {
+        return _version;
+    };
+
+    // A hash of every color get() returns, kept up to date by set(), so
+    // two palettes can be compared without looking at all 256 colors.
+    // Equal palettes always have equal hashes.
+    inline uint64_t hash() const
+    {
+        return _hash;
+    };
+
+    // Compare every color; slow, but exact
+    bool matches(const PaletteInterface &other) const;
+
+protected:
+    // Hash contribution of one palette entry
+    static uint64_t entryHash(uint8_t index, const Color &color);
+
+    // Account for a color set() just changed
+    inline void changed(uint8_t index, const Color &from, const Color &to)
+    {
+        _hash += entryHash(index, to) - entryHash(index, from);
+        _version++;
+    };
+
+    unsigned int _version;
+    uint64_t _hash;
 };
 
 class Palette : public PaletteInterface
@@ -0,0 +1,292 @@
+#include "pixel_kernels.h"
+#include "simd.h"
+
+#include <assert.h>
+
+namespace display
+{
+
+//----------------------------------------------------------------------------
+// Portable kernels, also used for the tails of the SIMD kernels
+
+template <bool testSource, bool equal>
+static void mask_scalar(uint8_t *dst, const uint8_t *src, unsigned int count,
+                        uint8_t maskValue, uint8_t offset)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        const uint8_t test = testSource ? src[i] : dst[i];
+
+        if ((test == maskValue) == equal) {
+            dst[i] = src[i] + offset;
+        }
+    }
+}
+
+template <PixelKernels::FilterTest test>
+static void filter_scalar(uint8_t *pixels, unsigned int count,
+                          uint8_t testValue, uint8_t offset)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        if (test == PixelKernels::Any ||
+            (pixels[i] == testValue) == (test == PixelKernels::Equal)) {
+            pixels[i] += offset;
+        }
+    }
+}
+
+static void xor_scalar(uint8_t *dst, const uint8_t *src, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+#ifdef DISPLAY_SIMD_X86
+
+//----------------------------------------------------------------------------
+// SSE2: 16 pixels per iteration
+//
+// SSE2 has no byte blend, so pixels are selected with and/andnot/or.
+
+template <bool testSource, bool equal>
+DISPLAY_SIMD_TARGET("sse2")
+static void mask_sse2(uint8_t *dst, const uint8_t *src, unsigned int count,
+                      uint8_t maskValue, uint8_t offset)
+{
+    const __m128i value = _mm_set1_epi8((char) maskValue);
+    const __m128i add = _mm_set1_epi8((char) offset);
+    unsigned int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i m = _mm_cmpeq_epi8(testSource ? s : d, value);
+        __m128i n = _mm_add_epi8(s, add);
+
+        if (equal) {
+            d = _mm_or_si128(_mm_and_si128(m, n), _mm_andnot_si128(m, d));
+        } else {
+            d = _mm_or_si128(_mm_andnot_si128(m, n), _mm_and_si128(m, d));
+        }
+
+        _mm_storeu_si128((__m128i *)(dst + i), d);
+    }
+
+    mask_scalar<testSource, equal>(dst + i, src + i, count - i, maskValue, offset);
+}
+
+template <PixelKernels::FilterTest test>
+DISPLAY_SIMD_TARGET("sse2")
+static void filter_sse2(uint8_t *pixels, unsigned int count,
+                        uint8_t testValue, uint8_t offset)
+{
+    const __m128i value = _mm_set1_epi8((char) testValue);
+    const __m128i add = _mm_set1_epi8((char) offset);
+    unsigned int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + i));
+        __m128i m = _mm_cmpeq_epi8(p, value);
+
+        if (test == PixelKernels::Equal) {
+            p = _mm_add_epi8(p, _mm_and_si128(m, add));
+        } else if (test == PixelKernels::NotEqual) {
+            p = _mm_add_epi8(p, _mm_andnot_si128(m, add));
+        } else {
+            p = _mm_add_epi8(p, add);
+        }
+
+        _mm_storeu_si128((__m128i *)(pixels + i), p);
+    }
+
+    filter_scalar<test>(pixels + i, count - i, testValue, offset);
+}
+
+DISPLAY_SIMD_TARGET("sse2")
+static void xor_sse2(uint8_t *dst, const uint8_t *src, unsigned int count)
+{
+    unsigned int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(d, s));
+    }
+
+    xor_scalar(dst + i, src + i, count - i);
+}
+
+//----------------------------------------------------------------------------
+// AVX2: 32 pixels per iteration
+
+template <bool testSource, bool equal>
+DISPLAY_SIMD_TARGET("avx2")
+static void mask_avx2(uint8_t *dst, const uint8_t *src, unsigned int count,
+                      uint8_t maskValue, uint8_t offset)
+{
+    const __m256i value = _mm256_set1_epi8((char) maskValue);
+    const __m256i add = _mm256_set1_epi8((char) offset);
+    unsigned int i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i m = _mm256_cmpeq_epi8(testSource ? s : d, value);
+        __m256i n = _mm256_add_epi8(s, add);
+
+        if (equal) {
+            d = _mm256_blendv_epi8(d, n, m);
+        } else {
+            d = _mm256_blendv_epi8(n, d, m);
+        }
+
+        _mm256_storeu_si256((__m256i *)(dst + i), d);
+    }
+
+    mask_sse2<testSource, equal>(dst + i, src + i, count - i, maskValue, offset);
+}
+
+template <PixelKernels::FilterTest test>
+DISPLAY_SIMD_TARGET("avx2")
+static void filter_avx2(uint8_t *pixels, unsigned int count,
+                        uint8_t testValue, uint8_t offset)
+{
+    const __m256i value = _mm256_set1_epi8((char) testValue);
+    const __m256i add = _mm256_set1_epi8((char) offset);
+    unsigned int i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + i));
+        __m256i m = _mm256_cmpeq_epi8(p, value);
+
+        if (test == PixelKernels::Equal) {
+            p = _mm256_add_epi8(p, _mm256_and_si256(m, add));
+        } else if (test == PixelKernels::NotEqual) {
+            p = _mm256_add_epi8(p, _mm256_andnot_si256(m, add));
+        } else {
+            p = _mm256_add_epi8(p, add);
+        }
+
+        _mm256_storeu_si256((__m256i *)(pixels + i), p);
+    }
+
+    filter_sse2<test>(pixels + i, count - i, testValue, offset);
+}
+
+DISPLAY_SIMD_TARGET("avx2")
+static void xor_avx2(uint8_t *dst, const uint8_t *src, unsigned int count)
+{
+    unsigned int i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(d, s));
+    }
+
+    xor_sse2(dst + i, src + i, count - i);
+}
+
+#endif // DISPLAY_SIMD_X86
+
+//----------------------------------------------------------------------------
+
+// Fill in the kernel tables for one instruction set, in enum order
+#define PIXEL_KERNELS(isa) \
+    _mask[SourceEqual] = mask_##isa<true, true>; \
+    _mask[DestinationEqual] = mask_##isa<false, true>; \
+    _mask[SourceNotEqual] = mask_##isa<true, false>; \
+    _mask[DestinationNotEqual] = mask_##isa<false, false>; \
+    _filter[Equal] = filter_##isa<Equal>; \
+    _filter[NotEqual] = filter_##isa<NotEqual>; \
+    _filter[Any] = filter_##isa<Any>; \
+    _xor = xor_##isa
+
+PixelKernels::PixelKernels()
+{
+    choose(bestKernel());
+}
+
+PixelKernels::PixelKernels(Kernel kernel)
+{
+    assert(supported(kernel));
+    choose(kernel);
+}
+
+void PixelKernels::choose(Kernel kernel)
+{
+    _kernel = kernel;
+    PIXEL_KERNELS(scalar);
+
+#ifdef DISPLAY_SIMD_X86
+
+    if (kernel == AVX2) {
+        PIXEL_KERNELS(avx2);
+    } else if (kernel == SSE2) {
+        PIXEL_KERNELS(sse2);
+    }
+
+#endif
+}
+
+#undef PIXEL_KERNELS
+
+void PixelKernels::maskCopy(uint8_t *dst, const uint8_t *src, unsigned int count,
+                            uint8_t maskValue, MaskTest test, uint8_t offset) const
+{
+    _mask[test](dst, src, count, maskValue, offset);
+}
+
+void PixelKernels::filter(uint8_t *pixels, unsigned int count,
+                          uint8_t testValue, uint8_t offset, FilterTest test) const
+{
+    _filter[test](pixels, count, testValue, offset);
+}
+
+void PixelKernels::xorCopy(uint8_t *dst, const uint8_t *src, unsigned int count) const
+{
+    _xor(dst, src, count);
+}
+
+PixelKernels::Kernel PixelKernels::bestKernel()
+{
+    if (supported(AVX2)) {
+        return AVX2;
+    }
+
+    if (supported(SSE2)) {
+        return SSE2;
+    }
+
+    return Scalar;
+}
+
+bool PixelKernels::supported(Kernel kernel)
+{
+    switch (kernel) {
+    case AVX2:
+        return simd::hasAVX2();
+
+    case SSE2:
+        return simd::hasSSE2();
+
+    default:
+        return true;
+    }
+}
+
+const char *PixelKernels::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case AVX2:
+        return "avx2";
+
+    case SSE2:
+        return "sse2";
+
+    default:
+        return "scalar";
+    }
+}
+
+} // namespace display
@@ -0,0 +1,83 @@
+#ifndef DISPLAY__PIXEL_KERNELS_H
+#define DISPLAY__PIXEL_KERNELS_H
+
+#include <stdint.h>
+
+namespace display
+{
+
+// Whole-buffer operations on 8bpp (palettized) pixels, behind
+// LegacySurface::maskCopy(), filter() and copyTo(..., Xor).
+//
+// Each test mode has its own loop, so nothing is decided per pixel, and
+// the loops compare and blend 16 or 32 pixels at a time on CPUs that
+// support it.
+class PixelKernels
+{
+public:
+    enum Kernel {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Which pixels maskCopy() writes: those where the source or the
+    // destination is, or is not, equal to the mask value
+    enum MaskTest {
+        SourceEqual,
+        DestinationEqual,
+        SourceNotEqual,
+        DestinationNotEqual
+    };
+
+    // Which pixels filter() changes
+    enum FilterTest {
+        Equal,
+        NotEqual,
+        Any
+    };
+
+    // Use the fastest kernel this CPU supports
+    PixelKernels();
+
+    // Use a specific kernel, which must be supported()
+    explicit PixelKernels(Kernel kernel);
+
+    inline Kernel kernel() const
+    {
+        return _kernel;
+    }
+
+    // dst[i] = src[i] + offset, for each pixel passing the mask test
+    void maskCopy(uint8_t *dst, const uint8_t *src, unsigned int count,
+                  uint8_t maskValue, MaskTest test, uint8_t offset) const;
+
+    // pixels[i] += offset, for each pixel passing the filter test
+    void filter(uint8_t *pixels, unsigned int count,
+                uint8_t testValue, uint8_t offset, FilterTest test) const;
+
+    // dst[i] ^= src[i]
+    void xorCopy(uint8_t *dst, const uint8_t *src, unsigned int count) const;
+
+    static Kernel bestKernel();
+    static bool supported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+private:
+    typedef void (*MaskFunction)(uint8_t *dst, const uint8_t *src, unsigned int count,
+                                 uint8_t maskValue, uint8_t offset);
+    typedef void (*FilterFunction)(uint8_t *pixels, unsigned int count,
+                                   uint8_t testValue, uint8_t offset);
+    typedef void (*XorFunction)(uint8_t *dst, const uint8_t *src, unsigned int count);
+
+    void choose(Kernel kernel);
+
+    Kernel _kernel;
+    MaskFunction _mask[4];
+    FilterFunction _filter[3];
+    XorFunction _xor;
+};
+
+} // namespace display
+
+#endif // DISPLAY__PIXEL_KERNELS_H
@@ -0,0 +1,568 @@
+#include "scaler.h"
+#include "simd.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace display
+{
+
+//----------------------------------------------------------------------------
+// Portable row kernels, also used for the tails of the SIMD kernels
+
+static void row1_scalar(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    memcpy(dst, src, width);
+}
+
+static void row2_scalar(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    for (unsigned int i = 0; i < width; i++) {
+        dst[0] = dst[1] = src[i];
+        dst += 2;
+    }
+}
+
+static void row3_scalar(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    for (unsigned int i = 0; i < width; i++) {
+        dst[0] = dst[1] = dst[2] = src[i];
+        dst += 3;
+    }
+}
+
+static void row4_scalar(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    for (unsigned int i = 0; i < width; i++) {
+        dst[0] = dst[1] = dst[2] = dst[3] = src[i];
+        dst += 4;
+    }
+}
+
+#ifdef DISPLAY_SIMD_X86
+
+//----------------------------------------------------------------------------
+// SSE2: 16 source pixels per iteration
+
+DISPLAY_SIMD_TARGET("sse2")
+static void row2_sse2(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    unsigned int i = 0;
+
+    for (; i + 16 <= width; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(p, p));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 16), _mm_unpackhi_epi8(p, p));
+    }
+
+    row2_scalar(src + i, dst + 2 * i, width - i);
+}
+
+DISPLAY_SIMD_TARGET("sse2")
+static void row4_sse2(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    unsigned int i = 0;
+
+    for (; i + 16 <= width; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(p, p);
+        __m128i hi = _mm_unpackhi_epi8(p, p);
+        uint8_t *out = dst + 4 * i;
+        _mm_storeu_si128((__m128i *)(out), _mm_unpacklo_epi16(lo, lo));
+        _mm_storeu_si128((__m128i *)(out + 16), _mm_unpackhi_epi16(lo, lo));
+        _mm_storeu_si128((__m128i *)(out + 32), _mm_unpacklo_epi16(hi, hi));
+        _mm_storeu_si128((__m128i *)(out + 48), _mm_unpackhi_epi16(hi, hi));
+    }
+
+    row4_scalar(src + i, dst + 4 * i, width - i);
+}
+
+//----------------------------------------------------------------------------
+// AVX2: 32 source pixels per iteration
+//
+// The 256-bit unpacks work within 128-bit lanes, so the results are put
+// back in order with a cross-lane permute.
+
+DISPLAY_SIMD_TARGET("avx2")
+static void row2_avx2(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    unsigned int i = 0;
+
+    for (; i + 32 <= width; i += 32) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i lo = _mm256_unpacklo_epi8(p, p);
+        __m256i hi = _mm256_unpackhi_epi8(p, p);
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    row2_sse2(src + i, dst + 2 * i, width - i);
+}
+
+DISPLAY_SIMD_TARGET("avx2")
+static void row3_avx2(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    // Each 16-pixel block becomes 48 bytes, built with three byte shuffles
+    const __m128i m0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+    const __m128i m1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+    const __m128i m2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+    unsigned int i = 0;
+
+    for (; i + 16 <= width; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+        uint8_t *out = dst + 3 * i;
+        _mm_storeu_si128((__m128i *)(out), _mm_shuffle_epi8(p, m0));
+        _mm_storeu_si128((__m128i *)(out + 16), _mm_shuffle_epi8(p, m1));
+        _mm_storeu_si128((__m128i *)(out + 32), _mm_shuffle_epi8(p, m2));
+    }
+
+    row3_scalar(src + i, dst + 3 * i, width - i);
+}
+
+DISPLAY_SIMD_TARGET("avx2")
+static void row4_avx2(const uint8_t *src, uint8_t *dst, unsigned int width)
+{
+    unsigned int i = 0;
+
+    for (; i + 32 <= width; i += 32) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i lo = _mm256_unpacklo_epi8(p, p);
+        __m256i hi = _mm256_unpackhi_epi8(p, p);
+        // pixels 0-15 and 16-31, each doubled and in order
+        __m256i d[2];
+        d[0] = _mm256_permute2x128_si256(lo, hi, 0x20);
+        d[1] = _mm256_permute2x128_si256(lo, hi, 0x31);
+
+        for (int k = 0; k < 2; k++) {
+            __m256i lo2 = _mm256_unpacklo_epi16(d[k], d[k]);
+            __m256i hi2 = _mm256_unpackhi_epi16(d[k], d[k]);
+            uint8_t *out = dst + 4 * i + 64 * k;
+            _mm256_storeu_si256((__m256i *)(out), _mm256_permute2x128_si256(lo2, hi2, 0x20));
+            _mm256_storeu_si256((__m256i *)(out + 32), _mm256_permute2x128_si256(lo2, hi2, 0x31));
+        }
+    }
+
+    row4_sse2(src + i, dst + 4 * i, width - i);
+}
+
+#endif // DISPLAY_SIMD_X86
+
+//----------------------------------------------------------------------------
+// Palette lookup kernels for scaleConvert()
+//
+// The factor is a template parameter to unroll the stores. The scalar
+// kernels handle every format and the tails of the SIMD ones.
+
+template <unsigned int Factor>
+static void convertRow16(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    uint16_t *out = (uint16_t *)dst;
+
+    for (unsigned int i = 0; i < width; i++) {
+        const uint16_t c = (uint16_t)colors[src[i]];
+
+        for (unsigned int k = 0; k < Factor; k++) {
+            *out++ = c;
+        }
+    }
+}
+
+template <unsigned int Factor>
+static void convertRow24(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    // The three significant bytes of a pixel value sit at the start of the
+    // word on little endian machines and at its end on big endian ones.
+    const uint32_t probe = 1;
+    const unsigned int skip = (*(const uint8_t *)&probe == 1) ? 0 : 1;
+
+    for (unsigned int i = 0; i < width; i++) {
+        const uint8_t *c = (const uint8_t *)&colors[src[i]] + skip;
+
+        for (unsigned int k = 0; k < Factor; k++) {
+            dst[0] = c[0];
+            dst[1] = c[1];
+            dst[2] = c[2];
+            dst += 3;
+        }
+    }
+}
+
+template <unsigned int Factor>
+static void convertRow32(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    uint32_t *out = (uint32_t *)dst;
+
+    for (unsigned int i = 0; i < width; i++) {
+        const uint32_t c = colors[src[i]];
+
+        for (unsigned int k = 0; k < Factor; k++) {
+            *out++ = c;
+        }
+    }
+}
+
+#ifdef DISPLAY_SIMD_X86
+
+//----------------------------------------------------------------------------
+// SSE2 lookups: the table reads stay scalar, the enlarging is done in
+// registers and written out with whole-vector stores.
+
+template <unsigned int Factor>
+DISPLAY_SIMD_TARGET("sse2")
+static void convertRow32_sse2(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    unsigned int i = 0;
+
+    for (; i + 4 <= width; i += 4) {
+        const __m128i c = _mm_setr_epi32(colors[src[i]], colors[src[i + 1]],
+                                         colors[src[i + 2]], colors[src[i + 3]]);
+        __m128i *out = (__m128i *)(dst + 16 * Factor * i / 4);
+
+        switch (Factor) {
+        case 1:
+            _mm_storeu_si128(out, c);
+            break;
+
+        case 2:
+            _mm_storeu_si128(out, _mm_unpacklo_epi32(c, c));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(c, c));
+            break;
+
+        case 3:
+            _mm_storeu_si128(out, _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 0, 0)));
+            _mm_storeu_si128(out + 1, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 2, 1, 1)));
+            _mm_storeu_si128(out + 2, _mm_shuffle_epi32(c, _MM_SHUFFLE(3, 3, 3, 2)));
+            break;
+
+        default:
+            _mm_storeu_si128(out, _mm_shuffle_epi32(c, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_storeu_si128(out + 1, _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_storeu_si128(out + 2, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_storeu_si128(out + 3, _mm_shuffle_epi32(c, _MM_SHUFFLE(3, 3, 3, 3)));
+            break;
+        }
+    }
+
+    convertRow32<Factor>(src + i, dst + 4 * Factor * i, width - i, colors);
+}
+
+template <unsigned int Factor>
+DISPLAY_SIMD_TARGET("sse2")
+static void convertRow16_sse2(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    unsigned int i = 0;
+
+    // SSE2 has no byte shuffle to spread pixels three ways
+    if (Factor == 3) {
+        convertRow16<Factor>(src, dst, width, colors);
+        return;
+    }
+
+    for (; i + 8 <= width; i += 8) {
+        const __m128i c = _mm_setr_epi16(
+                              (int16_t)colors[src[i]], (int16_t)colors[src[i + 1]],
+                              (int16_t)colors[src[i + 2]], (int16_t)colors[src[i + 3]],
+                              (int16_t)colors[src[i + 4]], (int16_t)colors[src[i + 5]],
+                              (int16_t)colors[src[i + 6]], (int16_t)colors[src[i + 7]]);
+        __m128i *out = (__m128i *)(dst + 2 * Factor * i);
+
+        if (Factor == 1) {
+            _mm_storeu_si128(out, c);
+        } else {
+            const __m128i lo = _mm_unpacklo_epi16(c, c);
+            const __m128i hi = _mm_unpackhi_epi16(c, c);
+
+            if (Factor == 2) {
+                _mm_storeu_si128(out, lo);
+                _mm_storeu_si128(out + 1, hi);
+            } else {
+                _mm_storeu_si128(out, _mm_unpacklo_epi32(lo, lo));
+                _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(lo, lo));
+                _mm_storeu_si128(out + 2, _mm_unpacklo_epi32(hi, hi));
+                _mm_storeu_si128(out + 3, _mm_unpackhi_epi32(hi, hi));
+            }
+        }
+    }
+
+    convertRow16<Factor>(src + i, dst + 2 * Factor * i, width - i, colors);
+}
+
+//----------------------------------------------------------------------------
+// AVX2 lookups: eight table reads with one gather, then each output vector
+// is a permutation of the eight looked up pixels.
+
+template <unsigned int Factor>
+DISPLAY_SIMD_TARGET("avx2")
+static void convertRow32_avx2(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    int32_t order[Factor][8];
+    __m256i perm[Factor];
+    unsigned int i = 0;
+
+    // output pixel j of vector k repeats looked up pixel (8k + j) / Factor
+    for (unsigned int k = 0; k < Factor; k++) {
+        for (unsigned int j = 0; j < 8; j++) {
+            order[k][j] = (8 * k + j) / Factor;
+        }
+
+        perm[k] = _mm256_loadu_si256((const __m256i *)order[k]);
+    }
+
+    for (; i + 8 <= width; i += 8) {
+        const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i)));
+        const __m256i c = _mm256_i32gather_epi32((const int *)colors, index, 4);
+        __m256i *out = (__m256i *)(dst + 4 * Factor * i);
+
+        for (unsigned int k = 0; k < Factor; k++) {
+            _mm256_storeu_si256(out + k, (Factor == 1) ? c : _mm256_permutevar8x32_epi32(c, perm[k]));
+        }
+    }
+
+    convertRow32_sse2<Factor>(src + i, dst + 4 * Factor * i, width - i, colors);
+}
+
+template <unsigned int Factor>
+DISPLAY_SIMD_TARGET("avx2")
+static void convertRow16_avx2(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors)
+{
+    int8_t order[Factor][16];
+    __m128i shuffle[Factor];
+    unsigned int i = 0;
+
+    // byte b of vector k comes from looked up pixel (8k + b / 2) / Factor
+    for (unsigned int k = 0; k < Factor; k++) {
+        for (unsigned int b = 0; b < 16; b++) {
+            order[k][b] = (int8_t)(2 * ((8 * k + b / 2) / Factor) + (b & 1));
+        }
+
+        shuffle[k] = _mm_loadu_si128((const __m128i *)order[k]);
+    }
+
+    for (; i + 8 <= width; i += 8) {
+        const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i)));
+        const __m256i c = _mm256_i32gather_epi32((const int *)colors, index, 4);
+        // 16 bit pixel values fit the unsigned saturation unchanged
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(c, c), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i pixels = _mm256_castsi256_si128(packed);
+        __m128i *out = (__m128i *)(dst + 2 * Factor * i);
+
+        for (unsigned int k = 0; k < Factor; k++) {
+            _mm_storeu_si128(out + k, (Factor == 1) ? pixels : _mm_shuffle_epi8(pixels, shuffle[k]));
+        }
+    }
+
+    convertRow16<Factor>(src + i, dst + 2 * Factor * i, width - i, colors);
+}
+
+#endif // DISPLAY_SIMD_X86
+
+typedef void (*ConvertFunction)(const uint8_t *src, uint8_t *dst, unsigned int width, const uint32_t *colors);
+
+// 24bpp displays only have the scalar kernel: three byte pixels don't
+// line up with the vector lanes, and the game opens its display at 32bpp.
+template <unsigned int Factor>
+static ConvertFunction convertFunction(unsigned int bytesPerPixel, Scaler::Kernel kernel)
+{
+    switch (bytesPerPixel) {
+    case 2:
+#ifdef DISPLAY_SIMD_X86
+        if (kernel == Scaler::AVX2) {
+            return convertRow16_avx2<Factor>;
+        }
+
+        if (kernel == Scaler::SSE2) {
+            return convertRow16_sse2<Factor>;
+        }
+
+#endif
+        return convertRow16<Factor>;
+
+    case 3:
+        return convertRow24<Factor>;
+
+    default:
+#ifdef DISPLAY_SIMD_X86
+        if (kernel == Scaler::AVX2) {
+            return convertRow32_avx2<Factor>;
+        }
+
+        if (kernel == Scaler::SSE2) {
+            return convertRow32_sse2<Factor>;
+        }
+
+#endif
+        return convertRow32<Factor>;
+    }
+}
+
+//----------------------------------------------------------------------------
+
+Scaler::Scaler(unsigned int factor)
+    : _factor(factor),
+      _kernel(bestKernel()),
+      _row(rowFunction(factor, _kernel))
+{
+}
+
+Scaler::Scaler(unsigned int factor, Kernel kernel)
+    : _factor(factor),
+      _kernel(kernel),
+      _row(rowFunction(factor, kernel))
+{
+    assert(supported(kernel));
+}
+
+Scaler::RowFunction Scaler::rowFunction(unsigned int factor, Kernel kernel)
+{
+    assert(factor >= MIN_FACTOR && factor <= MAX_FACTOR);
+
+    switch (factor) {
+    case 1:
+        // memcpy() is already as good as it gets
+        return row1_scalar;
+
+    case 2:
+#ifdef DISPLAY_SIMD_X86
+        if (kernel == AVX2) {
+            return row2_avx2;
+        }
+
+        if (kernel == SSE2) {
+            return row2_sse2;
+        }
+
+#endif
+        return row2_scalar;
+
+    case 3:
+#ifdef DISPLAY_SIMD_X86
+        // SSE2 has no byte shuffle, so 3x only has an AVX2 kernel
+        if (kernel == AVX2) {
+            return row3_avx2;
+        }
+
+#endif
+        return row3_scalar;
+
+    default:
+#ifdef DISPLAY_SIMD_X86
+        if (kernel == AVX2) {
+            return row4_avx2;
+        }
+
+        if (kernel == SSE2) {
+            return row4_sse2;
+        }
+
+#endif
+        return row4_scalar;
+    }
+}
+
+void Scaler::scale(const uint8_t *src, unsigned int srcPitch,
+                   uint8_t *dst, unsigned int dstPitch,
+                   unsigned int x, unsigned int y, unsigned int w, unsigned int h) const
+{
+    const unsigned int rowBytes = w * _factor;
+
+    src += y * srcPitch + x;
+    dst += (y * _factor) * dstPitch + x * _factor;
+
+    for (unsigned int row = 0; row < h; row++) {
+        _row(src, dst, w);
+
+        for (unsigned int copy = 1; copy < _factor; copy++) {
+            memcpy(dst + copy * dstPitch, dst, rowBytes);
+        }
+
+        src += srcPitch;
+        dst += _factor * dstPitch;
+    }
+}
+
+void Scaler::scaleConvert(const uint8_t *src, unsigned int srcPitch,
+                          uint8_t *dst, unsigned int dstPitch, unsigned int bytesPerPixel,
+                          const uint32_t colors[256],
+                          unsigned int x, unsigned int y, unsigned int w, unsigned int h) const
+{
+    assert(bytesPerPixel >= 2 && bytesPerPixel <= 4);
+
+    ConvertFunction convert;
+
+    switch (_factor) {
+    case 1:
+        convert = convertFunction<1>(bytesPerPixel, _kernel);
+        break;
+
+    case 2:
+        convert = convertFunction<2>(bytesPerPixel, _kernel);
+        break;
+
+    case 3:
+        convert = convertFunction<3>(bytesPerPixel, _kernel);
+        break;
+
+    default:
+        convert = convertFunction<4>(bytesPerPixel, _kernel);
+        break;
+    }
+
+    const unsigned int rowBytes = w * _factor * bytesPerPixel;
+
+    src += y * srcPitch + x;
+    dst += (y * _factor) * dstPitch + x * _factor * bytesPerPixel;
+
+    for (unsigned int row = 0; row < h; row++) {
+        convert(src, dst, w, colors);
+
+        for (unsigned int copy = 1; copy < _factor; copy++) {
+            memcpy(dst + copy * dstPitch, dst, rowBytes);
+        }
+
+        src += srcPitch;
+        dst += _factor * dstPitch;
+    }
+}
+
+Scaler::Kernel Scaler::bestKernel()
+{
+    if (supported(AVX2)) {
+        return AVX2;
+    }
+
+    if (supported(SSE2)) {
+        return SSE2;
+    }
+
+    return Scalar;
+}
+
+bool Scaler::supported(Kernel kernel)
+{
+    switch (kernel) {
+    case AVX2:
+        return simd::hasAVX2();
+
+    case SSE2:
+        return simd::hasSSE2();
+
+    default:
+        return true;
+    }
+}
+
+const char *Scaler::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case AVX2:
+        return "avx2";
+
+    case SSE2:
+        return "sse2";
+
+    default:
+        return "scalar";
+    }
+}
+
+} // namespace display
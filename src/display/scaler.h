@@ -0,0 +1,79 @@
+#ifndef DISPLAY__SCALER_H
+#define DISPLAY__SCALER_H
+
+#include <stdint.h>
+
+namespace display
+{
+
+// Integer upscaler for 8bpp (palettized) pixel buffers.
+//
+// Each source pixel becomes a factor() x factor() block. Rows are expanded
+// horizontally by a kernel chosen for the running CPU, then replicated
+// vertically with memcpy().
+class Scaler
+{
+public:
+    enum Kernel {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    static const unsigned int MIN_FACTOR = 1;
+    static const unsigned int MAX_FACTOR = 4;
+
+    // Create a scaler using the fastest kernel this CPU supports
+    explicit Scaler(unsigned int factor);
+
+    // Create a scaler using a specific kernel, which must be supported()
+    Scaler(unsigned int factor, Kernel kernel);
+
+    inline unsigned int factor() const
+    {
+        return _factor;
+    }
+
+    inline Kernel kernel() const
+    {
+        return _kernel;
+    }
+
+    // Expand width pixels from src into width * factor() pixels at dst
+    inline void scaleRow(const uint8_t *src, uint8_t *dst, unsigned int width) const
+    {
+        _row(src, dst, width);
+    }
+
+    // Scale the w x h area at (x, y) of src into the matching area of dst.
+    // Pitches are in bytes; dst must be at least factor() times as large as src.
+    void scale(const uint8_t *src, unsigned int srcPitch,
+               uint8_t *dst, unsigned int dstPitch,
+               unsigned int x, unsigned int y, unsigned int w, unsigned int h) const;
+
+    // Like scale(), but the destination is a 16, 24 or 32 bit surface: each
+    // palette index is looked up in colors[] (pixel values already in the
+    // destination format) while it is being enlarged. 16 and 32 bit
+    // destinations use the SIMD kernel of this scaler.
+    void scaleConvert(const uint8_t *src, unsigned int srcPitch,
+                      uint8_t *dst, unsigned int dstPitch, unsigned int bytesPerPixel,
+                      const uint32_t colors[256],
+                      unsigned int x, unsigned int y, unsigned int w, unsigned int h) const;
+
+    static Kernel bestKernel();
+    static bool supported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+private:
+    typedef void (*RowFunction)(const uint8_t *src, uint8_t *dst, unsigned int width);
+
+    static RowFunction rowFunction(unsigned int factor, Kernel kernel);
+
+    unsigned int _factor;
+    Kernel _kernel;
+    RowFunction _row;
+};
+
+} // namespace display
+
+#endif // DISPLAY__SCALER_H
@@ -0,0 +1,66 @@
+#include "simd.h"
+
+#if defined(_MSC_VER) && defined(DISPLAY_SIMD_X86)
+#include <intrin.h>
+#endif
+
+namespace display
+{
+
+namespace simd
+{
+
+#if defined(DISPLAY_SIMD_X86) && defined(__GNUC__)
+
+bool hasSSE2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+bool hasAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#elif defined(DISPLAY_SIMD_X86) && defined(_MSC_VER)
+
+bool hasSSE2()
+{
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+}
+
+bool hasAVX2()
+{
+    int info[4];
+    __cpuid(info, 1);
+
+    // the OS must save the AVX registers for us (OSXSAVE + XCR0)
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+#else
+
+bool hasSSE2()
+{
+    return false;
+}
+
+bool hasAVX2()
+{
+    return false;
+}
+
+#endif
+
+} // namespace simd
+
+} // namespace display
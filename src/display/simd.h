@@ -0,0 +1,35 @@
+#ifndef DISPLAY__SIMD_H
+#define DISPLAY__SIMD_H
+
+// Helpers for the hand-vectorized pixel kernels.
+//
+// SIMD code is compiled per function (GCC/Clang target attributes) rather
+// than per file, so the game still runs on any x86 CPU: callers pick a
+// kernel at runtime based on what the CPU reports.
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define DISPLAY_SIMD_X86 1
+#define DISPLAY_SIMD_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define DISPLAY_SIMD_X86 1
+#define DISPLAY_SIMD_TARGET(isa)
+#endif
+
+#ifdef DISPLAY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace display
+{
+
+namespace simd
+{
+
+bool hasSSE2();
+bool hasAVX2();
+
+} // namespace simd
+
+} // namespace display
+
+#endif // DISPLAY__SIMD_H
@@ -12,6 +12,10 @@ Surface::Surface(SDL_Surface *surface) :
     _screen(surface),
     _dirty(false)
 {
+    _dirtyRect.x = 0;
+    _dirtyRect.y = 0;
+    _dirtyRect.w = 0;
+    _dirtyRect.h = 0;
 }
 
 Surface::~Surface()
@@ -30,8 +34,48 @@ uint32_t Surface::mapColor(const Color &color)
     return SDL_MapRGB(_screen->format, color.r, color.g, color.b);
 }
 
+void Surface::markDirty()
+{
+    markDirty(0, 0, width(), height());
+}
+
+void Surface::markDirty(int x, int y, int w, int h)
+{
+    int x2 = std::min(x + w, (int)width());
+    int y2 = std::min(y + h, (int)height());
+    x = std::max(x, 0);
+    y = std::max(y, 0);
+
+    if (x >= x2 || y >= y2) {
+        return;
+    }
+
+    if (_dirty) {
+        // grow the existing dirty area to cover the new one
+        x2 = std::max(x2, _dirtyRect.x + _dirtyRect.w);
+        y2 = std::max(y2, _dirtyRect.y + _dirtyRect.h);
+        x = std::min(x, (int)_dirtyRect.x);
+        y = std::min(y, (int)_dirtyRect.y);
+    }
+
+    _dirty = true;
+    _dirtyRect.x = x;
+    _dirtyRect.y = y;
+    _dirtyRect.w = x2 - x;
+    _dirtyRect.h = y2 - y;
+}
+
+void Surface::clearDirty()
+{
+    _dirty = false;
+    _dirtyRect.w = 0;
+    _dirtyRect.h = 0;
+}
+
 void Surface::clear(const Color &color)
 {
+    markDirty();
+
     SDL_Rect dst;
     dst.x = 0;
     dst.y = 0;
@@ -43,7 +87,7 @@ void Surface::clear(const Color &color)
 
 void Surface::draw(const Surface &surface, unsigned int srcX, unsigned int srcY, unsigned int srcW, unsigned int srcH, unsigned int x, unsigned int y)
 {
-    _dirty = true;
+    markDirty(x, y, srcW, srcH);
 
     SDL_Rect src;
     SDL_Rect dst;
@@ -36,6 +36,28 @@ public:
         clear(Color(0, 0, 0));
     };
 
+    // Has anything been drawn since the last clearDirty()?
+    inline bool isDirty() const
+    {
+        return _dirty;
+    }
+
+    // The union of every area modified since the last clearDirty().
+    // Only meaningful when isDirty() is true.
+    inline const SDL_Rect &dirtyRect() const
+    {
+        return _dirtyRect;
+    }
+
+    // Mark the entire surface as modified
+    void markDirty();
+
+    // Mark an area as modified; the area is clipped to the surface
+    void markDirty(int x, int y, int w, int h);
+
+    // Forget about all modifications, typically after presenting the surface
+    void clearDirty();
+
     void draw(const Surface &surface, unsigned int x, unsigned int y)
     {
         draw(surface, 0, 0, surface.width(), surface.height(), x, y);
@@ -74,6 +96,7 @@ protected:
 
     SDL_Surface *_screen;
     bool _dirty;
+    SDL_Rect _dirtyRect;
 };
 
 } // namespace display
@@ -53,11 +53,17 @@
 #include "sdlhelper.h"
 #include "gr.h"
 #include "pace.h"
+#include "rng.h"
 #include "endianness.h"
 #include "filesystem.h"
+#include "save_catalog.h"
+#include "vab.h"
 
 #include <ctype.h>
 
+#include <algorithm>
+#include <vector>
+
 #define MODEM_ERROR 4
 #define NOTSAME 2
 #define SAME_ABORT 0
@@ -65,12 +71,21 @@
 
 LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
 
-SaveFileHdr *SaveHdr;
-SFInfo *FList;
+GAME_LOCAL SaveFileHdr *SaveHdr;
+GAME_LOCAL SFInfo *FList;
+GAME_LOCAL_RESET(SaveHdr);
+GAME_LOCAL_RESET(FList);
+
+/* The random stream as it was at the end-of-turn save comes last in a
+ * save file, after a tag, so saves made before it was added still load. */
+static const char save_rng_tag[8] = {'R', 'I', 'S', 'R', 'N', 'G', '0', '1'};
+#define SAVE_RNG_SIZE (sizeof(interimData.endTurnRng) + sizeof(save_rng_tag))
 
 int GenerateTables(SaveGameType saveType);
+static void write_save_rng(FILE *fout);
+static size_t read_save_rng(FILE *fin, size_t fileLength);
 char GetBlockName(char *Nam);
-void DrawFiles(char now, char loc, char tFiles);
+void DrawFiles(int now, int loc, int tFiles);
 void BadFileType();
 void FileText(char *name);
 int FutureCheck(char plr, char type);
@@ -220,98 +235,62 @@ void Admin(char plr)
 }
 
 
-/* Creates a list of all the save files of the selected type, up to 100.
+/* Orders savegame files by title, ignoring case.
+ */
+static bool TitleLess(const SFInfo &a, const SFInfo &b)
+{
+    return xstrcasecmp(a.Title, b.Title) < 0;
+}
+
+
+/* Creates a list of all the save files of the selected type.
  *
- * The results are stored in the global "buffer" variable. They are
- * stored as a list of SFInfo structs, accessible via the global FList
- * ptr, and a list of SaveFileHdr structs, accessible via the global
- * SaveHdr ptr. FList entries are ordered by save title.
+ * The list is built from the save catalog (see ReadSaveCatalog()), so
+ * only saves that changed since it was last shown are opened. It is
+ * accessible via the global FList ptr, ordered by save title. The
+ * global SaveHdr ptr is pointed at a scratch SaveFileHdr struct kept in
+ * the global "buffer" variable.
  *
  * TODO: Storing the results of the search as a byte dump in a globally
  * accessible buffer is incredibly legacy and needs to be changed to
  * something safer.
  *
  * \param saveType  Include Normal, Modem, or Play by Email.
- * \return  The number of savegame files found (up to 100).
+ * \return  The number of savegame files found.
  */
 int GenerateTables(SaveGameType saveType)
 {
-    struct ffblk ffblk;
-    int i, j, tFiles, done;
-    FILE *fin;
-    tFiles = 0;
-
-    done = first_saved_game(&ffblk);
-
-    while (!done && tFiles < 100) {
-        tFiles++;    // Count Total Files
-        done = next_saved_game(&ffblk);
-    }
+    static std::vector<SFInfo> files;
+    std::vector<SaveCatalogEntry> saves = ReadSaveCatalog();
 
     memset(buffer, 0x00, 20480);
-
-    /** \note old code lacked parans, so pointed FList off into space - pace */
-    FList = (SFInfo *)(buffer + 5000);
     SaveHdr = (SaveFileHdr *) buffer;
 
-    if (tFiles > 0) {
-        tFiles = 0;
-        done = first_saved_game(&ffblk);
-
-        while (!done && tFiles < 100) { // Get All File Names And Save Dates.
-            if (strlen(ffblk.ff_name) > sizeof FList[tFiles].Name - 1) {
-                goto next;
-            }
+    files.clear();
 
-            memset(&FList[tFiles], 0, sizeof FList[tFiles]);
-            strcpy(FList[tFiles].Name, ffblk.ff_name);
-            FList[tFiles].time = ffblk.ff_ftime;
-            FList[tFiles].date = ffblk.ff_fdate;
-            fin = sOpen(ffblk.ff_name, "rb", 1);
+    for (size_t i = 0; i < saves.size(); i++) {
+        SFInfo info;
 
-            if (fin == NULL) {
-                goto next;
-            }
-
-            fread(SaveHdr, 1, sizeof(SaveFileHdr), fin);
-            fclose(fin);
-
-            if (saveType == SAVEGAME_Normal) {
-                strcpy(FList[tFiles].Title, SaveHdr->Name);
-                tFiles++;
-            } else if (saveType == SAVEGAME_PlayByMail) {
-                if (SaveHdr->Country[0] == 8 || SaveHdr->Country[1] == 9) {
-                    strcpy(FList[tFiles].Title, SaveHdr->Name);
-                    tFiles++;
-                }
-            } else if (saveType == SAVEGAME_Modem) {
-                if (SaveHdr->Country[0] == 6 || SaveHdr->Country[1] == 7) {
-                    strcpy(FList[tFiles].Title, SaveHdr->Name);
-                    tFiles++;
-                }
-            }
-
-next:
-            done = next_saved_game(&ffblk);
+        if (saves[i].name.size() > sizeof info.Name - 1) {
+            continue;
         }
 
-        if (tFiles != 0) {
-            {
-                for (i = 0; i < tFiles - 1; i++) {
-                    for (j = i + 1; j < tFiles; j++) {
-                        if (xstrcasecmp(FList[j].Title, FList[i].Title) < 0) {
-                            memcpy(&FList[tFiles], &FList[i], sizeof(SFInfo));
-                            memcpy(&FList[i], &FList[j], sizeof(SFInfo));
-                            memcpy(&FList[j], &FList[tFiles], sizeof(SFInfo));
-                        }
-                    }
-                }
-            }
+        // Normal lists every save
+        if (saveType != SAVEGAME_Normal && saves[i].type != saveType) {
+            continue;
         }
 
+        memset(&info, 0, sizeof info);
+        strcpy(info.Name, saves[i].name.c_str());
+        strncpy(info.Title, saves[i].header.Name, sizeof info.Title - 1);
+        files.push_back(info);
     }
 
-    return tFiles;
+    std::stable_sort(files.begin(), files.end(), TitleLess);
+
+    FList = files.empty() ? NULL : &files[0];
+
+    return files.size();
 }
 
 
@@ -325,9 +304,9 @@ next:
  * Play-by-mail and Modem play are currently disabled.
  *
  * This relies on a number of global and local file global variables.
- * SaveHdr & FList are local file global pointers to save file data,
- * loaded into the global byte array "buffer". They are assigned, and
- * buffer populated, via GenerateTables().
+ * SaveHdr & FList are local file global pointers to save file data;
+ * SaveHdr points into the global byte array "buffer". They are
+ * assigned via GenerateTables().
  *
  * \param mode  0 if saving is allowed, 1 if not, 2 if only email saves.
  */
@@ -544,7 +523,7 @@ void FileAccess(char mode)
                     memcpy(interimData.tempReplay, load_buffer, interimData.replaySize);
                     free(load_buffer);
 
-                    eventSize = fileLength - ftell(fin);
+                    eventSize = fileLength - ftell(fin) - read_save_rng(fin, fileLength);
 
                     // Read the Event Data
                     load_buffer = (REPLAY *)malloc(eventSize);
@@ -819,6 +798,7 @@ void FileAccess(char mode)
 
                 // Save Event information
                 fwrite(interimData.eventBuffer, interimData.eventSize, 1, fin);
+                write_save_rng(fin);
 
                 fclose(fin);
             }  // end done if
@@ -904,6 +884,7 @@ void FileAccess(char mode)
 
                 // Save Event Data
                 fwrite(interimData.eventBuffer, interimData.eventSize, 1, fin);
+                write_save_rng(fin);
 
                 fclose(fin);
             }
@@ -937,7 +918,10 @@ void FileAccess(char mode)
                 fill_rectangle(38, 49, 190, 127, 0);
                 ShBox(39, 52 + BarB * 8, 189, 60 + BarB * 8);
                 DrawFiles(now, BarB, tFiles);
-                FileText(&FList[now].Name[0]);
+
+                if (tFiles) {
+                    FileText(&FList[now].Name[0]);
+                }
 
                 if (tFiles == 0) {
                     InBox(207, 48, 280, 60);
@@ -1092,6 +1076,7 @@ void FileAccess(char mode)
  *     the state data
  *   - the Replay information detailing the events of launches
  *   - the event data, consisting of each turn's news text
+ *   - the random stream of the game, as of the end-of-turn save
  *
  * \param name  The filename to write the save under.
  */
@@ -1141,6 +1126,7 @@ void save_game(char *name)
 
     // Copy Event data into Save file
     fwrite(interimData.eventBuffer, interimData.eventSize, 1, outf);
+    write_save_rng(outf);
 
 cleanup:
 
@@ -1238,7 +1224,7 @@ char GetBlockName(char *Nam)
  * \param loc     The display index of the current save file.
  * \param tFiles  The total count of savegame files.
  */
-void DrawFiles(char now, char loc, char tFiles)
+void DrawFiles(int now, int loc, int tFiles)
 {
     int i, j, start;
     start = now - loc;
@@ -1368,7 +1354,8 @@ void FileText(char *name)
  * missions set for next season or missions scheduled for the current
  * season. The former are referenced as "Future" missions, while the
  * latter is used as an entrance point for the Vehicle Assembly
- * building.
+ * building. Each pad shows the odds of its mission, once it has
+ * hardware to fly on (see DrawPadOdds()).
  *
  * \param plr   The index of the active player (Player 0 or Player 1).
  * \param type  0 for Future Missions, 1 for Vehicle Assembly.
@@ -1501,6 +1488,8 @@ int FutureCheck(char plr, char type)
                 }
             }
 
+            DrawPadOdds(plr, i, type == 0, 111, 50 + i * 51);
+
             if (type == 0) {
                 if (Data->P[plr].Future[i].part == 0) {
                     if (m[i] == 0) {
@@ -1739,8 +1728,64 @@ int32_t EndOfTurnSave(char *inData, int dataLen)
     interimData.endTurnBuffer = (char *)malloc(interimData.endTurnSaveSize);
     memcpy(interimData.endTurnBuffer, buffer, interimData.endTurnSaveSize);
     free(buffer);
+    memcpy(interimData.endTurnRng, game_rng.s, sizeof(interimData.endTurnRng));
 
     return interimData.endTurnSaveSize;
 }
 
+/* Write the random stream of the end-of-turn save, low bytes first. */
+static void
+write_save_rng(FILE *fout)
+{
+    unsigned char raw[sizeof(interimData.endTurnRng)];
+
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 8; b++) {
+            raw[i * 8 + b] = interimData.endTurnRng[i] >> (8 * b);
+        }
+    }
+
+    fwrite(raw, sizeof(raw), 1, fout);
+    fwrite(save_rng_tag, sizeof(save_rng_tag), 1, fout);
+}
+
+
+/* Look for the random stream at the end of a save file and, if it is
+ * there, carry on the game with it.  The file position is left as it was.
+ *
+ * \return  the size of the stream in the file, 0 if there is none.
+ */
+static size_t
+read_save_rng(FILE *fin, size_t fileLength)
+{
+    unsigned char raw[SAVE_RNG_SIZE];
+    long pos = ftell(fin);
+    size_t found = 0;
+
+    if (fileLength - pos < SAVE_RNG_SIZE) {
+        return 0;
+    }
+
+    fseek(fin, fileLength - SAVE_RNG_SIZE, SEEK_SET);
+
+    if (fread(raw, sizeof(raw), 1, fin) == 1 &&
+        memcmp(raw + sizeof(interimData.endTurnRng), save_rng_tag,
+               sizeof(save_rng_tag)) == 0) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t v = 0;
+
+            for (int b = 7; b >= 0; b--) {
+                v = (v << 8) | raw[i * 8 + b];
+            }
+
+            interimData.endTurnRng[i] = game_rng.s[i] = v;
+        }
+
+        found = SAVE_RNG_SIZE;
+    }
+
+    fseek(fin, pos, SEEK_SET);
+    return found;
+}
+
 // EOF
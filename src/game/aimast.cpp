@@ -34,8 +34,10 @@
 #include "aipur.h"
 #include "pace.h"
 
-char Level_Check;
-enum Opponent_Status Cur_Status;
+GAME_LOCAL char Level_Check;
+GAME_LOCAL enum Opponent_Status Cur_Status;
+GAME_LOCAL_RESET(Level_Check);
+GAME_LOCAL_RESET(Cur_Status);
 
 // Track[0] - orbital satellite
 // Track[1] - end stage location holder
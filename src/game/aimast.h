@@ -2,9 +2,10 @@
 #define AIMAST_H
 
 #include "data.h"
+#include "game_context.h"
 
 void AIMaster(char plr);
 
-extern enum Opponent_Status Cur_Status;
+extern GAME_LOCAL enum Opponent_Status Cur_Status;
 
 #endif // AIMAST_H
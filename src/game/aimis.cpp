@@ -36,11 +36,18 @@
 #include "mc.h"
 #include "aimast.h"
 
-struct {
+GAME_LOCAL struct {
     int16_t cost, sf, i;
 } Mew[5];
-int whe[2], rck[2];
-char pc[2], bc[2], Alt_A[2] = {0, 0}, Alt_B[2] = {0, 0};
+GAME_LOCAL int whe[2], rck[2];
+GAME_LOCAL char pc[2], bc[2], Alt_A[2] = {0, 0}, Alt_B[2] = {0, 0};
+GAME_LOCAL_RESET(Mew);
+GAME_LOCAL_RESET(whe);
+GAME_LOCAL_RESET(rck);
+GAME_LOCAL_RESET(pc);
+GAME_LOCAL_RESET(bc);
+GAME_LOCAL_RESET(Alt_A);
+GAME_LOCAL_RESET(Alt_B);
 void Strategy_One(char plr, int *m_1, int *m_2, int *m_3);
 void Strategy_Two(char plr, int *m_1, int *m_2, int *m_3);
 void Strategy_Thr(char plr, int *m_1, int *m_2, int *m_3);
@@ -44,8 +44,10 @@
 #include "gr.h"
 #include "pace.h"
 
-struct ManPool *Men;
-char AIsel[25];
+GAME_LOCAL struct ManPool *Men;
+GAME_LOCAL char AIsel[25];
+GAME_LOCAL_RESET(Men);
+GAME_LOCAL_RESET(AIsel);
 
 
 void DrawStatistics(char Win);
@@ -1,6 +1,8 @@
 #ifndef AIPUR_H
 #define AIPUR_H
 
+#include "game_context.h"
+
 void AIAstroPur(char plr);
 void AIPur(char plr);
 void DumpAstro(char plr, int inx);
@@ -9,6 +11,6 @@ void RDafford(char plr, int Class, int index);
 void Stat(char Win);
 void TransAstro(char plr, int inx);
 
-extern struct ManPool *Men;
+extern GAME_LOCAL struct ManPool *Men;
 
 #endif // AIPUR_H
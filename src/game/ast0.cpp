@@ -43,9 +43,12 @@
 #include <iostream>
 #include <sstream>
 
-char MCol[110];
-char sel[30];
-char MaxSel;
+GAME_LOCAL char MCol[110];
+GAME_LOCAL char sel[30];
+GAME_LOCAL char MaxSel;
+GAME_LOCAL_RESET(MCol);
+GAME_LOCAL_RESET(sel);
+GAME_LOCAL_RESET(MaxSel);
 
 
 void SatDraw(char plr);
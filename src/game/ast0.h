@@ -1,6 +1,8 @@
 #ifndef AST0_H
 #define AST0_H
 
+#include "game_context.h"
+
 void BarSkill(char plr, int lc, int nw, int *ary);
 void DispLeft(char plr, int lc, int cnt, int nw, int *ary);
 void LMBld(char plr);
@@ -8,8 +10,8 @@ int MoodColor(uint8_t mood);
 void Moon(char plr);
 void SatBld(char plr);
 
-extern char MCol[110];
-extern char sel[30];
-extern char MaxSel;
+extern GAME_LOCAL char MCol[110];
+extern GAME_LOCAL char sel[30];
+extern GAME_LOCAL char MaxSel;
 
 #endif // AST0_H
@@ -332,11 +332,14 @@ TrainText(char plr, int astro, int cnt)
      5  =  Advanced Endurance
 */
 
+/* the last training Train() was given as level 0 */
+static GAME_LOCAL int trainLevel = 1;
+GAME_LOCAL_RESET(trainLevel);
+
 void Train(char plr, int level)
 {
     int now2, BarA, count, i, M[100];
     char temp, Train[10];
-    static int m = 1;
 
     for (i = 0; i < 100; i++) {
         M[i] = -1;
@@ -370,13 +373,13 @@ void Train(char plr, int level)
     FadeIn(2, 10, 0, 0);
 
     if (level == 0) {
-        if (m > 4) {
-            m = 1;
+        if (trainLevel > 4) {
+            trainLevel = 1;
         } else {
-            m++;
+            trainLevel++;
         }
 
-        level = m;
+        level = trainLevel;
     }
 
     memset(Train, 0x00, sizeof(Train));
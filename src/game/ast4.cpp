@@ -44,11 +44,15 @@
 
 #define Guy(a,b,c,d) (Data->P[a].Crew[b][c][d]-1)
 
-static char program;  /* Variable to store prog data for "Draws Astronaut attributes" section: 1=Mercury/Vostok...5=Jupiter/Kvartet */
-
-int missions;   // Variable for how many missions each 'naut has flown
-int retdel;  // Variable to store whether a given 'naut has announced retirement
-int sex;  // Variable to store a given 'naut sex
+static GAME_LOCAL char program;  /* Variable to store prog data for "Draws Astronaut attributes" section: 1=Mercury/Vostok...5=Jupiter/Kvartet */
+GAME_LOCAL_RESET(program);
+
+GAME_LOCAL int missions;   // Variable for how many missions each 'naut has flown
+GAME_LOCAL int retdel;  // Variable to store whether a given 'naut has announced retirement
+GAME_LOCAL int sex;  // Variable to store a given 'naut sex
+GAME_LOCAL_RESET(missions);
+GAME_LOCAL_RESET(retdel);
+GAME_LOCAL_RESET(sex);
 
 
 void AstLevel(char plr, char prog, char crew, char ast);
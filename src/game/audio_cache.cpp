@@ -0,0 +1,227 @@
+// This file keeps decoded sound effects and voices around for reuse.
+
+#include "audio_cache.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+
+#include "logging.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(audio)
+
+typedef std::map<std::string, struct audio_pcm *> pcm_index;
+
+static struct {
+    audio_cache_loader loader;
+    pcm_index *index;
+    struct audio_pcm *head;     /* most recently used */
+    struct audio_pcm *tail;     /* least recently used */
+    struct audio_cache_stats stats;
+} cache;
+
+static void
+lru_unlink(struct audio_pcm *pcm)
+{
+    if (pcm->prev) {
+        pcm->prev->next = pcm->next;
+    } else {
+        cache.head = pcm->next;
+    }
+
+    if (pcm->next) {
+        pcm->next->prev = pcm->prev;
+    } else {
+        cache.tail = pcm->prev;
+    }
+
+    pcm->prev = pcm->next = NULL;
+}
+
+static void
+lru_push_front(struct audio_pcm *pcm)
+{
+    pcm->prev = NULL;
+    pcm->next = cache.head;
+
+    if (cache.head) {
+        cache.head->prev = pcm;
+    } else {
+        cache.tail = pcm;
+    }
+
+    cache.head = pcm;
+}
+
+static void
+pcm_free(struct audio_pcm *pcm)
+{
+    lru_unlink(pcm);
+    cache.index->erase(pcm->name);
+    cache.stats.bytes -= pcm->size;
+    cache.stats.entries--;
+    free(pcm->data);
+    free(pcm->name);
+    free(pcm);
+}
+
+/* drop unreferenced entries, oldest first, until we fit the budget */
+static void
+evict(void)
+{
+    struct audio_pcm *pcm = cache.tail;
+
+    while (pcm && cache.stats.bytes > cache.stats.budget) {
+        struct audio_pcm *prev = pcm->prev;
+
+        if (!pcm->refs) {
+            TRACE2("evicting `%s'", pcm->name);
+            pcm_free(pcm);
+            cache.stats.evictions++;
+        }
+
+        pcm = prev;
+    }
+}
+
+/**
+ * Set up the cache.
+ *
+ * \param budget bytes of decoded audio to keep around
+ * \param loader function decoding a file into a malloc()ed buffer
+ */
+void
+audio_cache_init(size_t budget, audio_cache_loader loader)
+{
+    assert(loader);
+
+    audio_cache_shutdown();
+
+    memset(&cache.stats, 0, sizeof(cache.stats));
+    cache.stats.budget = budget;
+    cache.loader = loader;
+    cache.index = new pcm_index;
+}
+
+/** Free every entry; none may still be referenced. */
+void
+audio_cache_shutdown(void)
+{
+    if (!cache.index) {
+        return;
+    }
+
+    while (cache.head) {
+        if (cache.head->refs) {
+            WARNING3("`%s' still has %u references",
+                     cache.head->name, cache.head->refs);
+        }
+
+        pcm_free(cache.head);
+    }
+
+    delete cache.index;
+    cache.index = NULL;
+}
+
+/**
+ * Look up a decoded file, decoding it on a miss.
+ *
+ * \return a new reference to the entry, or NULL if the file can't be
+ * decoded or holds no samples
+ */
+struct audio_pcm *
+audio_cache_get(const char *name)
+{
+    struct audio_pcm *pcm;
+    pcm_index::iterator it;
+    char *data = NULL;
+    size_t size = 0;
+    ssize_t bytes;
+
+    assert(name);
+    assert(cache.index);
+
+    it = cache.index->find(name);
+
+    if (it != cache.index->end()) {
+        pcm = it->second;
+        cache.stats.hits++;
+        lru_unlink(pcm);
+        lru_push_front(pcm);
+        pcm->refs++;
+        return pcm;
+    }
+
+    cache.stats.misses++;
+    bytes = cache.loader(name, &data, &size);
+
+    if (bytes <= 0) {
+        free(data);
+        return NULL;
+    }
+
+    pcm = (struct audio_pcm *)xcalloc(1, sizeof(*pcm));
+    pcm->name = xstrdup(name);
+    pcm->data = (char *)xrealloc(data, bytes);
+    pcm->size = bytes;
+    pcm->refs = 1;
+
+    (*cache.index)[pcm->name] = pcm;
+    lru_push_front(pcm);
+    cache.stats.bytes += pcm->size;
+    cache.stats.entries++;
+
+    evict();
+
+    DEBUG5("decoded `%s' (%lu hits, %lu misses, %lu evictions)", name,
+           cache.stats.hits, cache.stats.misses, cache.stats.evictions);
+
+    return pcm;
+}
+
+/** Check whether a file is cached, without counting as a use. */
+int
+audio_cache_has(const char *name)
+{
+    assert(name);
+
+    return cache.index && cache.index->count(name) != 0;
+}
+
+/** Take another reference to an entry. */
+struct audio_pcm *
+audio_cache_ref(struct audio_pcm *pcm)
+{
+    assert(pcm);
+
+    pcm->refs++;
+    return pcm;
+}
+
+/** Give back a reference; NULL is ignored. */
+void
+audio_cache_release(struct audio_pcm *pcm)
+{
+    if (!pcm) {
+        return;
+    }
+
+    assert(pcm->refs > 0);
+
+    if (--pcm->refs == 0) {
+        evict();
+    }
+}
+
+void
+audio_cache_get_stats(struct audio_cache_stats *stats)
+{
+    assert(stats);
+
+    *stats = cache.stats;
+}
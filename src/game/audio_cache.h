@@ -0,0 +1,47 @@
+#ifndef AUDIO_CACHE_H
+#define AUDIO_CACHE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/**
+ * \file audio_cache.h Decoded sound effects and voices, kept for reuse.
+ *
+ * Files are decoded once and kept in memory until the cache outgrows its
+ * byte budget, at which point the least recently used ones are dropped.
+ * Every audio_cache_get() or audio_cache_ref() takes a reference that
+ * must be given back with audio_cache_release(); referenced entries, such
+ * as one that is still queued on an audio channel, are never evicted.
+ */
+
+/** Decoder used to fill the cache; load_audio_file() in the game. */
+typedef ssize_t (*audio_cache_loader)(const char *name, char **data,
+                                      size_t *size);
+
+struct audio_pcm {
+    char *name;
+    char *data;                 /**< 16-bit mono samples */
+    size_t size;                /**< bytes in data */
+    unsigned refs;
+    struct audio_pcm *prev;     /**< more recently used */
+    struct audio_pcm *next;     /**< less recently used */
+};
+
+struct audio_cache_stats {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned entries;
+    size_t bytes;
+    size_t budget;
+};
+
+void audio_cache_init(size_t budget, audio_cache_loader loader);
+void audio_cache_shutdown(void);
+struct audio_pcm *audio_cache_get(const char *name);
+int audio_cache_has(const char *name);
+struct audio_pcm *audio_cache_ref(struct audio_pcm *pcm);
+void audio_cache_release(struct audio_pcm *pcm);
+void audio_cache_get_stats(struct audio_cache_stats *stats);
+
+#endif /* AUDIO_CACHE_H */
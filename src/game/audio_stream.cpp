@@ -0,0 +1,302 @@
+// This file decodes audio files on a background thread while they play.
+
+#include "Buzz_inc.h"
+#include "utils.h"
+#include "mmfile.h"
+#include "audio_stream.h"
+#include <assert.h>
+
+LOG_DEFAULT_CATEGORY(audio)
+
+/* ring size in samples, must be a power of two; ~6 seconds at 11025Hz */
+#define STREAM_RING_SAMPLES     65536
+
+/* most samples decoded at once, so the decoder checks for quit often */
+#define STREAM_DECODE_SAMPLES   4096
+
+#define RING_POS(n) ((n) & (STREAM_RING_SAMPLES - 1))
+
+/*
+ * The sample counters only ever grow; positions in the ring are taken
+ * modulo its size.  read <= committed <= decoded always holds.
+ *
+ * The decoder thread owns decoded.  committed, eof and failed are written
+ * by the decoder with the audio lock held, and read is advanced by the
+ * audio callback, which runs with the lock held too.
+ *
+ * When the ring is full the decoder sets waiting and blocks on space,
+ * which the callback posts once it has made room, or close posts to
+ * make it quit.  A stream nobody plays leaves its decoder asleep.
+ */
+struct audio_stream {
+    char *name;             /* full path, so the decoder never calls sOpen() */
+    int loop;
+    unsigned trim;
+    int16_t *ring;
+    unsigned read;          /* consumed by the audio callback */
+    unsigned committed;     /* decoded and past the trimmed tail */
+    unsigned decoded;       /* written to the ring by the decoder */
+    int eof;                /* committed won't grow any more */
+    int failed;             /* the file could not be played */
+    unsigned underruns;     /* callbacks that ran out of samples */
+    int waiting;            /* the decoder waits on space */
+    volatile int quit;
+    SDL_sem *space;
+    SDL_Thread *thread;
+};
+
+static int
+stream_open_file(struct audio_stream *s, mm_file *mf)
+{
+    unsigned channels, rate;
+
+    if (mm_open(mf, s->name) < 0) {
+        return -1;
+    }
+
+    if (mm_audio_info(mf, &channels, &rate) < 0) {
+        WARNING2("no audio data in file `%s'", s->name);
+        mm_close(mf);
+        return -1;
+    }
+
+    if (channels != 1 || rate != 11025) {
+        ERROR2("file `%s' should be mono, 11025Hz", s->name);
+        mm_close(mf);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+stream_thread(void *arg)
+{
+    struct audio_stream *s = (struct audio_stream *)arg;
+    mm_file mf;
+    int open = 0;
+    unsigned pass_start = 0;
+
+    while (!s->quit) {
+        unsigned pos, space, chunk, pass;
+        int bytes;
+
+        if (!open) {
+            if (stream_open_file(s, &mf) < 0) {
+                SDL_LockAudio();
+                s->failed = 1;
+                s->eof = 1;
+                SDL_UnlockAudio();
+                break;
+            }
+
+            open = 1;
+            pass_start = s->decoded;
+        }
+
+        SDL_LockAudio();
+        space = STREAM_RING_SAMPLES - (s->decoded - s->read);
+        s->waiting = (space == 0);
+        SDL_UnlockAudio();
+
+        if (space == 0) {
+            SDL_SemWait(s->space);
+            continue;
+        }
+
+        pos = RING_POS(s->decoded);
+        chunk = MIN(space, STREAM_RING_SAMPLES - pos);
+        chunk = MIN(chunk, STREAM_DECODE_SAMPLES);
+
+        bytes = mm_decode_audio(&mf, s->ring + pos, chunk * 2);
+
+        if (bytes > 0) {
+            s->decoded += bytes / 2;
+            pass = s->decoded - pass_start;
+
+            if (pass > s->trim) {
+                SDL_LockAudio();
+                s->committed = s->decoded - s->trim;
+                SDL_UnlockAudio();
+            }
+
+            continue;
+        }
+
+        /* end of this pass: drop the tail, or keep a track too short to trim */
+        mm_close(&mf);
+        open = 0;
+        pass = s->decoded - pass_start;
+
+        SDL_LockAudio();
+
+        if (pass > s->trim) {
+            s->decoded = s->committed;
+        } else {
+            s->committed = s->decoded;
+        }
+
+        if (!s->loop || pass == 0) {
+            s->eof = 1;
+        }
+
+        SDL_UnlockAudio();
+
+        if (s->eof) {
+            break;
+        }
+    }
+
+    if (open) {
+        mm_close(&mf);
+    }
+
+    return 0;
+}
+
+/**
+ * Start playing an audio file through a ring buffer.
+ *
+ * The file is located here, but opened and decoded by a new thread, so
+ * this returns right away.  If the file turns out to be unusable,
+ * audio_stream_failed() becomes true and the stream plays silence.
+ *
+ * \param name file name, looked up like any other #FT_AUDIO file
+ * \param loop whether to restart the file when it ends
+ * \param trim samples to drop from the end of the file
+ * \return the stream, or NULL if the file doesn't exist or the decoder
+ * thread can't be started
+ */
+struct audio_stream *
+audio_stream_open(const char *name, int loop, unsigned trim)
+{
+    struct audio_stream *s;
+    char *path;
+
+    assert(name);
+    assert(trim < STREAM_RING_SAMPLES);
+
+    /* the file system lookup isn't thread-safe, so do it here */
+    if ((path = locate_file(name, FT_AUDIO)) == NULL) {
+        return NULL;
+    }
+
+    s = (struct audio_stream *)xcalloc(1, sizeof(*s));
+    s->name = path;
+    s->loop = loop;
+    s->trim = trim;
+    s->ring = (int16_t *)xmalloc(STREAM_RING_SAMPLES * sizeof(int16_t));
+
+    if ((s->space = SDL_CreateSemaphore(0)) != NULL) {
+        s->thread = SDL_CreateThread(stream_thread, s);
+    }
+
+    if (!s->thread) {
+        ERROR3("can't start decoder for `%s': %s", name, SDL_GetError());
+
+        if (s->space) {
+            SDL_DestroySemaphore(s->space);
+        }
+
+        free(s->ring);
+        free(s->name);
+        free(s);
+        return NULL;
+    }
+
+    return s;
+}
+
+/**
+ * Stop the decoder and free the stream.
+ *
+ * The stream must not be attached to an audio channel any more.
+ */
+void
+audio_stream_close(struct audio_stream *s)
+{
+    if (!s) {
+        return;
+    }
+
+    s->quit = 1;
+    SDL_SemPost(s->space);
+    SDL_WaitThread(s->thread, NULL);
+    SDL_DestroySemaphore(s->space);
+
+    if (s->underruns) {
+        DEBUG3("`%s' ran out of decoded audio %u times",
+               s->name, s->underruns);
+    }
+
+    free(s->ring);
+    free(s->name);
+    free(s);
+}
+
+/** Check whether the file could not be opened or decoded. */
+int
+audio_stream_failed(struct audio_stream *s)
+{
+    int failed;
+
+    assert(s);
+
+    SDL_LockAudio();
+    failed = s->failed;
+    SDL_UnlockAudio();
+
+    return failed;
+}
+
+/** Check whether every sample of a non-looping stream has been played. */
+int
+audio_stream_finished(struct audio_stream *s)
+{
+    int finished;
+
+    assert(s);
+
+    SDL_LockAudio();
+    finished = s->eof && s->read == s->committed;
+    SDL_UnlockAudio();
+
+    return finished;
+}
+
+/**
+ * Mix decoded samples into the audio callback's buffer.
+ *
+ * If the decoder has fallen behind, the rest of \a dst is left alone.
+ *
+ * \return number of samples mixed
+ */
+unsigned
+audio_stream_mix(struct audio_stream *s, int16_t *dst, unsigned samples,
+                 struct mixer_voice *voice)
+{
+    unsigned done = 0;
+
+    assert(s);
+
+    while (done < samples && s->read != s->committed) {
+        unsigned pos = RING_POS(s->read);
+        unsigned n = MIN(samples - done, s->committed - s->read);
+
+        n = MIN(n, STREAM_RING_SAMPLES - pos);
+        mixer_mix(dst + done, s->ring + pos, n, voice);
+        s->read += n;
+        done += n;
+    }
+
+    if (done < samples && !s->eof) {
+        s->underruns++;
+    }
+
+    if (done && s->waiting) {
+        s->waiting = 0;
+        SDL_SemPost(s->space);
+    }
+
+    return done;
+}
@@ -0,0 +1,32 @@
+#ifndef AUDIO_STREAM_H
+#define AUDIO_STREAM_H
+
+#include <stdint.h>
+
+#include "mixer.h"
+
+/**
+ * \file audio_stream.h Audio files decoded while they play.
+ *
+ * A stream owns a small ring of 16-bit mono samples at 11025Hz which a
+ * background thread keeps filled from the Ogg Vorbis file, so playing a
+ * long track neither stalls the caller nor holds the whole track in
+ * memory.  The audio callback drains the ring with audio_stream_mix().
+ *
+ * The last \a trim samples of each pass through the file are dropped;
+ * a looping stream restarts the file right after the trimmed point.
+ */
+
+struct audio_stream;
+
+struct audio_stream *audio_stream_open(const char *name, int loop,
+                                       unsigned trim);
+void audio_stream_close(struct audio_stream *stream);
+int audio_stream_failed(struct audio_stream *stream);
+int audio_stream_finished(struct audio_stream *stream);
+
+/* called from the audio callback, with the audio lock held */
+unsigned audio_stream_mix(struct audio_stream *stream, int16_t *dst,
+                          unsigned samples, struct mixer_voice *voice);
+
+#endif /* AUDIO_STREAM_H */
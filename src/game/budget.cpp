@@ -44,7 +44,8 @@
 
 #define DELAYCNT 10
 
-char olderMiss;
+GAME_LOCAL char olderMiss;
+GAME_LOCAL_RESET(olderMiss);
 
 
 void DrawBudget(char player, char *pStatus);
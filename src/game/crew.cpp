@@ -239,7 +239,7 @@ int AsnCrew(char plr, char pad, char part)
 {
     int count = 0, i, prg = 0, grp = -1, prime = -1, men = 0, back = -1, t = 0, s = 0, k = 0, yes = 0, stflag = 0, bug;
 
-    std::string oldKeyHelpText = keyHelpText;
+    struct HelpCode oldKeyHelpText = keyHelpText;
     keyHelpText = "k200";
     men = Data->P[plr].Future[pad].Men;
     prg = Data->P[plr].Future[pad].Prog;
@@ -779,7 +779,7 @@ int HardRequest(char plr, char mode, char mis, char pad)
 {
     int i = 0, pr[5], t = 0;
 
-    std::string oldKeyHelpText = keyHelpText;
+    struct HelpCode oldKeyHelpText = keyHelpText;
     keyHelpText = "k201";
 
     for (i = 0; i < 5; i++) {
@@ -944,7 +944,7 @@ int SecondHard(char plr, char mode, char mis, char pad)
 
     int i = 0, men = 0, prg = 0, prog[5], t = 0;
 
-    std::string oldKeyHelpText = keyHelpText;
+    struct HelpCode oldKeyHelpText = keyHelpText;
     keyHelpText = "k201";
 
     for (i = 0; i < 5; i++) {
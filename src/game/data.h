@@ -832,6 +832,7 @@ typedef struct {
     // ENDTURN.TMP related variables
     uint32_t endTurnSaveSize;
     char *endTurnBuffer;
+    uint64_t endTurnRng[4];   // the random stream (struct rng) as of endTurnBuffer
 } INTERIMDATA;
 
 #pragma pack(pop)
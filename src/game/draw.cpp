@@ -1,6 +1,7 @@
 // This file defines how characters are printed on the screen
 
 #include "draw.h"
+#include "glyph_atlas.h"
 #include "gr.h"
 #include "pace.h"
 #include "sdlhelper.h"
@@ -14,6 +15,29 @@
 #include <string.h>
 #include <ctype.h>
 
+/** Draw characters at the current position of the graphics handler.
+ *
+ * The characters come from the glyph atlas and are drawn in the
+ * foreground color. The position is moved past them afterwards.
+ */
+static void draw_glyphs(const char *s, size_t length)
+{
+    display::LegacySurface *screen = display::graphics.legacyScreen();
+    SDL_Surface *surface = screen->surface();
+    struct glyph_rect touched;
+    int x, y;
+
+    grGetCurPos(&x, &y);
+    glyph_draw((char *)surface->pixels, surface->pitch, surface->w, surface->h,
+               &x, &y, s, length, display::graphics.foregroundColor(),
+               &touched);
+    grMoveTo(x, y);
+
+    if (touched.w) {
+        screen->markDirty(touched.x, touched.y, touched.w, touched.h);
+    }
+}
+
 /** Print string at specific position
  *
  * The function will print a string at a certain position.
@@ -29,8 +53,6 @@
  */
 void draw_string(int x, int y, const char *s)
 {
-    short i;
-
     if (x != 0 && y != 0) {
         grMoveTo(x, y);
     }
@@ -39,9 +61,7 @@ void draw_string(int x, int y, const char *s)
         return;
     }
 
-    for (i = 0; i < (int)strlen(s); i++) {
-        draw_character(s[i]);
-    }
+    draw_glyphs(s, strlen(s));
 }
 
 void draw_string_highlighted(int x, int y, const char *s, unsigned int position)
@@ -293,14 +313,6 @@ void draw_flag(int x, int y, char plr)
     display::graphics.screen()->draw(flag, x, y);
 }
 
-
-// Convenience defines, it seems the implementor didn't feel like typing much
-#define MR grMoveRel
-#define LR grLineRel
-#define LT grLineTo
-#define MT grMoveTo
-#define SC grSetColor
-
 /** Prints a character at current position of graphics handler.
  *
  * \note The function converts all characters to upper case before printing.
@@ -309,524 +321,7 @@ void draw_flag(int x, int y, char plr)
  */
 void draw_character(char chr)
 {
-    switch (toupper(chr)) {
-    case 'A':
-        LR(0, -3);
-        LR(1, -1);
-        LR(2, 0);
-        LR(1, 1);
-        LR(0, 3);
-        LR(-1, -1);
-        LR(-2, 0);
-        MR(5, 1);
-        break;
-
-    case 'B':
-        LR(0, -4);
-        LR(3, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(0, -2);
-        LR(1, 0);
-        MR(4, 2);
-        break;
-
-    case 'C':
-        MR(4, -4);
-        LR(-3, 0);
-        LR(-1, 1);
-        LR(0, 2);
-        LR(1, 1);
-        LR(3, 0);
-        MR(2, 0);
-        break;
-
-    case 'D':
-        LR(0, -4);
-        LR(3, 0);
-        LR(1, 1);
-        LR(0, 2);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(5, 0);
-        break;
-
-    case 'E':
-        LR(0, -4);
-        LR(4, 0);
-        MR(0, 4);
-        LR(-3, 0);
-        MR(0, -2);
-        LR(1, 0);
-        MR(4, 2);
-        break;
-
-    case 'F':
-        LR(0, -4);
-        LR(4, 0);
-        MR(-2, 2);
-        LR(-1, 0);
-        MR(5, 2);
-        break;
-
-    case 'G':
-        MR(4, -4);
-        LR(-3, 0);
-        LR(-1, 1);
-        LR(0, 2);
-        LR(1, 1);
-        LR(3, 0);
-        LR(0, -2);
-        LR(-1, 0);
-        MR(3, 2);
-        break;
-
-    case 'H':
-        LR(0, -4);
-        MR(1, 2);
-        LR(2, 0);
-        MR(1, -2);
-        LR(0, 4);
-        MR(2, 0);
-        break;
-
-    case 'I':
-        LR(2, 0);
-        LR(-1, -1);
-        LR(0, -2);
-        LR(-1, -1);
-        LR(2, 0);
-        MR(2, 4);
-        break;
-
-    case 'J':
-        MR(0, -1);
-        LR(1, 1);
-        LR(2, 0);
-        LR(1, -1);
-        LR(0, -3);
-        MR(2, 4);
-        break;
-
-    case 'K':
-        LR(0, -4);
-        MR(4, 0);
-        LR(-2, 2);
-        LR(-1, 0);
-        MR(1, 0);
-        LR(2, 2);
-        MR(2, 0);
-        break;
-
-    case 'L':
-        MR(0, -4);
-        LR(0, 4);
-        LR(4, 0);
-        MR(2, 0);
-        break;
-
-    case 'M':
-        LR(0, -4);
-        LR(2, 2);
-        LR(2, -2);
-        LR(0, 4);
-        MR(2, 0);
-        break;
-
-    case 'N':
-        LR(0, -4);
-        LR(4, 4);
-        LR(0, -4);
-        MR(2, 4);
-        break;
-
-    case 'O':
-    case '0':
-        MR(0, -1);
-        LR(0, -2);
-        LR(1, -1);
-        LR(2, 0);
-        LR(1, 1);
-        LR(0, 2);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(5, 0);
-        break;
-
-    case 'P':
-        LR(0, -4);
-        LR(3, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(5, 2);
-        break;
-
-    case 'Q':
-        MR(0, -1);
-        LR(0, -2);
-        LR(1, -1);
-        LR(2, 0);
-        LR(1, 1);
-        LR(0, 2);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(2, -1);
-        LR(1, 1);
-        MR(2, 0);
-        break;
-
-    case 'R':
-        LR(0, -4);
-        LR(3, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-2, 0);
-        MR(3, 1);
-        LR(0, 1);
-        MR(2, 0);
-        break;
-
-    case 'S':
-        LR(3, 0);
-        LR(1, -1);
-        LR(-1, -1);
-        LR(-2, 0);
-        LR(-1, -1);
-        LR(1, -1);
-        LR(3, 0);
-        MR(2, 4);
-        break;
-
-    case 'T':
-        MR(2, 0);
-        LR(0, -4);
-        LR(-2, 0);
-        LR(4, 0);
-        MR(2, 4);
-        break;
-
-    case 'U':
-        MR(0, -4);
-        LR(0, 3);
-        LR(1, 1);
-        LR(2, 0);
-        LR(1, -1);
-        LR(0, -3);
-        MR(2, 4);
-        break;
-
-    case 'V':
-        MR(0, -4);
-        LR(0, 2);
-        LR(2, 2);
-        LR(2, -2);
-        LR(0, -2);
-        MR(2, 4);
-        break;
-
-    case 'W':
-        MR(0, -4);
-        LR(0, 4);
-        LR(2, -2);
-        LR(2, 2);
-        LR(0, -4);
-        MR(2, 4);
-        break;
-
-    case 'X':
-        MR(0, -4);
-        LR(4, 4);
-        MR(0, -4);
-        LR(-4, 4);
-        MR(6, 0);
-        break;
-
-    case 'Y':
-        MR(2, 0);
-        LR(0, -1);
-        LR(-2, -2);
-        LR(0, -1);
-        MR(4, 0);
-        LR(0, 1);
-        LR(-2, 2);
-        MR(4, 1);
-        break;
-
-    case 'Z':
-        MR(0, -4);
-        LR(4, 0);
-        LR(-4, 4);
-        LR(4, 0);
-        MR(2, 0);
-        break;
-
-    case '1':
-        LR(2, 0);
-        LR(-1, -1);
-        LR(0, -3);
-        LR(-1, 1);
-        MR(4, 3);
-        break;
-
-    case '2':
-        MR(0, -4);
-        LR(3, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-1, 0);
-        LR(-2, 2);
-        LR(4, 0);
-        MR(2, 0);
-        break;
-
-    case '3':
-        LR(3, 0);
-        LR(1, -1);
-        LR(-1, -1);
-        LR(-1, 0);
-        LR(1, 0);
-        LR(1, -1);
-        LR(-1, -1);
-        LR(-3, 0);
-        MR(6, 4);
-        break;
-
-    case '4':
-        MR(4, -1);
-        LR(-4, 0);
-        LR(0, -1);
-        LR(2, -2);
-        LR(1, 0);
-        LR(0, 4);
-        MR(3, 0);
-        break;
-
-    case '5':
-        LR(3, 0);
-        LR(1, -1);
-        LR(-1, -1);
-        LR(-2, 0);
-        LR(-1, -1);
-        LR(0, -1);
-        LR(4, 0);
-        MR(2, 4);
-        break;
-
-    case '6':
-        MR(1, -2);
-        LR(2, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-2, 0);
-        LR(-1, -1);
-        LR(0, -2);
-        LR(1, -1);
-        LR(2, 0);
-        MR(3, 4);
-        break;
-
-    case '7':
-        MR(0, -4);
-        LR(4, 0);
-        LR(0, 1);
-        LR(-2, 2);
-        LR(0, 1);
-        MR(4, 0);
-        break;
-
-    case '8':
-        MR(1, 0);
-        LR(2, 0);
-        LR(1, -1);
-        LR(-1, -1);
-        LR(-2, 0);
-        LR(-1, -1);
-        LR(1, -1);
-        LR(2, 0);
-        LR(1, 1);
-        MR(-4, 2);
-        LR(0, 0);
-        MR(6, 1);
-        break;
-
-    case '9':
-        MR(1, 0);
-        LR(2, 0);
-        LR(1, -1);
-        LR(0, -2);
-        LR(-1, -1);
-        LR(-2, 0);
-        LR(-1, 1);
-        LR(1, 1);
-        LR(2, 0);
-        MR(3, 2);
-        break;
-
-    case '-':
-        MR(0, -2), LR(3, 0);
-        MR(2, 2);
-        break;
-
-    case '+':
-        MR(0, -2);
-        LR(4, 0);
-        MR(-2, -2);
-        LR(0, 4);
-        MR(4, 0);
-        break;
-
-    case '.':
-        LR(0, 0);
-        MR(2, 0);
-        break;
-
-    case ',':
-        MR(0, 1);
-        LR(1, -1);
-        MR(2, 0);
-        break;
-
-    case ':':
-        MR(0, -1);
-        LR(0, 0);
-        MR(0, -2);
-        LR(0, 0);
-        MR(2, 3);
-        break;
-
-    case '&':
-        MR(0, -1);
-        LR(1, 1);
-        LR(1, 0);
-        LR(1, -1);
-        LR(1, 1);
-        LR(-2, -2);
-        LR(-1, 0);
-        LR(0, -1);
-        LR(1, -1);
-        LR(1, 1);
-        MR(3, 3);
-        break;
-
-    case ' ':
-        MR(3, 0);
-        break;
-
-    case '!':
-        LR(0, 0);
-        MR(0, -2);
-        LR(0, -2);
-        MR(2, 4);
-        break;
-
-    case '@':
-    case '#':
-        MR(1, 0);
-        LR(0, -4);
-        MR(-1, 1);
-        LR(4, 0);
-        MR(-1, -1);
-        LR(0, 4);
-        MR(1, -1);
-        LR(-4, 0);
-        MR(6, 1);
-        break;
-
-    case '%':
-        LR(4, -4);
-        MR(-3, 0);
-        LR(-1, 1);
-        LR(0, -1);
-        LR(4, 4);
-        LR(-1, 0);
-        LR(1, -1);
-        MR(2, 1);
-        break;
-
-    case '(':
-        MR(1, 0);
-        LR(-1, -1);
-        LR(0, -2);
-        LR(1, -1);
-        MR(2, 4);
-        break;
-
-    case ')':
-        LR(1, -1);
-        LR(0, -2);
-        LR(-1, -1);
-        MR(3, 4);
-        break;
-
-    case '/':
-        LR(4, -4);
-        MR(2, 4);
-        break;
-
-    case '<':
-        MR(4, -4);
-        LR(-2, 2);
-        LR(2, 2);
-        MR(2, 0);
-        break;
-
-    case '>':
-        MR(0, -4);
-        LR(2, 2);
-        LR(-2, 2);
-        MR(4, 0);
-        break;
-
-    case 0x27:
-        MR(0, -4);
-        LR(0, 1);
-        MR(2, 3);
-        break;
-
-    case '*':
-        MR(1, 0);
-        LR(0, -4);
-        MR(-1, 1);
-        LR(4, 0);
-        MR(-1, -1);
-        LR(0, 4);
-        MR(1, -1);
-        LR(-4, 0);
-        MR(6, 1);
-        break;
-
-    case '^':
-        MR(0, -3);
-        LR(1, -1);
-        LR(1, 0);
-        LR(1, 1);
-        MR(0, 3);
-        break;
-
-    case '?':
-        MR(0, -3);
-        LR(1, -1);
-        LR(2, 0);
-        LR(1, 1);
-        LR(-1, 1);
-        LR(-1, 0);
-        MR(0, 2);
-        LR(0, 0);
-        MR(4, 0);
-        break;
-
-    case 0x14:
-        LR(0, -4);
-        MR(2, 4);
-        break;
-
-    default:
-        break;
-    }
+    draw_glyphs(&chr, 1);
 }
 
 
@@ -841,94 +336,5 @@ void draw_character(char chr)
  */
 int TextDisplayLength(const char *str)
 {
-    unsigned int pixels = 0;
-    int count = (int) strlen(str);
-
-    for (int i = 0; i < count; i++) {
-
-        switch (toupper(str[i])) {
-        case 'A':
-        case 'B':
-        case 'C':
-        case 'D':
-        case 'E':
-        case 'F':
-        case 'G':
-        case 'H':
-        case 'J':
-        case 'K':
-        case 'L':
-        case 'M':
-        case 'N':
-        case 'O':
-        case 'P':
-        case 'Q':
-        case 'R':
-        case 'S':
-        case 'T':
-        case 'U':
-        case 'V':
-        case 'W':
-        case 'X':
-        case 'Y':
-        case 'Z':
-        case '0':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '+':
-        case '&':
-        case '@':
-        case '#':
-        case '%':
-        case '/':
-        case '<':
-        case '*':
-        case '?':
-            pixels += 6;
-            break;
-
-        case '-':
-            pixels += 5;
-            break;
-
-        case 'I':
-        case '1':
-        case '>':
-            pixels += 4;
-            break;
-
-        case ',':
-        case ' ':
-        case '(':
-        case ')':
-        case '^':  // 3-pixels, no trailing space
-            pixels += 3;
-            break;
-
-        case '.':
-        case ':':
-        case '!':
-        case 0x27:
-        case 0x14:
-            pixels += 2;
-            break;
-
-        default:
-            // Should a message be logged here?
-            break;
-        }
-    }
-
-    // Account for the pixel space after the last character.
-    if (count > 0 && str[count - 1] != '^') {
-        pixels -= 1;
-    }
-
-    return pixels;
+    return glyph_text_width(str);
 }
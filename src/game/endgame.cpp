@@ -37,6 +37,7 @@
 #include "place.h"
 #include "replay.h"
 #include "newmis.h"
+#include "options.h"
 #include "start.h"
 #include "mis_c.h"
 #include "sdlhelper.h"
@@ -1119,6 +1120,17 @@ void PlayFirst(char plr, char first)
     char i, w = 0, index;
     int Check = 0;
 
+    /* no one to show it to, but the firsts still count as shown */
+    if (options.headless) {
+        for (i = first; i < 28; i++) {
+            if (Data->Prestige[i].Place == plr && Data->PD[plr][i] == 0) {
+                Data->PD[plr][i] = 1;
+            }
+        }
+
+        return;
+    }
+
     FadeOut(2, 10, 0, 0);
     display::graphics.screen()->clear();
     music_start(M_LIFTOFF);
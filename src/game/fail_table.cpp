@@ -0,0 +1,235 @@
+// This file holds the mission step failure reports from FAILS.CDR
+
+#include "fail_table.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Buzz_inc.h"
+#include "endianness.h"
+#include "ioexception.h"
+#include "logging.h"
+
+
+LOG_DEFAULT_CATEGORY(mission)
+
+namespace
+{
+
+// FAILS.CDR starts with a count of 12-byte directory entries
+// (6-byte code, 32-bit offset, 16-bit size in bytes), followed by
+// blocks of 212-byte XFails records.
+const size_t FDT_SIZE = 6 + 4 + 2;
+const size_t XFAILS_SIZE = 4 + 2 + 2 + 2 + 2 + 200;
+
+typedef std::map<std::string, std::vector<struct XFails> > FailMap;
+
+struct ByPer {
+    bool operator()(const struct XFails &a, const struct XFails &b) const
+    {
+        return a.per < b.per;
+    }
+};
+
+const FailMap &FailTable();
+std::string FailKey(const char *code);
+FailMap LoadFails();
+};
+
+
+//----------------------------------------------------------------------
+// Header function definitions
+//----------------------------------------------------------------------
+
+
+/* Reads FAILS.CDR into memory, if it hasn't been already.
+ *
+ * This is called at startup so resolving mission steps never touches
+ * the disk; FindFailStat() will load the table itself otherwise.
+ *
+ * \throws IOException  if FAILS.CDR is missing or damaged.
+ */
+void LoadFailTable()
+{
+    FailTable();
+}
+
+
+/* Finds the failure report for a mission step.
+ *
+ * Each failure code has its own list of reports, kept sorted by
+ * XFails.per. For unmanned steps, rnum lies in [-5, -1] and picks the
+ * report whose per equals it. For manned steps, rnum lies in
+ * [0, 10000) and picks the first report whose per is greater.
+ * Both are binary searches, and give the same report as the old
+ * front-to-back scan of the file did.
+ *
+ * \param code  the step failure type; only the first 4 characters count.
+ * \param rnum  the roll selecting the report.
+ * \param stat  destination for the report (Not NULL). Left alone if
+ *              there is no report for the code.
+ * \return  true if stat was filled in.
+ * \throws IOException  if FAILS.CDR could not be loaded.
+ */
+bool FindFailStat(const char *code, int rnum, struct XFails *stat)
+{
+    const FailMap &table = FailTable();
+    FailMap::const_iterator fails = table.find(FailKey(code));
+
+    if (fails == table.end()) {
+        ERROR2("no failure reports for code `%.4s'", code);
+        return false;
+    }
+
+    const std::vector<struct XFails> &list = fails->second;
+    std::vector<struct XFails>::const_iterator it;
+    struct XFails key;
+
+    key.per = rnum;
+
+    if (rnum < 0) {
+        it = std::lower_bound(list.begin(), list.end(), key, ByPer());
+
+        if (it == list.end() || it->per != rnum) {
+            ERROR3("no unmanned failure %d for code `%.4s'", rnum, code);
+            return false;
+        }
+    } else {
+        it = std::upper_bound(list.begin(), list.end(), key, ByPer());
+
+        if (it == list.end()) {
+            WARNING3("failure roll %d is past the table for code `%.4s'",
+                     rnum, code);
+            --it;
+        }
+    }
+
+    *stat = *it;
+    return true;
+}
+
+
+//----------------------------------------------------------------------
+// Local definitions
+//----------------------------------------------------------------------
+
+namespace  // Start of local namespace
+{
+
+/* The failure reports, loaded on first use.
+ *
+ * The compiler guards initialization of the local static, so concurrent
+ * first calls load the file only once.
+ */
+const FailMap &FailTable()
+{
+    static const FailMap table(LoadFails());
+    return table;
+}
+
+
+/* Failure codes are matched on 4 characters, regardless of case.
+ */
+std::string FailKey(const char *code)
+{
+    std::string key;
+
+    for (int i = 0; i < 4 && code[i] != '\0'; i++) {
+        key += toupper(static_cast<unsigned char>(code[i]));
+    }
+
+    return key;
+}
+
+
+/* Reads and byte-swaps every record in FAILS.CDR.
+ */
+FailMap LoadFails()
+{
+    FailMap table;
+    FILE *fin = sOpen("FAILS.CDR", "rb", 0);
+
+    if (! fin) {
+        throw IOException("Error opening file FAILS.CDR");
+    }
+
+    std::vector<char> data;
+    char block[4096];
+    size_t n;
+
+    while ((n = fread(block, 1, sizeof(block), fin)) > 0) {
+        data.insert(data.end(), block, block + n);
+    }
+
+    fclose(fin);
+
+    int32_t count;
+
+    if (data.size() < sizeof(count)) {
+        throw IOException("Error reading from file FAILS.CDR");
+    }
+
+    memcpy(&count, &data[0], sizeof(count));
+    Swap32bit(count);
+
+    if (count <= 0 ||
+        data.size() < sizeof(count) + count * FDT_SIZE) {
+        throw IOException("Bad directory in file FAILS.CDR");
+    }
+
+    for (int i = 0; i < count; i++) {
+        const char *fdt = &data[sizeof(count) + i * FDT_SIZE];
+        int32_t offset;
+        int16_t size;
+
+        memcpy(&offset, fdt + 6, sizeof(offset));
+        Swap32bit(offset);
+        memcpy(&size, fdt + 10, sizeof(size));
+        Swap16bit(size);
+
+        if (offset < 0 || size < 0 ||
+            static_cast<size_t>(offset) + size > data.size()) {
+            throw IOException("Bad directory entry in file FAILS.CDR");
+        }
+
+        // Lookups always stopped at the first entry for a code
+        if (table.count(FailKey(fdt))) {
+            continue;
+        }
+
+        std::vector<struct XFails> &list = table[FailKey(fdt)];
+        const size_t end = static_cast<size_t>(offset) + size;
+
+        for (size_t pos = offset; pos + XFAILS_SIZE <= end;
+             pos += XFAILS_SIZE) {
+            const char *rec = &data[pos];
+            struct XFails fail;
+
+            memcpy(&fail.per, rec, 4);
+            memcpy(&fail.code, rec + 4, 2);
+            memcpy(&fail.val, rec + 6, 2);
+            memcpy(&fail.xtra, rec + 8, 2);
+            memcpy(&fail.fail, rec + 10, 2);
+            memcpy(&fail.text[0], rec + 12, sizeof(fail.text));
+            Swap32bit(fail.per);
+            Swap16bit(fail.code);
+            Swap16bit(fail.val);
+            Swap16bit(fail.xtra);
+            Swap16bit(fail.fail);
+            list.push_back(fail);
+        }
+
+        // Keep the file order among equal keys; the old scan returned
+        // the first match.
+        std::stable_sort(list.begin(), list.end(), ByPer());
+    }
+
+    return table;
+}
+
+};  // End of local namespace
@@ -0,0 +1,9 @@
+#ifndef FAIL_TABLE_H
+#define FAIL_TABLE_H
+
+struct XFails;
+
+void LoadFailTable();
+bool FindFailStat(const char *code, int rnum, struct XFails *stat);
+
+#endif // FAIL_TABLE_H
@@ -8,6 +8,7 @@
 
 #include "raceintospace_config.h"
 #include "filesystem.h"
+#include "image_cache.h"
 
 using boost::format;
 
@@ -185,6 +186,11 @@ void Filesystem::readToBuffer(const std::string &filename, void *buffer, uint32_
 }
 
 boost::shared_ptr<display::PalettizedSurface> Filesystem::readImage(const std::string &filename)
+{
+    return ImageCache::get(filename);
+}
+
+boost::shared_ptr<display::PalettizedSurface> Filesystem::decodeImage(const std::string &filename)
 {
     // open the file
     boost::shared_ptr<File> file_ptr(open(filename));
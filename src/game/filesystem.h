@@ -28,7 +28,13 @@ public:
     static boost::shared_ptr<File> openWrite(const std::string &filename);
 
     static void readToBuffer(const std::string &filename, void *buffer, uint32_t length, uint32_t offset = 0);
+
+    // Images come from ImageCache and are shared, so don't modify them
     static boost::shared_ptr<display::PalettizedSurface> readImage(const std::string &filename);
+
+    // Decode an image from disk, bypassing the cache
+    static boost::shared_ptr<display::PalettizedSurface> decodeImage(const std::string &filename);
+
     static void addPath(const char *s);
 };
 
@@ -31,6 +31,12 @@
 #include <errno.h>
 #include <ctype.h>
 
+#include <map>
+#include <set>
+#include <string>
+
+#include <SDL/SDL.h>
+
 /** path separator setup */
 #ifndef PATHSEP
 # if CONFIG_WIN32
@@ -59,6 +65,11 @@
 #include <dirent.h>
 #define NAMLEN(dirent) strlen((dirent)->d_name)
 
+/** fopen() ignores the case of file names here */
+#if defined(_WIN32) || defined(__APPLE__)
+# define FS_CASE_INSENSITIVE 1
+#endif
+
 LOG_DEFAULT_CATEGORY(filesys)
 
 static DIR *save_dir;
@@ -69,6 +80,47 @@ typedef struct file {
     char *path;     /**< path to file */
 } file;
 
+/*
+ * Lookups are cached below, and the caches are only used with
+ * cache_lock held, so files may be opened from any thread.
+ */
+
+static SDL_mutex *cache_lock;
+
+/*
+ * The lock is made by the first lookup, which happens at start-up,
+ * before there are other threads.
+ */
+static void
+lock_cache(void)
+{
+    if (!cache_lock) {
+        cache_lock = SDL_CreateMutex();
+    }
+
+    SDL_mutexP(cache_lock);
+}
+
+static void
+unlock_cache(void)
+{
+    SDL_mutexV(cache_lock);
+}
+
+/** names of the files in a directory, read once by scan_dir() */
+struct dir_listing {
+    bool readable;                  /**< false if opendir() failed */
+    std::set<std::string> names;    /**< lowercased if FS_CASE_INSENSITIVE */
+};
+
+static std::map<std::string, dir_listing> dir_index;
+
+/**
+ * Paths found by resolve_path(), per FT_* type and keyed by base/name.
+ * An empty path records that the file doesn't exist.
+ */
+static std::map<std::string, std::string> resolved[FT_SAVE_CHECK + 1];
+
 /**
  * gamedata & savedata access functions
  */
@@ -98,9 +150,18 @@ try_fopen(const char *fname, const char *mode)
     return fp;
 }
 
-/** try to open base/xxx/name for xxx = arg4 ... */
+static int
+is_write_mode(const char *mode)
+{
+    return strchr(mode, 'w')
+           || strchr(mode, 'a')
+           || strncmp(mode, "r+", 2) == 0;
+}
+
+/** try to open base/xxx/name for xxx in dirs */
 static file
-s_open_helper(const char *base, const char *name, const char *mode, ...)
+s_open_helper(const char *base, const char *name, const char *mode,
+              const char *const *dirs)
 {
     FILE *fh = NULL;
     file f = {NULL, NULL};
@@ -109,15 +170,13 @@ s_open_helper(const char *base, const char *name, const char *mode, ...)
     char *cooked = (char *)xmalloc(1024);
     size_t len = 1024, len2 = 0;
     size_t len_base = strlen(base), len_name = strlen(name);
-    va_list ap;
 
     assert(base);
     assert(name);
     assert(mode);
+    assert(dirs);
 
-    va_start(ap, mode);
-
-    for (p = va_arg(ap, char *); p; p = va_arg(ap, char *)) {
+    for (; (p = (char *) *dirs) != NULL; ++dirs) {
         char *s = NULL;
         int was_upper = 0;
         size_t len_p = strlen(p);
@@ -160,7 +219,6 @@ s_open_helper(const char *base, const char *name, const char *mode, ...)
     }
 
     serrno = errno;
-    va_end(ap);
 
     if (fh) {
         f.handle = fh;
@@ -173,6 +231,183 @@ s_open_helper(const char *base, const char *name, const char *mode, ...)
     return f;
 }
 
+static std::string
+lowercase(const std::string &s)
+{
+    std::string lower(s);
+
+    for (size_t i = 0; i < lower.size(); ++i) {
+        lower[i] = tolower((unsigned char) lower[i]);
+    }
+
+    return lower;
+}
+
+/** list a directory, reading it only the first time */
+static const dir_listing &
+scan_dir(const std::string &dir)
+{
+    std::map<std::string, dir_listing>::iterator it = dir_index.find(dir);
+    DIR *dp;
+    struct dirent *ent;
+
+    if (it != dir_index.end()) {
+        return it->second;
+    }
+
+    dir_listing &listing = dir_index[dir];
+    listing.readable = false;
+
+    if ((dp = opendir(dir.c_str())) == NULL) {
+        TRACE2("can't list directory `%s', will probe it", dir.c_str());
+        return listing;
+    }
+
+    listing.readable = true;
+
+    while ((ent = readdir(dp)) != NULL) {
+#ifdef FS_CASE_INSENSITIVE
+        listing.names.insert(lowercase(ent->d_name));
+#else
+        listing.names.insert(ent->d_name);
+#endif
+    }
+
+    closedir(dp);
+    TRACE3("indexed %u files in `%s'",
+           (unsigned) listing.names.size(), dir.c_str());
+
+    return listing;
+}
+
+/** check the file exists without opening it */
+static bool
+file_exists(const std::string &path)
+{
+    struct stat st;
+
+    return stat(path.c_str(), &st) == 0;
+}
+
+/**
+ * Find which of base/xxx/name for xxx in dirs exists, trying the name
+ * as given and then lowercased, like s_open_helper().
+ *
+ * Directory listings are used where possible so missing files cost no
+ * system calls; names with a path in them, or directories that can't
+ * be listed, are checked with stat().
+ *
+ * \return the path, or an empty string if there is no such file
+ */
+static std::string
+resolve_path(const char *base, const char *name, const char *const *dirs)
+{
+    std::string lower = lowercase(name);
+    bool nested = strchr(name, '/') != NULL;
+
+    for (; *dirs; ++dirs) {
+        std::string dir(base);
+
+        if (**dirs) {
+            dir += "/";
+            dir += *dirs;
+        }
+
+        const dir_listing &listing = scan_dir(dir);
+
+        if (!listing.readable || nested) {
+            if (file_exists(dir + "/" + name)) {
+                return dir + "/" + name;
+            }
+
+            if (lower != name && file_exists(dir + "/" + lower)) {
+                return dir + "/" + lower;
+            }
+
+            continue;
+        }
+
+#ifdef FS_CASE_INSENSITIVE
+
+        if (listing.names.count(lower)) {
+            return dir + "/" + name;
+        }
+
+#else
+
+        if (listing.names.count(name)) {
+            return dir + "/" + name;
+        }
+
+        if (listing.names.count(lower)) {
+            return dir + "/" + lower;
+        }
+
+#endif
+    }
+
+    return std::string();
+}
+
+/**
+ * Open a file for reading through the resolved path cache.
+ *
+ * The first lookup of a name resolves it with resolve_path(); later ones
+ * open the remembered path straight away, or fail at once if the file
+ * wasn't there. If a remembered file has gone away since, we fall back to
+ * probing every location again.
+ */
+static file
+find_file(const char *base, const char *name, const char *mode, int type,
+          const char *const *dirs)
+{
+    file f = {NULL, NULL};
+    std::map<std::string, std::string> &paths = resolved[type];
+    std::string key = std::string(base) + "/" + name;
+    std::map<std::string, std::string>::iterator it = paths.find(key);
+
+    if (it == paths.end()) {
+        it = paths.insert(std::make_pair(key, resolve_path(base, name, dirs))).first;
+    }
+
+    if (it->second.empty()) {
+        errno = ENOENT;
+        return f;
+    }
+
+    TRACE3("trying to open `%s' (mode %s)", it->second.c_str(), mode);
+    f.handle = fopen(it->second.c_str(), mode);
+
+    if (!f.handle) {
+        paths.erase(it);
+        return s_open_helper(base, name, mode, dirs);
+    }
+
+    f.path = xstrdup(it->second.c_str());
+    return f;
+}
+
+/** forget what we know about the savegame directory */
+static void
+invalidate_save_paths(void)
+{
+    dir_index.erase(options.dir_savegame);
+    resolved[FT_SAVE].clear();
+    resolved[FT_SAVE_CHECK].clear();
+}
+
+/* where each FT_* type of file may live, relative to its base directory */
+static const char *const data_dirs[] = {"gamedata", NULL};
+static const char *const save_dirs[] = {"", NULL};
+static const char *const audio_dirs[] = {
+    "audio/mission", "audio/music", "audio/news", "audio/sounds", NULL
+};
+static const char *const video_dirs[] = {
+    "video/mission", "video/news", "video/training", NULL
+};
+static const char *const image_dirs[] = {"images", NULL};
+static const char *const midi_dirs[] = {"audio/midi", "midi", "audio/music", NULL};
+
 /** tries to find a file and open it
  *
  * The function knows about the relative
@@ -194,14 +429,14 @@ try_find_file(const char *name, const char *mode, int type)
     char *sd = options.dir_savegame;
     char *where = "";
     const char *newmode = mode;
+    const char *base = NULL;
+    const char *const *dirs = NULL;
 
     DEBUG2("looking for file `%s'", name);
 
     /** \note allows write access only to savegame files */
     if (type != FT_SAVE) {
-        if (strchr(mode, 'w')
-            || strchr(mode, 'a')
-            || strncmp(mode, "r+", 2) == 0) {
+        if (is_write_mode(mode)) {
             char *inner_newmode;
 
             if (strchr(mode, 'b')) {
@@ -216,59 +451,62 @@ try_find_file(const char *name, const char *mode, int type)
 
     switch (type) {
     case FT_DATA:
-        f = s_open_helper(gd, name, newmode,
-                          "gamedata",
-                          NULL);
+        base = gd;
+        dirs = data_dirs;
         where = "game data";
         break;
 
     case FT_SAVE:
     case FT_SAVE_CHECK:
-        f = s_open_helper(sd, name, newmode,
-                          "",
-                          NULL);
+        base = sd;
+        dirs = save_dirs;
         where = "savegame";
         break;
 
     case FT_AUDIO:
-        f = s_open_helper(gd, name, newmode,
-                          "audio/mission",
-                          "audio/music",
-                          "audio/news",
-                          "audio/sounds",
-                          NULL);
+        base = gd;
+        dirs = audio_dirs;
         where = "audio";
         break;
 
     case FT_VIDEO:
-        f = s_open_helper(gd, name, newmode,
-                          "video/mission",
-                          "video/news",
-                          "video/training",
-                          NULL);
+        base = gd;
+        dirs = video_dirs;
         where = "video";
         break;
 
     case FT_IMAGE:
-        f = s_open_helper(gd, name, newmode,
-                          "images",
-                          NULL);
+        base = gd;
+        dirs = image_dirs;
         where = "image";
         break;
 
     case FT_MIDI:
-        f = s_open_helper(gd, name, newmode,
-                          "audio/midi",
-                          "midi",
-                          "audio/music",
-                          NULL);
+        base = gd;
+        dirs = midi_dirs;
         where = "midi";
         break;
 
     default:
         assert("Unknown FT_* specified");
+        return f;
     }
 
+    lock_cache();
+
+    /* only savegame files are written; write through and start over */
+    if (is_write_mode(newmode)) {
+        f = s_open_helper(base, name, newmode, dirs);
+
+        if (type == FT_SAVE || type == FT_SAVE_CHECK) {
+            invalidate_save_paths();
+        }
+    } else {
+        f = find_file(base, name, newmode, type, dirs);
+    }
+
+    unlock_cache();
+
     if (f.handle == NULL && type != FT_SAVE_CHECK) {
         int serrno = errno;
         WARNING3("can't find file `%s' in %s dir(s)", name, where);
@@ -319,6 +557,9 @@ remove_savedat(const char *name)
     INFO2("removing save game file `%s'", cooked);
     fix_pathsep(cooked);
     rv = remove(cooked);
+    lock_cache();
+    invalidate_save_paths();
+    unlock_cache();
 
     if (rv < 0 && errno != ENOENT)
         WARNING3("failed to remove save game file `%s': %s",
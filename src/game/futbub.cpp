@@ -49,17 +49,23 @@ namespace
 struct StepInfo {
     int16_t x_cor;
     int16_t y_cor;
-} StepBub[MAXBUB];
+};
+GAME_LOCAL struct StepInfo StepBub[MAXBUB];
+GAME_LOCAL_RESET(StepBub);
 
 
-int Bub_Num;
-int bubCount;
+GAME_LOCAL int Bub_Num;
+GAME_LOCAL int bubCount;
+GAME_LOCAL_RESET(Bub_Num);
+GAME_LOCAL_RESET(bubCount);
 // SEG determines the number of control points used in creating
 // the B-splines for drawing the mission flight path.
 // The more control points, the smoother the path should
 // appear.
-int SEG = 15;
-char missStep[1024];
+GAME_LOCAL int SEG = 15;
+GAME_LOCAL char missStep[1024];
+GAME_LOCAL_RESET(SEG);
+GAME_LOCAL_RESET(missStep);
 
 
 static inline char B_Mis(char x)
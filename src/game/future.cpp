@@ -75,8 +75,13 @@ enum FMFields {
 
 // TODO: Localize these. Too many global/file global variables.
 
-bool JointFlag, MarsFlag, JupiterFlag, SaturnFlag;
-display::LegacySurface *vh;
+GAME_LOCAL bool JointFlag, MarsFlag, JupiterFlag, SaturnFlag;
+GAME_LOCAL display::LegacySurface *vh;
+GAME_LOCAL_RESET(JointFlag);
+GAME_LOCAL_RESET(MarsFlag);
+GAME_LOCAL_RESET(JupiterFlag);
+GAME_LOCAL_RESET(SaturnFlag);
+GAME_LOCAL_RESET(vh);
 // missionData is used in SetParameters, PianoKey, UpSearchRout,
 // DownSearchRout, and Future.
 std::vector<struct mStr> missionData;
@@ -0,0 +1,115 @@
+// This file keeps the state of a game apart from other games played by
+// other threads.
+
+#include "game_context.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Buzz_inc.h"
+#include "game_main.h"
+#include "utils.h"
+
+#include <vector>
+
+namespace
+{
+
+/* a registered #GAME_LOCAL, and its value when the program started */
+struct GameLocal {
+    void *(*address)(void);
+    size_t size;
+    void *initial;
+};
+
+/* filled in before main(), and only read after */
+std::vector<GameLocal> &GameLocals()
+{
+    static std::vector<GameLocal> locals;
+    return locals;
+}
+
+};  // End of local namespace
+
+GameLocalReset::GameLocalReset(void *(*address)(void), size_t size)
+{
+    GameLocal local;
+
+    local.address = address;
+    local.size = size;
+    local.initial = xmalloc(size);
+    memcpy(local.initial, address(), size);
+    GameLocals().push_back(local);
+}
+
+/** Allocate the memory of a game. */
+void
+game_context_init(struct GameContext *ctx)
+{
+    assert(ctx);
+
+    ctx->data = (struct Players *)xcalloc(1, sizeof(struct Players) + 1);
+    ctx->buffer = (char *)xcalloc(1, BUFFER_SIZE);
+}
+
+/**
+ * Make a context the game of the calling thread, which Data and buffer
+ * of the thread then point to.
+ */
+void
+game_context_bind(struct GameContext *ctx)
+{
+    assert(ctx);
+
+    Data = ctx->data;
+    buffer = ctx->buffer;
+}
+
+/**
+ * Start a new game in a context, on the calling thread: every #GAME_LOCAL
+ * of the thread goes back to its initial value, the memory of the context
+ * is cleared and the context is bound.  Nothing of the game the thread
+ * played before is left, so one thread can play game after game.
+ */
+void
+game_context_reset(struct GameContext *ctx)
+{
+    std::vector<GameLocal> &locals = GameLocals();
+
+    assert(ctx);
+
+    free(interimData.endTurnBuffer);
+    free(interimData.eventBuffer);
+
+    for (size_t i = 0; i < locals.size(); i++) {
+        memcpy(locals[i].address(), locals[i].initial, locals[i].size);
+    }
+
+    memset(ctx->data, 0, sizeof(struct Players) + 1);
+    memset(ctx->buffer, 0, BUFFER_SIZE);
+    game_context_bind(ctx);
+}
+
+/**
+ * Free the memory of a game, on the thread it is bound to, including what
+ * the game allocated while being played.
+ */
+void
+game_context_free(struct GameContext *ctx)
+{
+    assert(ctx);
+
+    if (Data == ctx->data) {
+        free(interimData.endTurnBuffer);
+        free(interimData.eventBuffer);
+        memset(&interimData, 0, sizeof(interimData));
+        Data = NULL;
+        buffer = NULL;
+    }
+
+    free(ctx->data);
+    free(ctx->buffer);
+    ctx->data = NULL;
+    ctx->buffer = NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef GAME_CONTEXT_H
+#define GAME_CONTEXT_H
+
+/**
+ * \file game_context.h The state of one game, kept apart per thread.
+ *
+ * The turn, AI and mission code keep the game in progress in globals
+ * such as Data, Mev, STEP and AI[].  Those declared #GAME_LOCAL have a
+ * copy of their own in every thread, so each thread can play a separate
+ * game.  A GameContext holds the memory a game allocates, and
+ * game_context_bind() points the globals of the calling thread at it.
+ *
+ * Every #GAME_LOCAL is registered with GAME_LOCAL_RESET() next to its
+ * definition, so game_context_reset() can put all of them back to their
+ * initial values.  That is how a new game is started, on any thread,
+ * without seeing what an earlier game left behind (Alt_A, manOnMoon,
+ * pNeg...).
+ *
+ * Everything else a game touches is either read-only once loaded (the
+ * fail table, mission plans, options), guarded, like file lookups, or
+ * only used by screens a computer player never opens, like the
+ * spaceport and the save screen.  Non-POD state can't be #GAME_LOCAL;
+ * #HelpCode stands in for the std::string the help pages were named by.
+ */
+
+#include <stddef.h>
+
+/** storage class of per-game globals: one instance per thread */
+#if defined(_MSC_VER)
+# define GAME_LOCAL __declspec(thread)
+#else
+# define GAME_LOCAL __thread
+#endif
+
+/**
+ * Register a #GAME_LOCAL with game_context_reset(), at file scope just
+ * after its definition.  Its initial value is taken when the program
+ * starts, so no static constructor may change it before then.
+ */
+#define GAME_LOCAL_RESET(var) \
+    static void *var##_game_local(void) { return (void *)&var; } \
+    static const GameLocalReset var##_game_local_reset(var##_game_local, \
+                                                       sizeof(var))
+
+/** what GAME_LOCAL_RESET() registers a #GAME_LOCAL with */
+class GameLocalReset
+{
+public:
+    GameLocalReset(void *(*address)(void), size_t size);
+};
+
+struct Players;
+
+struct GameContext {
+    struct Players *data;   /**< bound to Data */
+    char *buffer;           /**< bound to buffer, BUFFER_SIZE bytes */
+};
+
+void game_context_init(struct GameContext *ctx);
+void game_context_bind(struct GameContext *ctx);
+void game_context_reset(struct GameContext *ctx);
+void game_context_free(struct GameContext *ctx);
+
+#endif /* GAME_CONTEXT_H */
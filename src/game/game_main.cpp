@@ -47,6 +47,7 @@
 #include "intro.h"
 #include "mc.h"
 #include "mis_c.h"
+#include "mission_util.h"
 #include "museum.h"
 #include "newmis.h"
 #include "news.h"
@@ -62,7 +63,11 @@
 #include "gr.h"
 #include "crash.h"
 #include "endianness.h"
+#include "fail_table.h"
+#include "image_cache.h"
+#include "prefetch.h"
 #include "crew.h"
+#include "rng.h"
 
 #ifdef CONFIG_MACOSX
 // SDL.h needs to be included here to replace the original main() with
@@ -70,37 +75,66 @@
 #include <SDL.h>
 #endif
 
-char Name[20];
-struct Players *Data;
-int x;
-int y;
-int mousebuttons;
-int key;
-int oldx;
-int oldy;
-unsigned char LOAD;
-unsigned char QUIT;
-unsigned char HARD1;
-unsigned char UNIT1;
-unsigned char FADE;
-unsigned char AL_CALL;
-char plr[NUM_PLAYERS];
-std::string helpText;
-std::string keyHelpText;
-char IDLE[2];
-char *buffer;
-char pNeg[NUM_PLAYERS][MAX_MISSIONS];
-int32_t xMODE;
-char MAIL = -1;
-char Option = -1;
-int fOFF = -1;
+GAME_LOCAL char Name[20];
+GAME_LOCAL struct Players *Data;
+GAME_LOCAL int x;
+GAME_LOCAL int y;
+GAME_LOCAL int mousebuttons;
+GAME_LOCAL int key;
+GAME_LOCAL int oldx;
+GAME_LOCAL int oldy;
+GAME_LOCAL unsigned char LOAD;
+GAME_LOCAL unsigned char QUIT;
+GAME_LOCAL unsigned char HARD1;
+GAME_LOCAL unsigned char UNIT1;
+GAME_LOCAL unsigned char FADE;
+GAME_LOCAL unsigned char AL_CALL;
+GAME_LOCAL char plr[NUM_PLAYERS];
+GAME_LOCAL struct HelpCode helpText;
+GAME_LOCAL struct HelpCode keyHelpText;
+GAME_LOCAL char IDLE[2];
+GAME_LOCAL char *buffer;
+GAME_LOCAL char pNeg[NUM_PLAYERS][MAX_MISSIONS];
+GAME_LOCAL int32_t xMODE;
+GAME_LOCAL char MAIL = -1;
+GAME_LOCAL char Option = -1;
+GAME_LOCAL int fOFF = -1;
+GAME_LOCAL_RESET(Name);
+GAME_LOCAL_RESET(Data);
+GAME_LOCAL_RESET(x);
+GAME_LOCAL_RESET(y);
+GAME_LOCAL_RESET(mousebuttons);
+GAME_LOCAL_RESET(key);
+GAME_LOCAL_RESET(oldx);
+GAME_LOCAL_RESET(oldy);
+GAME_LOCAL_RESET(LOAD);
+GAME_LOCAL_RESET(QUIT);
+GAME_LOCAL_RESET(HARD1);
+GAME_LOCAL_RESET(UNIT1);
+GAME_LOCAL_RESET(FADE);
+GAME_LOCAL_RESET(AL_CALL);
+GAME_LOCAL_RESET(plr);
+GAME_LOCAL_RESET(helpText);
+GAME_LOCAL_RESET(keyHelpText);
+GAME_LOCAL_RESET(IDLE);
+GAME_LOCAL_RESET(buffer);
+GAME_LOCAL_RESET(pNeg);
+GAME_LOCAL_RESET(xMODE);
+GAME_LOCAL_RESET(MAIL);
+GAME_LOCAL_RESET(Option);
+GAME_LOCAL_RESET(fOFF);
 // true for fullscreen mission playback, false otherwise
-bool fullscreenMissionPlayback;
-char manOnMoon = 0;
-char dayOnMoon = 20;
-char AI[2] = {0, 0};
+GAME_LOCAL bool fullscreenMissionPlayback;
+GAME_LOCAL char manOnMoon = 0;
+GAME_LOCAL char dayOnMoon = 20;
+GAME_LOCAL char AI[2] = {0, 0};
+GAME_LOCAL_RESET(fullscreenMissionPlayback);
+GAME_LOCAL_RESET(manOnMoon);
+GAME_LOCAL_RESET(dayOnMoon);
+GAME_LOCAL_RESET(AI);
 // Used to hold mid-turn save game related information
-INTERIMDATA interimData;
+GAME_LOCAL INTERIMDATA interimData;
+GAME_LOCAL_RESET(interimData);
 
 char *S_Name[] = {
     "LAUNCH",
@@ -148,12 +182,9 @@ void Rout_Debug(int line, char *file);
 void RestoreDir(void);
 int CheckIfMissionGo(char plr, char launchIdx);
 void oclose(int fil);
-void InitData(void);
 void MMainLoop(void);
 void Progress(char mode);
-void MainLoop(void);
 void DockingKludge(void);
-void OpenEmUp(void);
 void CloseEmUp(unsigned char error, unsigned int value);
 void VerifyCrews(char plr);
 
@@ -181,6 +212,7 @@ int game_main_impl(int argc, char *argv[])
     Filesystem::addPath(options.dir_savegame);
     /* hacking... */
     log_setThreshold(&_LOGV(LOG_ROOT_CAT), MAX(0, LP_NOTICE - (int)options.want_debug));
+    ImageCache::init(options.image_cache_kb * 1024, prefetch_load_image);
 
     fin = open_gamedat("USA_PORT.DAT");
 
@@ -194,6 +226,8 @@ int game_main_impl(int argc, char *argv[])
 
     fclose(fin);
 
+    LoadFailTable();              // FAILS.CDR, for resolving mission steps
+
     if (create_save_dir() != 0) {
         CRITICAL3("can't create save directory `%s': %s",
                   options.dir_savegame, strerror(errno));
@@ -539,9 +573,20 @@ restart:                              // ON A LOAD PROG JUMPS TO HERE
             }
 
             if (!AI[i]) {
+                // The newscast opens and closes with these
+                for (j = 0; j < 2; j++) {
+                    char voice[16];
+
+                    snprintf(voice, sizeof(voice), "%s_%03d.ogg",
+                             (plr[i] ? "sov" : "usa"), j);
+                    prefetch_audio(voice, PREFETCH_NEXT);
+                }
+
                 NextTurn(plr[i]);
                 VerifySF(plr[i]);
+                prefetch_screen_begin("News");
                 News(plr[i]);                  // EVENT FOR PLAYER
+                prefetch_screen_end();
 
                 if ((Data->P[plr[i] % NUM_PLAYERS].Mission[0].MissionCode > 6 ||
                      Data->P[plr[i] % NUM_PLAYERS].Mission[1].MissionCode > 6 ||
@@ -568,13 +613,19 @@ restart:                              // ON A LOAD PROG JUMPS TO HERE
                     goto restart;    // TEST FOR LOAD
                 }
             } else {
-                AI_Begin(plr[i] - 2); // Turns off Mouse for AI
-                GetMouse();
+                if (!options.headless) {
+                    AI_Begin(plr[i] - 2); // Turns off Mouse for AI
+                    GetMouse();
+                }
+
                 VerifySF(plr[i] - 2);
                 AIEvent(plr[i] - 2);
                 VerifySF(plr[i] - 2);
                 AIMaster(plr[i] - 2);
-                AI_Done(); // Fade Out AI Thinking Screen and Restores Mouse
+
+                if (!options.headless) {
+                    AI_Done(); // Fade Out AI Thinking Screen and Restores Mouse
+                }
             }
 
             Data->Count++;
@@ -618,9 +669,12 @@ restart:                              // ON A LOAD PROG JUMPS TO HERE
                             }
 
                         if (Data->Prestige[Prestige_MannedLunarLanding].Place != -1) {
-                            UpdateRecords(1);
-                            NewEnd(Data->Prestige[Prestige_MannedLunarLanding].Place, Order[i].loc);
-                            FadeOut(2, 10, 0, 0);
+                            if (!options.headless) {
+                                UpdateRecords(1);
+                                NewEnd(Data->Prestige[Prestige_MannedLunarLanding].Place, Order[i].loc);
+                                FadeOut(2, 10, 0, 0);
+                            }
+
                             return;
                         }
 
@@ -637,8 +691,11 @@ restart:                              // ON A LOAD PROG JUMPS TO HERE
 
         if (Data->Year == 77 && Data->Season == 1 && Data->Prestige[Prestige_MannedLunarLanding].Place == -1) {
             // nobody wins .....
-            SpecialEnd();
-            FadeOut(2, 10, 0, 0);
+            if (!options.headless) {
+                SpecialEnd();
+                FadeOut(2, 10, 0, 0);
+            }
+
             return;
         }
 
@@ -695,6 +752,10 @@ restart:                              // ON A LOAD PROG JUMPS TO HERE
         newTurn = true;
     }
 
+    if (options.headless) {
+        return;
+    }
+
     FadeOut(2, 10, 0, 0);
 
     Museum(0);
@@ -881,8 +942,8 @@ void VerifyCrews(char plr)
 /* Reads mission data for the specified mission into the global
  * variable Mis.
  *
- * Opens "MISSION.DAT" to find mission data. Global variable Mis
- * defined in mc.cpp.
+ * The data comes from the MISSION.DAT table kept by GetMissionPlan().
+ * Global variable Mis defined in mc.cpp.
  *
  * \param mcode Code of the mission - works as index for the file
  *
@@ -891,26 +952,11 @@ void VerifyCrews(char plr)
  */
 void GetMisType(char mcode)
 {
-    FILE *fin;
-    /** \todo Missing assert for opening file? */
-    fin = sOpen("MISSION.DAT", "rb", 0);
-    fseek(fin, mcode * (sizeof Mis), SEEK_SET); // Find Mission Type
-    fread(&Mis, sizeof Mis, 1, fin);         // Get new Mission Info
-    fclose(fin);
+    Mis = GetMissionPlan(mcode);
 }
 
 
 int MisRandom(void)
 {
-    int i, nval;
-
-    do {
-        nval = 107;
-
-        for (i = 0; i < 250; i++) {
-            nval += (brandom(7) - 3);
-        }
-    } while (nval < 50 || nval > 150);
-
-    return nval - 50;
+    return rng_bell(&game_rng);
 }
@@ -1,13 +1,40 @@
 #ifndef GAME_MAIN_H
 #define GAME_MAIN_H
 
-#include <string>
+#include <string.h>
+
+#include "game_context.h"
 
 namespace display
 {
 class LegacySurface;
 };
 
+/**
+ * The name of a help page, such as "i702".  It has no constructor, so
+ * it can be #GAME_LOCAL.
+ */
+struct HelpCode {
+    char code[8];
+
+    HelpCode &operator=(const char *s)
+    {
+        strncpy(code, s, sizeof(code) - 1);
+        code[sizeof(code) - 1] = '\0';
+        return *this;
+    }
+
+    const char *c_str() const
+    {
+        return code;
+    }
+
+    char &operator[](size_t i)
+    {
+        return code[i];
+    }
+};
+
 void WaitForMouseUp(void);
 void GetMisType(char mcode);
 void GetMouse(void);
@@ -17,35 +44,37 @@ int MisRandom(void);
 void DestroyPad(char plr, char pad, int cost, char mode);
 void PauseMouse(void);
 void GetMouse_fast(void);
+void InitData(void);
+void MainLoop(void);
 
-extern char Option;
-extern char MAIL;
-extern int fOFF;
-extern char AI[2];
-extern char manOnMoon;
-extern char dayOnMoon;
-extern bool fullscreenMissionPlayback;
-extern char pNeg[NUM_PLAYERS][MAX_MISSIONS];
-extern unsigned char AL_CALL;
-extern std::string helpText;
-extern std::string keyHelpText;
-extern int oldx;
-extern int oldy;
-extern unsigned char HARD1;
-extern unsigned char UNIT1;
-extern unsigned char LOAD;
-extern unsigned char QUIT;
-extern unsigned char FADE;
-extern char plr[NUM_PLAYERS];
-extern struct Players *Data;
-extern int x;
-extern int y;
-extern int mousebuttons;
-extern int key;
-extern char Name[20];
-extern char *buffer;
-extern int32_t xMODE;
+extern GAME_LOCAL char Option;
+extern GAME_LOCAL char MAIL;
+extern GAME_LOCAL int fOFF;
+extern GAME_LOCAL char AI[2];
+extern GAME_LOCAL char manOnMoon;
+extern GAME_LOCAL char dayOnMoon;
+extern GAME_LOCAL bool fullscreenMissionPlayback;
+extern GAME_LOCAL char pNeg[NUM_PLAYERS][MAX_MISSIONS];
+extern GAME_LOCAL unsigned char AL_CALL;
+extern GAME_LOCAL struct HelpCode helpText;
+extern GAME_LOCAL struct HelpCode keyHelpText;
+extern GAME_LOCAL int oldx;
+extern GAME_LOCAL int oldy;
+extern GAME_LOCAL unsigned char HARD1;
+extern GAME_LOCAL unsigned char UNIT1;
+extern GAME_LOCAL unsigned char LOAD;
+extern GAME_LOCAL unsigned char QUIT;
+extern GAME_LOCAL unsigned char FADE;
+extern GAME_LOCAL char plr[NUM_PLAYERS];
+extern GAME_LOCAL struct Players *Data;
+extern GAME_LOCAL int x;
+extern GAME_LOCAL int y;
+extern GAME_LOCAL int mousebuttons;
+extern GAME_LOCAL int key;
+extern GAME_LOCAL char Name[20];
+extern GAME_LOCAL char *buffer;
+extern GAME_LOCAL int32_t xMODE;
 extern char *S_Name[];
-extern INTERIMDATA interimData;
+extern GAME_LOCAL INTERIMDATA interimData;
 
 #endif // GAME_MAIN_H
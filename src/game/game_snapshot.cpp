@@ -0,0 +1,327 @@
+// This file copies the game in progress to memory and back, for undo and
+// for trying moves out without touching the file system.
+
+#include "game_snapshot.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Buzz_inc.h"
+#include "game_main.h"
+#include "utils.h"
+
+struct snapshot_field {
+    const char *name;
+    size_t offset;
+    size_t size;
+};
+
+#define FIELD(type, member) \
+    { #member, offsetof(type, member), sizeof(((type *)0)->member) }
+
+/* members of Players that diff() reports on, apart from P */
+static const struct snapshot_field players_fields[] = {
+    FIELD(struct Players, BUZZ),
+    FIELD(struct Players, Checksum),
+    FIELD(struct Players, plr),
+    FIELD(struct Players, Def),
+    FIELD(struct Players, Year),
+    FIELD(struct Players, Season),
+    FIELD(struct Players, Prestige),
+    FIELD(struct Players, Events),
+    FIELD(struct Players, Count),
+    FIELD(struct Players, PD),
+    FIELD(struct Players, Mile),
+};
+
+/* members of each side's BuzzData, leaving out the unused ones */
+static const struct snapshot_field buzz_fields[] = {
+    FIELD(struct BuzzData, Header),
+    FIELD(struct BuzzData, Name),
+    FIELD(struct BuzzData, Cash),
+    FIELD(struct BuzzData, Budget),
+    FIELD(struct BuzzData, Prestige),
+    FIELD(struct BuzzData, PrestHist),
+    FIELD(struct BuzzData, PresRev),
+    FIELD(struct BuzzData, tempPrestige),
+    FIELD(struct BuzzData, BudgetHistory),
+    FIELD(struct BuzzData, BudgetHistoryF),
+    FIELD(struct BuzzData, Spend),
+    FIELD(struct BuzzData, RD_Mods_For_Turn),
+    FIELD(struct BuzzData, RD_Mods_For_Year),
+    FIELD(struct BuzzData, TurnOnly),
+    FIELD(struct BuzzData, Plans),
+    FIELD(struct BuzzData, FuturePlans),
+    FIELD(struct BuzzData, DurationLevel),
+    FIELD(struct BuzzData, LMpts),
+    FIELD(struct BuzzData, Probe),
+    FIELD(struct BuzzData, Rocket),
+    FIELD(struct BuzzData, Manned),
+    FIELD(struct BuzzData, Misc),
+    FIELD(struct BuzzData, DockingModuleInOrbit),
+    FIELD(struct BuzzData, LaunchFacility),
+    FIELD(struct BuzzData, AstroCount),
+    FIELD(struct BuzzData, AstroLevel),
+    FIELD(struct BuzzData, AstroDelay),
+    FIELD(struct BuzzData, Pool),
+    FIELD(struct BuzzData, Udp),
+    FIELD(struct BuzzData, IntelHardwareTable),
+    FIELD(struct BuzzData, CrewCount),
+    FIELD(struct BuzzData, Crew),
+    FIELD(struct BuzzData, FemaleAstronautsAllowed),
+    FIELD(struct BuzzData, Mission),
+    FIELD(struct BuzzData, Block),
+    FIELD(struct BuzzData, Future),
+    FIELD(struct BuzzData, History),
+    FIELD(struct BuzzData, PastMissionCount),
+    FIELD(struct BuzzData, MissionCatastrophicFailureOnTurn),
+    FIELD(struct BuzzData, Buy),
+    FIELD(struct BuzzData, eCount),
+    FIELD(struct BuzzData, PastIntel),
+    FIELD(struct BuzzData, AIStrategy),
+    FIELD(struct BuzzData, AILunar),
+    FIELD(struct BuzzData, AIPrim),
+    FIELD(struct BuzzData, AISec),
+    FIELD(struct BuzzData, AIStat),
+    FIELD(struct BuzzData, BadCardEventFlag),
+    FIELD(struct BuzzData, Port),
+};
+
+/* the rest of the snapshot */
+static const struct snapshot_field snapshot_fields[] = {
+    FIELD(struct game_snapshot, rng),
+    FIELD(struct game_snapshot, plr),
+    FIELD(struct game_snapshot, AI),
+    FIELD(struct game_snapshot, manOnMoon),
+    FIELD(struct game_snapshot, dayOnMoon),
+};
+
+/* copy into a buffer of the snapshot, which only ever grows */
+static char *
+copy_buffer(char *dest, uint32_t *room, const char *src, uint32_t size)
+{
+    if (size > *room) {
+        free(dest);
+        dest = (char *)xmalloc(size);
+        *room = size;
+    }
+
+    if (size) {
+        memcpy(dest, src, size);
+    }
+
+    return dest;
+}
+
+/* copy a snapshot buffer back into one of interimData, sized to fit */
+static char *
+restore_buffer(char *dest, uint32_t dest_size, const char *src, uint32_t size)
+{
+    if (size != dest_size) {
+        dest = (char *)xrealloc(dest, size ? size : 1);
+    }
+
+    if (size) {
+        memcpy(dest, src, size);
+    }
+
+    return dest;
+}
+
+static int
+diff_fields(const char *a, const char *b,
+            const struct snapshot_field *fields, size_t count, int player,
+            std::vector<struct snapshot_change> *changes)
+{
+    int found = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (memcmp(a + fields[i].offset, b + fields[i].offset,
+                   fields[i].size) != 0) {
+            if (changes) {
+                struct snapshot_change c = {
+                    fields[i].name, player, fields[i].offset, fields[i].size
+                };
+
+                changes->push_back(c);
+            }
+
+            found++;
+        }
+    }
+
+    return found;
+}
+
+static int
+diff_buffer(const char *name, size_t offset,
+            const char *a, uint32_t a_size, const char *b, uint32_t b_size,
+            std::vector<struct snapshot_change> *changes)
+{
+    if (a_size == b_size && (a_size == 0 || memcmp(a, b, a_size) == 0)) {
+        return 0;
+    }
+
+    if (changes) {
+        struct snapshot_change c = { name, -1, offset, MAX(a_size, b_size) };
+
+        changes->push_back(c);
+    }
+
+    return 1;
+}
+
+/**
+ * Take a snapshot of the game of the calling thread.
+ *
+ * \return a new snapshot, for game_snapshot_free()
+ */
+struct game_snapshot *
+game_snapshot_fork(void)
+{
+    struct game_snapshot *snap;
+
+    snap = (struct game_snapshot *)xcalloc(1, sizeof(*snap));
+    game_snapshot_take(snap);
+    return snap;
+}
+
+/**
+ * Take a snapshot again, in place of what it held.  This only allocates
+ * when the event or save buffers have grown past their largest so far.
+ */
+void
+game_snapshot_take(struct game_snapshot *snap)
+{
+    INTERIMDATA *in = &snap->interim;
+
+    assert(snap);
+    assert(Data);
+
+    memcpy(&snap->data, Data, sizeof(struct Players));
+
+    in->replaySize = interimData.replaySize;
+    memcpy(in->tempReplay, interimData.tempReplay, sizeof(in->tempReplay));
+    in->eventBuffer = copy_buffer(in->eventBuffer, &snap->eventRoom,
+                                  interimData.eventBuffer,
+                                  interimData.eventSize);
+    in->eventSize = interimData.eventSize;
+    in->tempEvents = (OLDNEWS *)in->eventBuffer;
+    in->endTurnBuffer = copy_buffer(in->endTurnBuffer, &snap->endTurnRoom,
+                                    interimData.endTurnBuffer,
+                                    interimData.endTurnSaveSize);
+    in->endTurnSaveSize = interimData.endTurnSaveSize;
+    memcpy(in->endTurnRng, interimData.endTurnRng, sizeof(in->endTurnRng));
+
+    snap->rng = game_rng;
+    memcpy(snap->plr, plr, sizeof(snap->plr));
+    memcpy(snap->AI, AI, sizeof(snap->AI));
+    snap->manOnMoon = manOnMoon;
+    snap->dayOnMoon = dayOnMoon;
+}
+
+/**
+ * Put the game of the calling thread back the way it was when the
+ * snapshot was taken.  The snapshot can be restored again later.
+ */
+void
+game_snapshot_restore(const struct game_snapshot *snap)
+{
+    const INTERIMDATA *in = &snap->interim;
+
+    assert(snap);
+    assert(Data);
+
+    memcpy(Data, &snap->data, sizeof(struct Players));
+
+    interimData.replaySize = in->replaySize;
+    memcpy(interimData.tempReplay, in->tempReplay,
+           sizeof(interimData.tempReplay));
+
+    if (in->eventBuffer || interimData.eventBuffer) {
+        interimData.eventBuffer = restore_buffer(interimData.eventBuffer,
+                                  interimData.eventSize,
+                                  in->eventBuffer, in->eventSize);
+    }
+
+    interimData.eventSize = in->eventSize;
+    interimData.tempEvents = (OLDNEWS *)interimData.eventBuffer;
+
+    if (in->endTurnBuffer || interimData.endTurnBuffer) {
+        interimData.endTurnBuffer = restore_buffer(interimData.endTurnBuffer,
+                                    interimData.endTurnSaveSize,
+                                    in->endTurnBuffer, in->endTurnSaveSize);
+    }
+
+    interimData.endTurnSaveSize = in->endTurnSaveSize;
+    memcpy(interimData.endTurnRng, in->endTurnRng,
+           sizeof(interimData.endTurnRng));
+
+    game_rng = snap->rng;
+    memcpy(plr, snap->plr, sizeof(snap->plr));
+    memcpy(AI, snap->AI, sizeof(snap->AI));
+    manOnMoon = snap->manOnMoon;
+    dayOnMoon = snap->dayOnMoon;
+}
+
+/**
+ * Find what differs between two snapshots.
+ *
+ * \param changes if not NULL, gets one entry appended for each member
+ * that differs: of Players, of either side's BuzzData, or of the rest of
+ * the snapshot
+ * \return the number of members that differ, 0 if the games are the same
+ */
+int
+game_snapshot_diff(const struct game_snapshot *a,
+                   const struct game_snapshot *b,
+                   std::vector<struct snapshot_change> *changes)
+{
+    const INTERIMDATA *ia = &a->interim, *ib = &b->interim;
+    int found = 0;
+
+    assert(a && b);
+
+    if (memcmp(&a->data, &b->data, sizeof(struct Players)) != 0) {
+        found += diff_fields((const char *)&a->data, (const char *)&b->data,
+                             players_fields, ARRAY_LENGTH(players_fields),
+                             -1, changes);
+
+        for (int i = 0; i < NUM_PLAYERS; i++) {
+            found += diff_fields((const char *)&a->data.P[i],
+                                 (const char *)&b->data.P[i],
+                                 buzz_fields, ARRAY_LENGTH(buzz_fields),
+                                 i, changes);
+        }
+    }
+
+    found += diff_buffer("tempReplay", offsetof(INTERIMDATA, tempReplay),
+                         (const char *)ia->tempReplay, ia->replaySize,
+                         (const char *)ib->tempReplay, ib->replaySize,
+                         changes);
+    found += diff_buffer("eventBuffer", offsetof(INTERIMDATA, eventBuffer),
+                         ia->eventBuffer, ia->eventSize,
+                         ib->eventBuffer, ib->eventSize, changes);
+    found += diff_buffer("endTurnBuffer", offsetof(INTERIMDATA, endTurnBuffer),
+                         ia->endTurnBuffer, ia->endTurnSaveSize,
+                         ib->endTurnBuffer, ib->endTurnSaveSize, changes);
+    found += diff_fields((const char *)a, (const char *)b,
+                         snapshot_fields, ARRAY_LENGTH(snapshot_fields),
+                         -1, changes);
+
+    return found;
+}
+
+/** Free a snapshot from game_snapshot_fork(). */
+void
+game_snapshot_free(struct game_snapshot *snap)
+{
+    if (!snap) {
+        return;
+    }
+
+    free(snap->interim.eventBuffer);
+    free(snap->interim.endTurnBuffer);
+    free(snap);
+}
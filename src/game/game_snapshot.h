@@ -0,0 +1,55 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+/**
+ * \file game_snapshot.h In-memory copies of the game in progress.
+ *
+ * A snapshot holds everything that carries a game from one turn to the
+ * next on the calling thread: Data, the replay, event and end-of-turn
+ * save buffers of interimData, the random stream, and the players and
+ * Moon landing globals.  Mission plans and results live in Data; the
+ * working globals of mc.h only matter inside Launch(), so snapshots are
+ * taken and restored between launches.
+ *
+ * Taking a snapshot is a flat copy of about 50 KB, with no allocation
+ * once the snapshot has been taken before, so look-ahead code can take
+ * and restore one thousands of times a turn.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "data.h"
+#include "rng.h"
+
+struct game_snapshot {
+    struct Players data;
+    INTERIMDATA interim;        /**< buffers owned by the snapshot */
+    uint32_t eventRoom;         /**< bytes allocated for interim.eventBuffer */
+    uint32_t endTurnRoom;       /**< bytes allocated for interim.endTurnBuffer */
+    struct rng rng;
+    char plr[NUM_PLAYERS];
+    char AI[NUM_PLAYERS];
+    char manOnMoon;
+    char dayOnMoon;
+};
+
+/** a part of the game that differs between two snapshots */
+struct snapshot_change {
+    const char *field;          /**< name of the member, like "Cash" */
+    int player;                 /**< index into Data->P, or -1 if shared */
+    size_t offset;              /**< of the member in its struct */
+    size_t size;
+};
+
+struct game_snapshot *game_snapshot_fork(void);
+void game_snapshot_take(struct game_snapshot *snap);
+void game_snapshot_restore(const struct game_snapshot *snap);
+int game_snapshot_diff(const struct game_snapshot *a,
+                       const struct game_snapshot *b,
+                       std::vector<struct snapshot_change> *changes);
+void game_snapshot_free(struct game_snapshot *snap);
+
+#endif /* GAME_SNAPSHOT_H */
@@ -0,0 +1,798 @@
+// This file holds the stroke font used by draw_string() and friends,
+// rasterized once into spans so text can be drawn without a line
+// drawing call per stroke and a function call per pixel.
+
+#include "glyph_atlas.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+// Glyph cells are rasterized around the middle of a scratch bitmap;
+// no stroke reaches further than a few pixels from the pen.
+#define CELL_SIZE 64
+#define CELL_ORIGIN (CELL_SIZE / 2)
+
+struct glyph_atlas {
+    struct glyph glyphs[256];
+    std::vector<struct glyph_span> spans;
+};
+
+static void
+pen_move(struct glyph_pen *pen, int dx, int dy)
+{
+    pen->x += dx;
+    pen->y += dy;
+}
+
+/** Draws a line from the pen exactly as grLineTo() does. */
+static void
+pen_line(struct glyph_pen *pen, int dx, int dy)
+{
+    int deltax, deltay;
+    int error;
+    int ystep;
+    int x, y;
+    int x0 = pen->x, y0 = pen->y;
+    int x1 = pen->x + dx, y1 = pen->y + dy;
+    int steep;
+
+    steep = abs(y1 - y0) > abs(x1 - x0);
+
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+
+    deltax = x1 - x0;
+    deltay = abs(y1 - y0);
+    error = 0;
+
+    y = y0;
+    ystep = (y0 < y1) ? 1 : -1;
+
+    for (x = x0; x <= x1; x++) {
+        if (steep) {
+            pen->plot(pen, y, x);
+        } else {
+            pen->plot(pen, x, y);
+        }
+
+        error = error + deltay;
+
+        if (2 * error >= deltax) {
+            y = y + ystep;
+            error = error - deltax;
+        }
+    }
+
+    pen_move(pen, dx, dy);
+}
+
+#define MR(dx, dy) pen_move(pen, dx, dy)
+#define LR(dx, dy) pen_line(pen, dx, dy)
+
+/** Replays the strokes of a character from the pen position.
+ *
+ * This is the font itself; the atlas is built from it, and it remains
+ * the reference for what a character looks like.
+ *
+ * \note The function converts all characters to upper case.
+ *
+ * \param pen  pen to draw with, left at the start of the next character.
+ * \param chr  character to draw.
+ */
+void
+glyph_stroke(struct glyph_pen *pen, char chr)
+{
+    switch (toupper(chr)) {
+    case 'A':
+        LR(0, -3);
+        LR(1, -1);
+        LR(2, 0);
+        LR(1, 1);
+        LR(0, 3);
+        LR(-1, -1);
+        LR(-2, 0);
+        MR(5, 1);
+        break;
+
+    case 'B':
+        LR(0, -4);
+        LR(3, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(0, -2);
+        LR(1, 0);
+        MR(4, 2);
+        break;
+
+    case 'C':
+        MR(4, -4);
+        LR(-3, 0);
+        LR(-1, 1);
+        LR(0, 2);
+        LR(1, 1);
+        LR(3, 0);
+        MR(2, 0);
+        break;
+
+    case 'D':
+        LR(0, -4);
+        LR(3, 0);
+        LR(1, 1);
+        LR(0, 2);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(5, 0);
+        break;
+
+    case 'E':
+        LR(0, -4);
+        LR(4, 0);
+        MR(0, 4);
+        LR(-3, 0);
+        MR(0, -2);
+        LR(1, 0);
+        MR(4, 2);
+        break;
+
+    case 'F':
+        LR(0, -4);
+        LR(4, 0);
+        MR(-2, 2);
+        LR(-1, 0);
+        MR(5, 2);
+        break;
+
+    case 'G':
+        MR(4, -4);
+        LR(-3, 0);
+        LR(-1, 1);
+        LR(0, 2);
+        LR(1, 1);
+        LR(3, 0);
+        LR(0, -2);
+        LR(-1, 0);
+        MR(3, 2);
+        break;
+
+    case 'H':
+        LR(0, -4);
+        MR(1, 2);
+        LR(2, 0);
+        MR(1, -2);
+        LR(0, 4);
+        MR(2, 0);
+        break;
+
+    case 'I':
+        LR(2, 0);
+        LR(-1, -1);
+        LR(0, -2);
+        LR(-1, -1);
+        LR(2, 0);
+        MR(2, 4);
+        break;
+
+    case 'J':
+        MR(0, -1);
+        LR(1, 1);
+        LR(2, 0);
+        LR(1, -1);
+        LR(0, -3);
+        MR(2, 4);
+        break;
+
+    case 'K':
+        LR(0, -4);
+        MR(4, 0);
+        LR(-2, 2);
+        LR(-1, 0);
+        MR(1, 0);
+        LR(2, 2);
+        MR(2, 0);
+        break;
+
+    case 'L':
+        MR(0, -4);
+        LR(0, 4);
+        LR(4, 0);
+        MR(2, 0);
+        break;
+
+    case 'M':
+        LR(0, -4);
+        LR(2, 2);
+        LR(2, -2);
+        LR(0, 4);
+        MR(2, 0);
+        break;
+
+    case 'N':
+        LR(0, -4);
+        LR(4, 4);
+        LR(0, -4);
+        MR(2, 4);
+        break;
+
+    case 'O':
+    case '0':
+        MR(0, -1);
+        LR(0, -2);
+        LR(1, -1);
+        LR(2, 0);
+        LR(1, 1);
+        LR(0, 2);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(5, 0);
+        break;
+
+    case 'P':
+        LR(0, -4);
+        LR(3, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(5, 2);
+        break;
+
+    case 'Q':
+        MR(0, -1);
+        LR(0, -2);
+        LR(1, -1);
+        LR(2, 0);
+        LR(1, 1);
+        LR(0, 2);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(2, -1);
+        LR(1, 1);
+        MR(2, 0);
+        break;
+
+    case 'R':
+        LR(0, -4);
+        LR(3, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-2, 0);
+        MR(3, 1);
+        LR(0, 1);
+        MR(2, 0);
+        break;
+
+    case 'S':
+        LR(3, 0);
+        LR(1, -1);
+        LR(-1, -1);
+        LR(-2, 0);
+        LR(-1, -1);
+        LR(1, -1);
+        LR(3, 0);
+        MR(2, 4);
+        break;
+
+    case 'T':
+        MR(2, 0);
+        LR(0, -4);
+        LR(-2, 0);
+        LR(4, 0);
+        MR(2, 4);
+        break;
+
+    case 'U':
+        MR(0, -4);
+        LR(0, 3);
+        LR(1, 1);
+        LR(2, 0);
+        LR(1, -1);
+        LR(0, -3);
+        MR(2, 4);
+        break;
+
+    case 'V':
+        MR(0, -4);
+        LR(0, 2);
+        LR(2, 2);
+        LR(2, -2);
+        LR(0, -2);
+        MR(2, 4);
+        break;
+
+    case 'W':
+        MR(0, -4);
+        LR(0, 4);
+        LR(2, -2);
+        LR(2, 2);
+        LR(0, -4);
+        MR(2, 4);
+        break;
+
+    case 'X':
+        MR(0, -4);
+        LR(4, 4);
+        MR(0, -4);
+        LR(-4, 4);
+        MR(6, 0);
+        break;
+
+    case 'Y':
+        MR(2, 0);
+        LR(0, -1);
+        LR(-2, -2);
+        LR(0, -1);
+        MR(4, 0);
+        LR(0, 1);
+        LR(-2, 2);
+        MR(4, 1);
+        break;
+
+    case 'Z':
+        MR(0, -4);
+        LR(4, 0);
+        LR(-4, 4);
+        LR(4, 0);
+        MR(2, 0);
+        break;
+
+    case '1':
+        LR(2, 0);
+        LR(-1, -1);
+        LR(0, -3);
+        LR(-1, 1);
+        MR(4, 3);
+        break;
+
+    case '2':
+        MR(0, -4);
+        LR(3, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-1, 0);
+        LR(-2, 2);
+        LR(4, 0);
+        MR(2, 0);
+        break;
+
+    case '3':
+        LR(3, 0);
+        LR(1, -1);
+        LR(-1, -1);
+        LR(-1, 0);
+        LR(1, 0);
+        LR(1, -1);
+        LR(-1, -1);
+        LR(-3, 0);
+        MR(6, 4);
+        break;
+
+    case '4':
+        MR(4, -1);
+        LR(-4, 0);
+        LR(0, -1);
+        LR(2, -2);
+        LR(1, 0);
+        LR(0, 4);
+        MR(3, 0);
+        break;
+
+    case '5':
+        LR(3, 0);
+        LR(1, -1);
+        LR(-1, -1);
+        LR(-2, 0);
+        LR(-1, -1);
+        LR(0, -1);
+        LR(4, 0);
+        MR(2, 4);
+        break;
+
+    case '6':
+        MR(1, -2);
+        LR(2, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-2, 0);
+        LR(-1, -1);
+        LR(0, -2);
+        LR(1, -1);
+        LR(2, 0);
+        MR(3, 4);
+        break;
+
+    case '7':
+        MR(0, -4);
+        LR(4, 0);
+        LR(0, 1);
+        LR(-2, 2);
+        LR(0, 1);
+        MR(4, 0);
+        break;
+
+    case '8':
+        MR(1, 0);
+        LR(2, 0);
+        LR(1, -1);
+        LR(-1, -1);
+        LR(-2, 0);
+        LR(-1, -1);
+        LR(1, -1);
+        LR(2, 0);
+        LR(1, 1);
+        MR(-4, 2);
+        LR(0, 0);
+        MR(6, 1);
+        break;
+
+    case '9':
+        MR(1, 0);
+        LR(2, 0);
+        LR(1, -1);
+        LR(0, -2);
+        LR(-1, -1);
+        LR(-2, 0);
+        LR(-1, 1);
+        LR(1, 1);
+        LR(2, 0);
+        MR(3, 2);
+        break;
+
+    case '-':
+        MR(0, -2), LR(3, 0);
+        MR(2, 2);
+        break;
+
+    case '+':
+        MR(0, -2);
+        LR(4, 0);
+        MR(-2, -2);
+        LR(0, 4);
+        MR(4, 0);
+        break;
+
+    case '.':
+        LR(0, 0);
+        MR(2, 0);
+        break;
+
+    case ',':
+        MR(0, 1);
+        LR(1, -1);
+        MR(2, 0);
+        break;
+
+    case ':':
+        MR(0, -1);
+        LR(0, 0);
+        MR(0, -2);
+        LR(0, 0);
+        MR(2, 3);
+        break;
+
+    case '&':
+        MR(0, -1);
+        LR(1, 1);
+        LR(1, 0);
+        LR(1, -1);
+        LR(1, 1);
+        LR(-2, -2);
+        LR(-1, 0);
+        LR(0, -1);
+        LR(1, -1);
+        LR(1, 1);
+        MR(3, 3);
+        break;
+
+    case ' ':
+        MR(3, 0);
+        break;
+
+    case '!':
+        LR(0, 0);
+        MR(0, -2);
+        LR(0, -2);
+        MR(2, 4);
+        break;
+
+    case '@':
+    case '#':
+        MR(1, 0);
+        LR(0, -4);
+        MR(-1, 1);
+        LR(4, 0);
+        MR(-1, -1);
+        LR(0, 4);
+        MR(1, -1);
+        LR(-4, 0);
+        MR(6, 1);
+        break;
+
+    case '%':
+        LR(4, -4);
+        MR(-3, 0);
+        LR(-1, 1);
+        LR(0, -1);
+        LR(4, 4);
+        LR(-1, 0);
+        LR(1, -1);
+        MR(2, 1);
+        break;
+
+    case '(':
+        MR(1, 0);
+        LR(-1, -1);
+        LR(0, -2);
+        LR(1, -1);
+        MR(2, 4);
+        break;
+
+    case ')':
+        LR(1, -1);
+        LR(0, -2);
+        LR(-1, -1);
+        MR(3, 4);
+        break;
+
+    case '/':
+        LR(4, -4);
+        MR(2, 4);
+        break;
+
+    case '<':
+        MR(4, -4);
+        LR(-2, 2);
+        LR(2, 2);
+        MR(2, 0);
+        break;
+
+    case '>':
+        MR(0, -4);
+        LR(2, 2);
+        LR(-2, 2);
+        MR(4, 0);
+        break;
+
+    case 0x27:
+        MR(0, -4);
+        LR(0, 1);
+        MR(2, 3);
+        break;
+
+    case '*':
+        MR(1, 0);
+        LR(0, -4);
+        MR(-1, 1);
+        LR(4, 0);
+        MR(-1, -1);
+        LR(0, 4);
+        MR(1, -1);
+        LR(-4, 0);
+        MR(6, 1);
+        break;
+
+    case '^':
+        MR(0, -3);
+        LR(1, -1);
+        LR(1, 0);
+        LR(1, 1);
+        MR(0, 3);
+        break;
+
+    case '?':
+        MR(0, -3);
+        LR(1, -1);
+        LR(2, 0);
+        LR(1, 1);
+        LR(-1, 1);
+        LR(-1, 0);
+        MR(0, 2);
+        LR(0, 0);
+        MR(4, 0);
+        break;
+
+    case 0x14:
+        LR(0, -4);
+        MR(2, 4);
+        break;
+
+    default:
+        break;
+    }
+}
+
+#undef MR
+#undef LR
+
+static void
+plot_cell(struct glyph_pen *pen, int x, int y)
+{
+    uint8_t *cell = (uint8_t *) pen->data;
+
+    if (x >= 0 && x < CELL_SIZE && y >= 0 && y < CELL_SIZE) {
+        cell[y * CELL_SIZE + x] = 1;
+    }
+}
+
+/** Rasterizes every character and run-length encodes the rows. */
+static struct glyph_atlas *
+build_atlas(void)
+{
+    struct glyph_atlas *atlas = new glyph_atlas;
+    std::vector<size_t> first(256);
+    uint8_t cell[CELL_SIZE * CELL_SIZE];
+
+    for (int c = 0; c < 256; c++) {
+        struct glyph *g = &atlas->glyphs[c];
+        struct glyph_pen pen = { CELL_ORIGIN, CELL_ORIGIN, plot_cell, cell };
+
+        memset(cell, 0, sizeof(cell));
+        glyph_stroke(&pen, (char) c);
+
+        memset(g, 0, sizeof(*g));
+        g->advance_x = pen.x - CELL_ORIGIN;
+        g->advance_y = pen.y - CELL_ORIGIN;
+        g->left = g->top = CELL_SIZE;
+        g->right = g->bottom = -CELL_SIZE;
+        first[c] = atlas->spans.size();
+
+        for (int y = 0; y < CELL_SIZE; y++) {
+            for (int x = 0; x < CELL_SIZE; x++) {
+                if (!cell[y * CELL_SIZE + x]) {
+                    continue;
+                }
+
+                struct glyph_span span;
+                int start = x;
+
+                while (x < CELL_SIZE && cell[y * CELL_SIZE + x]) {
+                    x++;
+                }
+
+                span.x = start - CELL_ORIGIN;
+                span.y = y - CELL_ORIGIN;
+                span.length = x - start;
+                atlas->spans.push_back(span);
+
+                g->left = std::min(g->left, (int) span.x);
+                g->right = std::max(g->right, span.x + span.length);
+                g->top = std::min(g->top, (int) span.y);
+                g->bottom = std::max(g->bottom, span.y + 1);
+            }
+        }
+
+        g->span_count = atlas->spans.size() - first[c];
+
+        if (g->span_count == 0) {
+            g->left = g->top = g->right = g->bottom = 0;
+        }
+    }
+
+    // The span vector no longer grows, so pointers into it are stable
+    for (int c = 0; c < 256; c++) {
+        if (atlas->glyphs[c].span_count) {
+            atlas->glyphs[c].spans = &atlas->spans[first[c]];
+        }
+    }
+
+    return atlas;
+}
+
+/** Returns the rasterized form of a character.
+ *
+ * The atlas is built on first use and kept for the life of the program.
+ */
+const struct glyph *
+glyph_get(char chr)
+{
+    static const struct glyph_atlas *atlas = build_atlas();
+
+    return &atlas->glyphs[(unsigned char) chr];
+}
+
+/** Width in pixels of a string drawn with glyph_draw().
+ *
+ * This is the sum of the advances, less the blank column every
+ * character but '^' leaves after itself on the last one.
+ */
+int
+glyph_text_width(const char *s)
+{
+    size_t length = strlen(s);
+    int pixels = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        pixels += glyph_get(s[i])->advance_x;
+    }
+
+    if (length > 0 && s[length - 1] != '^') {
+        pixels -= 1;
+    }
+
+    return pixels;
+}
+
+/** Draws characters into an 8-bit buffer.
+ *
+ * Pixels falling outside the buffer are skipped.
+ *
+ * \param pixels   top left of the buffer.
+ * \param pitch    bytes between the start of two rows.
+ * \param width    buffer width in pixels.
+ * \param height   buffer height in pixels.
+ * \param x, y     pen position; updated to where the next character goes.
+ * \param s        characters to draw; need not be terminated.
+ * \param length   number of characters.
+ * \param color    color index to draw with.
+ * \param touched  set to the bounds of what was drawn (may be NULL).
+ */
+void
+glyph_draw(char *pixels, int pitch, int width, int height,
+           int *x, int *y, const char *s, size_t length, char color,
+           struct glyph_rect *touched)
+{
+    int pen_x = *x, pen_y = *y;
+    int left = width, top = height, right = 0, bottom = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        const struct glyph *g = glyph_get(s[i]);
+
+        for (int n = 0; n < g->span_count; n++) {
+            const struct glyph_span *span = &g->spans[n];
+            int row = pen_y + span->y;
+            int x0 = pen_x + span->x;
+            int x1 = x0 + span->length;
+
+            if (row < 0 || row >= height) {
+                continue;
+            }
+
+            x0 = std::max(x0, 0);
+            x1 = std::min(x1, width);
+
+            if (x0 >= x1) {
+                continue;
+            }
+
+            if (x1 - x0 == 1) {
+                pixels[row * pitch + x0] = color;
+            } else {
+                memset(pixels + row * pitch + x0, color, x1 - x0);
+            }
+
+            left = std::min(left, x0);
+            right = std::max(right, x1);
+            top = std::min(top, row);
+            bottom = std::max(bottom, row + 1);
+        }
+
+        pen_x += g->advance_x;
+        pen_y += g->advance_y;
+    }
+
+    *x = pen_x;
+    *y = pen_y;
+
+    if (touched) {
+        if (left < right) {
+            touched->x = left;
+            touched->y = top;
+            touched->w = right - left;
+            touched->h = bottom - top;
+        } else {
+            touched->x = touched->y = touched->w = touched->h = 0;
+        }
+    }
+}
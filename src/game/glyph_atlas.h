@@ -0,0 +1,42 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** A horizontal run of set pixels, relative to the pen position. */
+struct glyph_span {
+    int8_t x;
+    int8_t y;
+    uint8_t length;
+};
+
+/** One character of the stroke font, rasterized. */
+struct glyph {
+    int advance_x;                  /**< pen movement after drawing */
+    int advance_y;
+    int left, top, right, bottom;   /**< bounds around the pen, exclusive */
+    const struct glyph_span *spans;
+    int span_count;
+};
+
+/** Pen replaying the stroke font, one plot() call per pixel. */
+struct glyph_pen {
+    int x, y;
+    void (*plot)(struct glyph_pen *pen, int x, int y);
+    void *data;
+};
+
+/** Area written by glyph_draw(); w and h are 0 if nothing was. */
+struct glyph_rect {
+    int x, y, w, h;
+};
+
+void glyph_stroke(struct glyph_pen *pen, char chr);
+const struct glyph *glyph_get(char chr);
+int glyph_text_width(const char *s);
+void glyph_draw(char *pixels, int pitch, int width, int height,
+                int *x, int *y, const char *s, size_t length, char color,
+                struct glyph_rect *touched);
+
+#endif // GLYPH_ATLAS_H
@@ -26,16 +26,16 @@ grGetMouseButtons(void)
 int
 grGetMousePressedPos(int *xp, int *yp)
 {
-    *xp = av_mouse_pressed_x / 2;
-    *yp = av_mouse_pressed_y / 2;
+    *xp = av_mouse_pressed_x / display::graphics.scale();
+    *yp = av_mouse_pressed_y / display::graphics.scale();
     return (0);
 }
 
 int
 grGetMouseCurPos(int *xp, int *yp)
 {
-    *xp = av_mouse_cur_x / 2;
-    *yp = av_mouse_cur_y / 2;
+    *xp = av_mouse_cur_x / display::graphics.scale();
+    *yp = av_mouse_cur_y / display::graphics.scale();
     return (0);
 }
 
@@ -52,6 +52,13 @@ grMoveTo(int x, int y)
     gr_cur_y = y;
 }
 
+void
+grGetCurPos(int *xp, int *yp)
+{
+    *xp = gr_cur_x;
+    *yp = gr_cur_y;
+}
+
 void
 grLineTo(int x_arg, int y_arg)
 {
@@ -2,6 +2,7 @@
 #define GR_H
 
 void grMoveTo(int x, int y);
+void grGetCurPos(int *xp, int *yp);
 void grLineTo(int x, int y);
 int grGetMouseButtons(void);
 void grLineRel(int x, int y);
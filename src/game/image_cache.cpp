@@ -0,0 +1,215 @@
+// This file keeps decoded images around so screens can be reopened
+// without decoding their PNGs again.
+
+#include "image_cache.h"
+
+#include <list>
+#include <map>
+#include <sstream>
+
+#include "filesystem.h"
+#include "logging.h"
+
+LOG_DEFAULT_CATEGORY(filesys)
+
+namespace
+{
+
+// Rough cost of a surface beyond its pixels: palette and bookkeeping
+const size_t IMAGE_OVERHEAD = 256 * 4 + 256;
+
+struct Entry {
+    ImageCache::Image image;
+    size_t bytes;
+    std::list<std::string>::iterator lru;
+};
+
+typedef std::map<std::string, Entry> EntryMap;
+
+struct Cache {
+    Cache() : loader(Filesystem::decodeImage)
+    {
+        stats.hits = stats.misses = stats.evictions = 0;
+        stats.entries = 0;
+        stats.bytes = 0;
+        stats.budget = 0;
+    }
+
+    ImageCache::Loader loader;
+    EntryMap entries;
+    std::list<std::string> lru;     // most recently used first
+    ImageCache::Stats stats;
+};
+
+Cache cache;
+
+size_t ImageBytes(const ImageCache::Image &image);
+void Trim();
+};
+
+
+//----------------------------------------------------------------------
+// Header function definitions
+//----------------------------------------------------------------------
+
+
+/* Sets how much the cache may hold and how it decodes images.
+ *
+ * Until this is called, nothing is cached and images are decoded by
+ * Filesystem::decodeImage(). A budget of 0 turns caching off.
+ */
+void ImageCache::init(size_t budget, Loader loader)
+{
+    cache.stats.budget = budget;
+    cache.loader = loader;
+    Trim();
+}
+
+
+/* Returns the decoded image at a path, decoding it if needed.
+ *
+ * \throws std::runtime_error  if the image can't be read.
+ */
+ImageCache::Image ImageCache::get(const std::string &filename)
+{
+    EntryMap::iterator it = cache.entries.find(filename);
+
+    if (it != cache.entries.end()) {
+        cache.stats.hits++;
+        cache.lru.splice(cache.lru.begin(), cache.lru, it->second.lru);
+        return it->second.image;
+    }
+
+    Image image = cache.loader(filename);
+    cache.stats.misses++;
+
+    DEBUG5("decoded `%s' (%lu hits, %lu misses, %lu evictions)",
+           filename.c_str(), cache.stats.hits, cache.stats.misses,
+           cache.stats.evictions);
+
+    if (cache.stats.budget == 0) {
+        return image;
+    }
+
+    Entry &entry = cache.entries[filename];
+    entry.image = image;
+    entry.bytes = ImageBytes(image);
+    entry.lru = cache.lru.insert(cache.lru.begin(), filename);
+
+    cache.stats.entries++;
+    cache.stats.bytes += entry.bytes;
+    Trim();
+
+    return image;
+}
+
+
+/* Checks whether an image is in the cache, without counting as a use.
+ */
+bool ImageCache::cached(const std::string &filename)
+{
+    return cache.entries.find(filename) != cache.entries.end();
+}
+
+
+/* Decodes every image named in a list file ahead of time.
+ *
+ * The list has one path per line; blank lines and lines starting with
+ * '#' are ignored, as are images that fail to load. A missing list is
+ * not an error.
+ */
+void ImageCache::prewarm(const std::string &listFilename)
+{
+    if (!Filesystem::exists(listFilename)) {
+        return;
+    }
+
+    boost::shared_ptr<File> file = Filesystem::open(listFilename);
+    std::string text(file->length(), '\0');
+
+    if (!text.empty()) {
+        file->read(&text[0], text.size());
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    unsigned int count = 0;
+
+    while (std::getline(lines, line)) {
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        try {
+            get(line);
+            count++;
+        } catch (const std::exception &err) {
+            WARNING3("can't prewarm `%s': %s", line.c_str(), err.what());
+        }
+    }
+
+    INFO3("prewarmed %u images (%lu KB)", count,
+          (unsigned long)(cache.stats.bytes / 1024));
+}
+
+
+/* Drops every image nobody else holds.
+ */
+void ImageCache::clear()
+{
+    size_t budget = cache.stats.budget;
+
+    cache.stats.budget = 0;
+    Trim();
+    cache.stats.budget = budget;
+}
+
+
+ImageCache::Stats ImageCache::stats()
+{
+    return cache.stats;
+}
+
+
+//----------------------------------------------------------------------
+// Local definitions
+//----------------------------------------------------------------------
+
+namespace  // Start of local namespace
+{
+
+size_t ImageBytes(const ImageCache::Image &image)
+{
+    return image->width() * image->height() + IMAGE_OVERHEAD;
+}
+
+
+/* Evicts least recently used images until the cache fits its budget.
+ *
+ * Images still held outside the cache are skipped; dropping them would
+ * free nothing.
+ */
+void Trim()
+{
+    std::list<std::string>::iterator it = cache.lru.end();
+
+    while (cache.stats.bytes > cache.stats.budget && it != cache.lru.begin()) {
+        --it;
+        EntryMap::iterator entry = cache.entries.find(*it);
+
+        if (!entry->second.image.unique()) {
+            continue;
+        }
+
+        cache.stats.bytes -= entry->second.bytes;
+        cache.stats.entries--;
+        cache.stats.evictions++;
+        cache.entries.erase(entry);
+        it = cache.lru.erase(it);
+    }
+}
+
+};  // End of local namespace
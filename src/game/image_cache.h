@@ -0,0 +1,40 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <stddef.h>
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "display/palettized_surface.h"
+
+// Decoded images, kept for reuse by Filesystem::readImage().
+//
+// Images are shared between everyone who asks for the same path, so they
+// must be treated as read-only. An image stays cached while anyone still
+// holds it; once only the cache does, it may be dropped, least recently
+// used first, whenever the cache is over its byte budget.
+class ImageCache
+{
+public:
+    typedef boost::shared_ptr<display::PalettizedSurface> Image;
+    typedef Image (*Loader)(const std::string &filename);
+
+    struct Stats {
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+        unsigned int entries;
+        size_t bytes;
+        size_t budget;
+    };
+
+    static void init(size_t budget, Loader loader);
+    static Image get(const std::string &filename);
+    static bool cached(const std::string &filename);
+    static void prewarm(const std::string &listFilename);
+    static void clear();
+    static Stats stats();
+};
+
+#endif // IMAGE_CACHE_H
@@ -47,29 +47,50 @@
 #include "filesystem.h"
 #include "randomize.h"
 
-Equipment *MH[2][8];   // Pointer to the hardware
-struct MisAst MA[2][4];  //[2][4]
-struct MisEval Mev[60];  // was *Mev;
-struct mStr Mis;
-REPLAY Rep;
-
-char tMen;
-
-char MANNED[2];
-char CAP[2];
-char LM[2];
-char DOC[2];
-char EVA[2];
-char STEP;
-char FINAL;
-char JOINT;
-char pal2[768];
-char PastBANG;
-char mcc;
-char fEarly; /**< kind of a boolean indicating early missions */
-char hero;
-char DMFake;
-uint16_t MisStat;
+GAME_LOCAL Equipment *MH[2][8];   // Pointer to the hardware
+GAME_LOCAL struct MisAst MA[2][4];  //[2][4]
+GAME_LOCAL struct MisEval Mev[60];  // was *Mev;
+GAME_LOCAL struct mStr Mis;
+GAME_LOCAL REPLAY Rep;
+GAME_LOCAL_RESET(MH);
+GAME_LOCAL_RESET(MA);
+GAME_LOCAL_RESET(Mev);
+GAME_LOCAL_RESET(Mis);
+GAME_LOCAL_RESET(Rep);
+
+GAME_LOCAL char tMen;
+GAME_LOCAL_RESET(tMen);
+
+GAME_LOCAL char MANNED[2];
+GAME_LOCAL char CAP[2];
+GAME_LOCAL char LM[2];
+GAME_LOCAL char DOC[2];
+GAME_LOCAL char EVA[2];
+GAME_LOCAL char STEP;
+GAME_LOCAL char FINAL;
+GAME_LOCAL char JOINT;
+GAME_LOCAL char pal2[768];
+GAME_LOCAL char PastBANG;
+GAME_LOCAL char mcc;
+GAME_LOCAL char fEarly; /**< kind of a boolean indicating early missions */
+GAME_LOCAL char hero;
+GAME_LOCAL char DMFake;
+GAME_LOCAL uint16_t MisStat;
+GAME_LOCAL_RESET(MANNED);
+GAME_LOCAL_RESET(CAP);
+GAME_LOCAL_RESET(LM);
+GAME_LOCAL_RESET(DOC);
+GAME_LOCAL_RESET(EVA);
+GAME_LOCAL_RESET(STEP);
+GAME_LOCAL_RESET(FINAL);
+GAME_LOCAL_RESET(JOINT);
+GAME_LOCAL_RESET(pal2);
+GAME_LOCAL_RESET(PastBANG);
+GAME_LOCAL_RESET(mcc);
+GAME_LOCAL_RESET(fEarly);
+GAME_LOCAL_RESET(hero);
+GAME_LOCAL_RESET(DMFake);
+GAME_LOCAL_RESET(MisStat);
 /* STEP tracks mission step numbers             */
 /* FINAL is the ultimate result of safety check */
 /* JOINT signals the joint mission code         */
@@ -113,45 +134,17 @@ void SetW(char ch)
     Mev[i].Name[2] = ch;
 }
 
-int Launch(char plr, char mis)
+/**
+ * Set the mission up for MisCheck(): load the hardware, seat the crew,
+ * build the steps in Mev and apply the safety penalties.
+ *
+ * MANNED and JOINT must already be set from the mission, and MH and Mev
+ * cleared.  This is the part of Launch() that the mission odds share.
+ */
+void LaunchSetup(char plr, char mis)
 {
-    int i, j, t, k, mcode, avg, temp = 0;
+    int i, j, t, k, mcode;
     char total;
-    STEP = FINAL = JOINT = PastBANG = 0;
-    MisStat = tMen = 0x00; // clear mission status flags
-
-    remove_savedat("REPLAY.TMP");  // make sure replay buffer isn't there
-
-    if (Data->P[plr].Mission[mis].part == 1) {
-        return 0;
-    }
-
-    memset(buffer, 0x00, BUFFER_SIZE); // Clear Buffer
-    memset(MH, 0x00, sizeof MH);
-    memset(Mev, 0x00, sizeof Mev);
-
-    if (Data->P[plr].Mission[mis].MissionCode == Mission_SubOrbital) {
-        Data->P[plr].Mission[mis].Duration = 1;
-    }
-
-    MANNED[0] = Data->P[plr].Mission[mis].Men;
-    MANNED[1] = Data->P[plr].Mission[mis].Joint ? Data->P[plr].Mission[mis + 1].Men : 0;
-
-    JOINT = Data->P[plr].Mission[mis].Joint;
-
-    temp = CheckCrewOK(plr, mis);
-
-    if (temp == 1) { // found mission no crews
-        ScrubMission(plr, mis - Data->P[plr].Mission[mis].part);
-    }
-
-    if (!AI[plr] && Data->P[plr].Mission[mis].MissionCode) {
-        MisAnn(plr, mis);
-    }
-
-    if (Data->P[plr].Mission[mis].MissionCode == Mission_None) {
-        return -20;
-    }
 
     MissionSetup(plr, mis);
 
@@ -302,6 +295,48 @@ int Launch(char plr, char mis)
 
     MisRush(plr, Data->P[plr].Mission[mis].Rushing);
     STEPnum = 0;
+}
+
+int Launch(char plr, char mis)
+{
+    int i, j, mcode, avg, temp = 0;
+    char total;
+    STEP = FINAL = JOINT = PastBANG = 0;
+    MisStat = tMen = 0x00; // clear mission status flags
+
+    if (Data->P[plr].Mission[mis].part == 1) {
+        return 0;
+    }
+
+    memset(buffer, 0x00, BUFFER_SIZE); // Clear Buffer
+    memset(MH, 0x00, sizeof MH);
+    memset(Mev, 0x00, sizeof Mev);
+
+    if (Data->P[plr].Mission[mis].MissionCode == Mission_SubOrbital) {
+        Data->P[plr].Mission[mis].Duration = 1;
+    }
+
+    MANNED[0] = Data->P[plr].Mission[mis].Men;
+    MANNED[1] = Data->P[plr].Mission[mis].Joint ? Data->P[plr].Mission[mis + 1].Men : 0;
+
+    JOINT = Data->P[plr].Mission[mis].Joint;
+
+    temp = CheckCrewOK(plr, mis);
+
+    if (temp == 1) { // found mission no crews
+        ScrubMission(plr, mis - Data->P[plr].Mission[mis].part);
+    }
+
+    if (!AI[plr] && Data->P[plr].Mission[mis].MissionCode) {
+        MisAnn(plr, mis);
+    }
+
+    if (Data->P[plr].Mission[mis].MissionCode == Mission_None) {
+        return -20;
+    }
+
+    LaunchSetup(plr, mis);
+    mcode = Data->P[plr].Mission[mis].MissionCode;
 
     if (!AI[plr] && !fullscreenMissionPlayback) {
         DrawControl(plr);
@@ -392,8 +427,6 @@ int Launch(char plr, char mis)
 void MissionPast(char plr, char pad, int prest)
 {
     int loc, i, j, loop, mc;
-    FILE *fout;
-    unsigned int num;
     char dys[7] = {0, 2, 5, 7, 12, 16, 20};
 
     loc = Data->P[plr].PastMissionCount;
@@ -567,21 +600,7 @@ void MissionPast(char plr, char pad, int prest)
 
     }
 
-    Rep.Qty = 0;
-    fout = sOpen("REPLAY.TMP", "rt", 1);
-
-    while (!feof(fout)) {
-        if (fscanf(fout, "%u\n", &num) != 1) {
-            break;
-        }
-
-        Rep.Off[Rep.Qty++] = num;
-    }
-
-    fclose(fout);
-
-    remove_savedat("REPLAY.TMP");
-
+    // Rep was filled in by PlaySequence() as the steps were played
     if (Rep.Qty == 1 && Data->P[plr].History[loc].spResult < 3000) {
         Data->P[plr].History[loc].spResult = 1999;
     }
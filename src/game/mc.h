@@ -2,27 +2,29 @@
 #define MC_H
 
 #include "data.h"
+#include "game_context.h"
 
 int Launch(char plr, char mis);
+void LaunchSetup(char plr, char mis);
 
-extern struct mStr Mis;
-extern Equipment *MH[2][8];
-extern struct MisAst MA[2][4];
-extern struct MisEval Mev[60];
+extern GAME_LOCAL struct mStr Mis;
+extern GAME_LOCAL Equipment *MH[2][8];
+extern GAME_LOCAL struct MisAst MA[2][4];
+extern GAME_LOCAL struct MisEval Mev[60];
 extern struct MXM *AList;
-extern REPLAY Rep;
-extern char MANNED[2];
-extern char CAP[2];
-extern char LM[2];
-extern char DOC[2];
-extern char EVA[2];
-extern char STEP;
-extern char FINAL;
-extern char JOINT;
-extern char PastBANG;
-extern char DMFake;
-extern char fEarly;
-extern char mcc;
-extern char hero;
+extern GAME_LOCAL REPLAY Rep;
+extern GAME_LOCAL char MANNED[2];
+extern GAME_LOCAL char CAP[2];
+extern GAME_LOCAL char LM[2];
+extern GAME_LOCAL char DOC[2];
+extern GAME_LOCAL char EVA[2];
+extern GAME_LOCAL char STEP;
+extern GAME_LOCAL char FINAL;
+extern GAME_LOCAL char JOINT;
+extern GAME_LOCAL char PastBANG;
+extern GAME_LOCAL char DMFake;
+extern GAME_LOCAL char fEarly;
+extern GAME_LOCAL char mcc;
+extern GAME_LOCAL char hero;
 
 #endif // MC_H
@@ -461,13 +461,7 @@ void MissionSteps(char plr, int mcode, int Mgoto, int step, int pad)
 
         Mev[step].step = step;
 
-        if ((Data->Def.Lev1 == 0 && plr == 0) || (Data->Def.Lev2 == 0 && plr == 1)) {
-            Mev[STEP].dice = MisRandom();
-        } else {
-            Mev[STEP].dice = brandom((AI[plr]) ? 98 : 100) + 1;
-        }
-
-        Mev[step].rnum = brandom(10000) + 1;
+        MisRoll(plr, step);
         Mev[step].sgoto = 0;
 
         Mev[step].fgoto = (Mgoto == -2) ? step + 1 : Mgoto;  // prevents mission looping
@@ -660,6 +654,21 @@ void MissionSteps(char plr, int mcode, int Mgoto, int step, int pad)
     return;
 }
 
+/**
+ * Roll the dice a mission step is checked against, and the failure
+ * report it is given if the check fails.
+ */
+void MisRoll(char plr, char step)
+{
+    if ((Data->Def.Lev1 == 0 && plr == 0) || (Data->Def.Lev2 == 0 && plr == 1)) {
+        Mev[step].dice = MisRandom();
+    } else {
+        Mev[step].dice = brandom((AI[plr]) ? 98 : 100) + 1;
+    }
+
+    Mev[step].rnum = brandom(10000) + 1;
+}
+
 void MisPrt(void)
 {
     int i;
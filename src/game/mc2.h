@@ -7,6 +7,7 @@ void MisPrt(void);
 void MisDur(char plr, char dur);
 void MisSkip(char plr, char ms);
 void MisRush(char plr, char rush_level);
+void MisRoll(char plr, char step);
 void MissionSetDown(char plr, char mis);
 
 #endif // MC2_H
@@ -0,0 +1,147 @@
+// This file schedules video frames against the wall clock.
+
+#include "media_clock.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <SDL/SDL.h>
+
+#include "Buzz_inc.h"
+#include "sdlhelper.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(video)
+
+/* a frame later than this restarts the clock instead of being dropped */
+#define MEDIA_CLOCK_RESYNC  0.5
+
+/* longest single sleep, so events are still handled promptly */
+#define MEDIA_CLOCK_SLICE   0.010
+
+/*
+ * Sleep until a wall clock time, handling events at least once even if
+ * it has passed already.  SDL_Delay()
+ * can oversleep by a millisecond or so, so the last stretch is slept in
+ * 1 ms steps.
+ */
+static void
+sleep_until(double when)
+{
+    for (;;) {
+        double left;
+
+        av_step();
+        left = when - get_time();
+
+        if (left <= 0) {
+            break;
+        }
+
+        if (left > MEDIA_CLOCK_SLICE) {
+            left = MEDIA_CLOCK_SLICE;
+        }
+
+        SDL_Delay((left > 0.002) ? (Uint32)((left - 0.001) * 1000) : 1);
+    }
+}
+
+/** Start a session, with pts 0 due now. */
+void
+media_clock_start(struct media_clock *mc, const char *name)
+{
+    assert(mc);
+    assert(name);
+
+    memset(mc, 0, sizeof(*mc));
+    mc->name = name;
+    mc->start = get_time();
+}
+
+/** Make a presentation time due now, as when a new clip starts. */
+void
+media_clock_restart(struct media_clock *mc, double pts)
+{
+    assert(mc);
+
+    mc->start = get_time() - pts;
+    mc->late_run = 0;
+}
+
+/** Push every later frame back, after pausing playback on purpose. */
+void
+media_clock_hold(struct media_clock *mc, double secs)
+{
+    assert(mc);
+
+    mc->start += secs;
+}
+
+/**
+ * How long until a frame is due.
+ *
+ * \return seconds from \a now, negative if the frame is late
+ */
+double
+media_clock_due(const struct media_clock *mc, double pts, double now)
+{
+    assert(mc);
+
+    return mc->start + pts - now;
+}
+
+/**
+ * Wait for a decoded frame to be due.
+ *
+ * A frame more than \a frame_secs late is dropped, unless the last
+ * #MEDIA_CLOCK_MAX_DROPS frames were dropped too.  When playback has
+ * fallen far behind, because of a stall rather than slow decoding, the
+ * clock is restarted at the frame instead.
+ *
+ * \param pts presentation time of the frame
+ * \param frame_secs how long the frame is shown for, 1 / fps
+ * \param decode_secs how long decoding the frame took
+ * \return 1 if the frame should be shown now, 0 to drop it
+ */
+int
+media_clock_wait(struct media_clock *mc, double pts, double frame_secs,
+                 double decode_secs)
+{
+    double now = get_time();
+    double due = media_clock_due(mc, pts, now);
+
+    mc->decoded++;
+    mc->decode_secs += decode_secs;
+
+    if (due < -MEDIA_CLOCK_RESYNC) {
+        DEBUG3("%s: %.0f ms behind, restarting clock",
+               mc->name, -due * 1000);
+        media_clock_restart(mc, pts);
+        return 1;
+    }
+
+    if (due < -frame_secs && mc->late_run < MEDIA_CLOCK_MAX_DROPS) {
+        mc->dropped++;
+        mc->late_run++;
+        return 0;
+    }
+
+    mc->late_run = 0;
+    sleep_until(now + due);
+    return 1;
+}
+
+/** Log the statistics of the session. */
+void
+media_clock_stop(struct media_clock *mc)
+{
+    assert(mc);
+
+    if (!mc->decoded) {
+        return;
+    }
+
+    INFO5("%s: %lu frames decoded, %lu dropped, %.2f ms mean decode",
+          mc->name, mc->decoded, mc->dropped,
+          mc->decode_secs * 1000 / mc->decoded);
+}
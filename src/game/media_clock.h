@@ -0,0 +1,34 @@
+#ifndef MEDIA_CLOCK_H
+#define MEDIA_CLOCK_H
+
+/**
+ * \file media_clock.h Paces video frames by their presentation times.
+ *
+ * A clock maps presentation timestamps, in seconds from the start of the
+ * video, to wall clock time.  Each decoded frame is handed to
+ * media_clock_wait(), which sleeps until the frame is due or, if it is
+ * already more than a frame late, says to drop it.  Statistics for the
+ * session are logged by media_clock_stop().
+ */
+
+/** most frames dropped in a row before one is shown regardless */
+#define MEDIA_CLOCK_MAX_DROPS   4
+
+struct media_clock {
+    const char *name;           /**< for the log */
+    double start;               /**< wall time at which pts 0 is due */
+    unsigned long decoded;
+    unsigned long dropped;
+    double decode_secs;         /**< total decode time of every frame */
+    unsigned late_run;          /**< frames dropped since the last shown */
+};
+
+void media_clock_start(struct media_clock *mc, const char *name);
+void media_clock_restart(struct media_clock *mc, double pts);
+void media_clock_hold(struct media_clock *mc, double secs);
+double media_clock_due(const struct media_clock *mc, double pts, double now);
+int media_clock_wait(struct media_clock *mc, double pts, double frame_secs,
+                     double decode_secs);
+void media_clock_stop(struct media_clock *mc);
+
+#endif /* MEDIA_CLOCK_H */
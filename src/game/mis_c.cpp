@@ -39,10 +39,12 @@
 #include "options.h"
 #include "game_main.h"
 #include "mc.h"
+#include "mis_m.h"
 #include "sdlhelper.h"
 #include "newmis.h"
 #include "gr.h"
 #include "pace.h"
+#include "media_clock.h"
 #include "endianness.h"
 
 #define FRM_Delay 22
@@ -63,16 +65,26 @@ struct OF {
     int16_t idx;
 };
 
-struct Infin *Mob;
-struct OF *Mob2;
-int tFrames, cFrame;
-char SHTS[4];
-int32_t aLoc;
-display::LegacySurface *dply;
-struct AnimType AHead;
-struct BlockHead BHead;
-
-char STEPnum;
+GAME_LOCAL struct Infin *Mob;
+GAME_LOCAL struct OF *Mob2;
+GAME_LOCAL int tFrames, cFrame;
+GAME_LOCAL char SHTS[4];
+GAME_LOCAL int32_t aLoc;
+GAME_LOCAL display::LegacySurface *dply;
+GAME_LOCAL struct AnimType AHead;
+GAME_LOCAL struct BlockHead BHead;
+GAME_LOCAL_RESET(Mob);
+GAME_LOCAL_RESET(Mob2);
+GAME_LOCAL_RESET(tFrames);
+GAME_LOCAL_RESET(cFrame);
+GAME_LOCAL_RESET(SHTS);
+GAME_LOCAL_RESET(aLoc);
+GAME_LOCAL_RESET(dply);
+GAME_LOCAL_RESET(AHead);
+GAME_LOCAL_RESET(BHead);
+
+GAME_LOCAL char STEPnum;
+GAME_LOCAL_RESET(STEPnum);
 char daysAMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
 void Tick(char plr);
@@ -114,7 +126,7 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
     unsigned int fres, max;
     char lnch = 0, AEPT, BABY, Tst2, Tst3;
     unsigned char sts = 0, fem = 0;
-    FILE *fout, *ffin, *nfin;
+    FILE *ffin, *nfin;
     struct oGROUP *bSeq, aSeq;
     struct oFGROUP *dSeq, cSeq;
     struct Table *F;
@@ -125,6 +137,7 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
     FILE *mmfp;
     float fps;
     int hold_count;
+    struct media_clock clock;
     const int SCRATCH_SIZE = 64000;
     char scratch[SCRATCH_SIZE];
 
@@ -135,11 +148,13 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
     F = NULL; /* XXX check uninitialized */
     i = j = 0; /* XXX check uninitialized */
 
-    memset(buffer, 0x00, BUFFER_SIZE);
-    SHTS[0] = brandom(10);
-    SHTS[1] = brandom(10);
-    SHTS[2] = brandom(10);
-    SHTS[3] = brandom(10);
+    if (!dryRun) {
+        memset(buffer, 0x00, BUFFER_SIZE);
+        SHTS[0] = brandom(10);
+        SHTS[1] = brandom(10);
+        SHTS[2] = brandom(10);
+        SHTS[3] = brandom(10);
+    }
 
     if (fEarly && step != 0) {
         return;    //Specs: unmanned mission cut short
@@ -216,6 +231,11 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
         }
     }
 
+    // the kludges above change how the step fails; the rest only plays
+    if (dryRun) {
+        return;
+    }
+
     //Specs: launch sync
     if (Seq[0] == '#') {
         lnch = 1;
@@ -386,18 +406,13 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
         memcpy(&cSeq, &dSeq[j], sizeof cSeq);
     }
 
-    fout = sOpen("REPLAY.TMP", "at", 1);
-
-    if (mode == 0) {
-        fprintf(fout, "%d\n", (unsigned int)j);
+    // Specs: mode==1 save out fail seq (i*1000)+j
+    if (Rep.Qty < ARRAY_LENGTH(Rep.Off)) {
+        Rep.Off[Rep.Qty++] = (mode == 0) ? j : (i + 1) * 1000 + j;
     } else {
-        i += 1;
-        fprintf(fout, "%d\n", (unsigned int)(i * 1000 + j));
+        WARNING2("too many sequences to replay, dropping %d", j);
     }
 
-    // Specs: mode==1 save out fail seq (i*1000)+j
-    fclose(fout);
-
     if (AI[plr] == 1) {
         return;
     }
@@ -457,6 +472,7 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
     }
 
     keep_going = 1;
+    media_clock_start(&clock, "mission");
 
     while (keep_going && i < (int)max) {
         int aidx, sidx;
@@ -500,8 +516,11 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
         j = 0;
 
         hold_count = 0;
+        media_clock_restart(&clock, 0);
 
         while (keep_going) {
+            int shown = 0;
+
             av_step();
 
             if (BABY == 0 && !fullscreenMissionPlayback) {
@@ -509,9 +528,18 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
             }
 
             if (hold_count == 0) {
+                double start = get_time();
 
-                /** \todo track decoding time and adjust delays */
-                if (mm_decode_video(&vidfile, display::graphics.videoOverlay()) <= 0) {
+                if (mm_decode_video_frame(&vidfile) <= 0) {
+                    break;
+                }
+
+                shown = media_clock_wait(&clock,
+                                         MAX(mm_video_time(&vidfile), 0),
+                                         1.0 / fps, get_time() - start);
+
+                if (shown && mm_show_video(&vidfile,
+                                           display::graphics.videoOverlay()) < 0) {
                     break;
                 }
 
@@ -557,8 +585,9 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
                 display::graphics.videoRect().w = MAX_X / 2;
             }
 
-            /** \todo idle_loop is too inaccurate for this */
-            idle_loop_secs(1.0 / fps);
+            if (shown) {
+                gr_sync();
+            }
 
             if (sts < 23) {
                 if (BABY == 0 && !fullscreenMissionPlayback) {
@@ -577,7 +606,10 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
                 }
 
                 if (Data->Def.Anim) {
+                    double start = get_time();
+
                     idle_loop(FRM_Delay * 3);
+                    media_clock_hold(&clock, get_time() - start);
                 }
 
                 j++;
@@ -589,6 +621,8 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
         i++;
     }
 
+    media_clock_stop(&clock);
+
     if (!IsChannelMute(AV_SOUND_CHANNEL)) {
         if (lnch == 0) {
             PlayAudio("wh.ogg", 0);
@@ -626,12 +660,19 @@ void PlaySequence(char plr, int step, const char *InSeq, char mode)
     DEBUG1("<-PlaySequence()");
 }
 
+/* the mission clock of Tick(), and when it last moved */
+static GAME_LOCAL int Sec = 1, Min = 0, Hour = 5, Day = 5;
+static GAME_LOCAL double last;
+GAME_LOCAL_RESET(Sec);
+GAME_LOCAL_RESET(Min);
+GAME_LOCAL_RESET(Hour);
+GAME_LOCAL_RESET(Day);
+GAME_LOCAL_RESET(last);
+
 void Tick(char plr)
 {
-    static int Sec = 1, Min = 0, Hour = 5, Day = 5;
     int g, change = 0;
     double now;
-    static double last;
 
 //: Specs: reset clocks
     if (plr == 2) {
@@ -784,12 +825,16 @@ void Clock(char plr, char clck, char mode, char tm)
     }
 }
 
+/* the corner DoPack() last picked, and its static frame */
+static GAME_LOCAL char kk = 0, bub = 0;
+GAME_LOCAL_RESET(kk);
+GAME_LOCAL_RESET(bub);
+
 void DoPack(char plr, FILE *ffin, char mode, char *cde, char *fName)
 {
     int x, y, attempt, which, mx2, mx1;
     uint16_t *bot, off = 0;
     int32_t locl;
-    static char kk = 0, bub = 0;
     char Val1[12], Val2[12], loc;
 
     memset(Val1, 0x00, sizeof Val1);
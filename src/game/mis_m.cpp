@@ -42,22 +42,33 @@
 #include "gr.h"
 #include "pace.h"
 #include "endianness.h"
+#include "fail_table.h"
 
 LOG_DEFAULT_CATEGORY(mission)
 
-char MFlag;
-char death;
-char durx;
-char MPad;
-char Unm;
-char SCRUBS;
-char noDock;
-char InSpace;
-char Dock_Skip; /**< used for mission branching */
-
-extern uint16_t MisStat;
-extern char tMen;
-extern bool fullscreenMissionPlayback;
+GAME_LOCAL char MFlag;
+GAME_LOCAL char death;
+GAME_LOCAL char durx;
+GAME_LOCAL char MPad;
+GAME_LOCAL char Unm;
+GAME_LOCAL char SCRUBS;
+GAME_LOCAL char noDock;
+GAME_LOCAL char InSpace;
+GAME_LOCAL char Dock_Skip; /**< used for mission branching */
+GAME_LOCAL char dryRun;    /**< fly without playing clips or waiting */
+GAME_LOCAL_RESET(MFlag);
+GAME_LOCAL_RESET(death);
+GAME_LOCAL_RESET(durx);
+GAME_LOCAL_RESET(MPad);
+GAME_LOCAL_RESET(Unm);
+GAME_LOCAL_RESET(SCRUBS);
+GAME_LOCAL_RESET(noDock);
+GAME_LOCAL_RESET(InSpace);
+GAME_LOCAL_RESET(Dock_Skip);
+GAME_LOCAL_RESET(dryRun);
+
+extern GAME_LOCAL uint16_t MisStat;
+extern GAME_LOCAL char tMen;
 
 void Tick(char);
 
@@ -87,8 +98,9 @@ int FailEval(char plr, int type, char *text, int val, int xtra);
  * per is designed so each entry's per sits within [0, 10000) and
  * the relative values create an uneven probability distribution.
  *
- * TODO: Add error handling in case FName does not match a code.
- * At minimum, log an error. Preferably, throw an exception.
+ * The reports come from the table LoadFailTable() builds from
+ * FAILS.CDR, so this does no disk I/O. If FName does not match a code,
+ * an error is logged and Now is left alone.
  *
  * \param Now    destination for the fail state read from the file
  *               (Not NULL).
@@ -100,76 +112,10 @@ void GetFailStat(struct XFails *Now, char *FName, int rnum)
 {
     DEBUG2("->GetFailStat(struct XFails *Now,char *FName,int rnum %d)",
            rnum);
-    FILE *fin;
-    int32_t count;
-    struct Fdt {
-        char Code[6];
-        int32_t offset;
-        int16_t size;
-    } Pul;
-
-    // const size_t sizeof_Pul = 6 + 4 + 2;
-    // const size_t sizeof_XFails = 4 + 2 + 2 + 2 + 2 + 200;
 
     assert(Now != NULL);
 
-    fin = sOpen("FAILS.CDR", "rb", 0);
-    count = 44;
-    fread(&count, sizeof count, 1, fin);  // never written to file
-    Swap32bit(count);
-
-    int i = 0;
-
-    do {
-        fread(&Pul.Code[0], sizeof Pul.Code, 1, fin);
-        fread(&Pul.offset, sizeof Pul.offset, 1, fin);
-        Swap32bit(Pul.offset);
-        fread(&Pul.size, sizeof Pul.size, 1, fin);
-        Swap16bit(Pul.size);
-    } while (xstrncasecmp(Pul.Code, FName, 4) != 0 && ++i < count);
-
-    // This uses short-circuit evaluation to distinguish between
-    // string match and iterator comparison.
-
-    if (i == count) {
-        fclose(fin);
-        return;
-    }
-
-    fseek(fin, Pul.offset, SEEK_SET);
-
-    if (rnum < 0) { // Unmanned portion
-        do {
-            // Only need to swap Now->per since we're checking only that
-            fread(&Now->per, sizeof(Now->per), 1, fin);
-            fread(&Now->code, sizeof(Now->code), 1, fin);
-            fread(&Now->val, sizeof(Now->val), 1, fin);
-            fread(&Now->xtra, sizeof(Now->xtra), 1, fin);
-            fread(&Now->fail, sizeof(Now->fail), 1, fin);
-            fread(&Now->text[0], sizeof(Now->text), 1, fin);
-            Swap32bit(Now->per);
-            Swap16bit(Now->code);
-            Swap16bit(Now->val);
-            Swap16bit(Now->xtra);
-            Swap16bit(Now->fail);
-        } while (Now->per != rnum);
-    } else {
-        do {
-            fread(&Now->per, sizeof(Now->per), 1, fin);
-            fread(&Now->code, sizeof(Now->code), 1, fin);
-            fread(&Now->val, sizeof(Now->val), 1, fin);
-            fread(&Now->xtra, sizeof(Now->xtra), 1, fin);
-            fread(&Now->fail, sizeof(Now->fail), 1, fin);
-            fread(&Now->text[0], sizeof(Now->text), 1, fin);
-            Swap32bit(Now->per);
-            Swap16bit(Now->code);
-            Swap16bit(Now->val);
-            Swap16bit(Now->xtra);
-            Swap16bit(Now->fail);
-        } while (Now->per <= rnum);
-    }
-
-    fclose(fin);
+    FindFailStat(FName, rnum, Now);
 
     DEBUG1("<-GetFailStat()");
 }
@@ -237,7 +183,7 @@ void MisCheck(char plr, char mpad)
     }
 
     do {
-        if (STEP > 30 || STEP < 0) {
+        if ((STEP > 30 || STEP < 0) && !dryRun) {
             delay(20);
         }
 
@@ -290,9 +236,9 @@ void MisCheck(char plr, char mpad)
         }
 
         if (Mev[STEP].Name[0] == 'A') {
-            display::graphics.setForegroundColor(11);
-
             if (!AI[plr] && !fullscreenMissionPlayback) {
+                display::graphics.setForegroundColor(11);
+
                 if (plr == 0) {
                     x = 5;
                     y = 112;
@@ -573,7 +519,7 @@ void MisCheck(char plr, char mpad)
             Mev[STEP].trace = 0x7f;
         }
 
-        if (STEP > 30 || STEP < 0) {
+        if ((STEP > 30 || STEP < 0) && !dryRun) {
             delay(20);
         }
 
@@ -1297,11 +1243,13 @@ int FailEval(char plr, int type, char *text, int val, int xtra)
     VerifySF(plr);  // Keep all safeties within the proper ranges
 
     // check for all astros that are dead.  End mission if this is the case.
-    while (bioskey(1)) {
-        bioskey(0);
-    }
+    if (!dryRun) {
+        while (bioskey(1)) {
+            bioskey(0);
+        }
 
-    key = 0;
+        key = 0;
+    }
 
     if (!AI[plr]) {
         temp = FailureMode(plr, FNote, text);
@@ -1,8 +1,11 @@
 #ifndef MIS_M_H
 #define MIS_M_H
 
+#include "game_context.h"
+
 void MisCheck(char plr, char mpad);
 
-extern char death;
+extern GAME_LOCAL char death;
+extern GAME_LOCAL char dryRun;
 
 #endif // MIS_M_H
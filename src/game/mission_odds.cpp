@@ -0,0 +1,466 @@
+// This file estimates mission outcomes by flying missions without the UI
+
+#include "mission_odds.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL/SDL.h>
+
+#include "Buzz_inc.h"
+#include "game_context.h"
+#include "game_main.h"
+#include "game_snapshot.h"
+#include "mc.h"
+#include "mc2.h"
+#include "mis_m.h"
+#include "prest.h"
+#include "rng.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(mission)
+
+#define ODDS_CHUNK      4096    /* rollouts worth a thread of their own */
+#define ODDS_THREADS    8
+#define ODDS_CACHED     8       /* odds mission_odds() remembers */
+
+struct odds_job {
+    const struct odds_model *m;
+    uint64_t seed;
+    int rollouts;
+    int count[ODDS_OUTCOMES];
+};
+
+/* odds already worked out, and what they were worked out from */
+struct odds_cached {
+    uint64_t key;
+    int rollouts;
+    struct mission_odds odds;
+};
+
+static GAME_LOCAL struct odds_cached odds_cache[ODDS_CACHED];
+static GAME_LOCAL int odds_cache_next;
+GAME_LOCAL_RESET(odds_cache);
+GAME_LOCAL_RESET(odds_cache_next);
+
+/* FNV-1a of size bytes at p, on from hash h */
+static uint64_t
+odds_hash(uint64_t h, const void *p, size_t size)
+{
+    const unsigned char *c = (const unsigned char *)p;
+
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ c[i]) * 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+/* p, which points into from, moved to the same place in to */
+template <typename T>
+static T *
+rebase(T *p, const struct Players *from, struct Players *to)
+{
+    if (p == NULL) {
+        return NULL;
+    }
+
+    assert((const char *)p >= (const char *)from &&
+           (const char *)p < (const char *)(from + 1));
+    return (T *)((char *)to + ((const char *)p - (const char *)from));
+}
+
+/* keep the globals LaunchSetup() has filled in, pointing into data */
+static void
+read_model(char plr, char mis, struct odds_model *m, struct Players *data)
+{
+    int i, j;
+
+    memcpy(data, Data, sizeof(*data));
+    m->data = data;
+    m->mis = Mis;
+    m->plr = plr;
+    m->pad = mis;
+    m->ai = AI[plr];
+    m->steps = STEP;
+    m->joint = JOINT;
+    m->mcc = mcc;
+    m->early = fEarly;
+
+    for (i = 0; i < 60; i++) {
+        m->mev[i] = Mev[i];
+        m->mev[i].E = rebase(Mev[i].E, Data, data);
+    }
+
+    for (i = 0; i < 2; i++) {
+        m->manned[i] = MANNED[i];
+        m->cap[i] = CAP[i];
+        m->lm[i] = LM[i];
+        m->doc[i] = DOC[i];
+        m->eva[i] = EVA[i];
+
+        for (j = 0; j < 8; j++) {
+            m->mh[i][j] = rebase(MH[i][j], Data, data);
+        }
+
+        for (j = 0; j < 4; j++) {
+            m->ma[i][j] = MA[i][j];
+            m->ma[i][j].A = rebase(MA[i][j].A, Data, data);
+        }
+    }
+}
+
+/* put a model into the globals of this thread, and its steps into mev */
+static void
+load_model(const struct odds_model *m, struct MisEval *mev)
+{
+    int i, j;
+
+    memcpy(Data, m->data, sizeof(*Data));
+    Mis = m->mis;
+    JOINT = m->joint;
+    mcc = m->mcc;
+    fEarly = m->early;
+
+    for (i = 0; i < 60; i++) {
+        mev[i] = m->mev[i];
+        mev[i].E = rebase(m->mev[i].E, m->data, Data);
+    }
+
+    for (i = 0; i < 2; i++) {
+        MANNED[i] = m->manned[i];
+        CAP[i] = m->cap[i];
+        LM[i] = m->lm[i];
+        DOC[i] = m->doc[i];
+
+        for (j = 0; j < 8; j++) {
+            MH[i][j] = rebase(m->mh[i][j], m->data, Data);
+        }
+
+        for (j = 0; j < 4; j++) {
+            MA[i][j] = m->ma[i][j];
+            MA[i][j].A = rebase(m->ma[i][j].A, m->data, Data);
+        }
+    }
+
+    dryRun = 1;
+}
+
+/* fly a loaded model once, the way Launch() does */
+static int
+fly(const struct odds_model *m, const struct MisEval *mev)
+{
+    /* what of the player's a flight can change: hardware, pads,
+     * astronauts, crews and the missions planned */
+    const size_t from = offsetof(struct BuzzData, Probe);
+    const size_t to = offsetof(struct BuzzData, History);
+    char plr = m->plr;
+    int i;
+
+    memcpy((char *)&Data->P[plr] + from,
+           (const char *)&m->data->P[plr] + from, to - from);
+    memcpy(Mev, mev, sizeof(Mev));
+    EVA[0] = m->eva[0];
+    EVA[1] = m->eva[1];
+
+    /* roll for the player, but fly as the computer, who never scrubs */
+    AI[plr] = m->ai;
+
+    for (i = 0; i < m->steps; i++) {
+        if (Mev[i].E != NULL) {
+            MisRoll(plr, i);
+        }
+    }
+
+    AI[plr] = 1;
+    MisCheck(plr, m->pad);
+
+    return mission_odds_outcome(MANNED[0] + MANNED[1] == 0, MaxFail());
+}
+
+static int
+odds_thread(void *arg)
+{
+    struct odds_job *job = (struct odds_job *)arg;
+    struct MisEval mev[60];
+    struct GameContext ctx;
+
+    game_context_init(&ctx);
+    game_context_reset(&ctx);
+    load_model(job->m, mev);
+    rng_seed(&game_rng, job->seed);
+
+    for (int i = 0; i < job->rollouts; i++) {
+        job->count[fly(job->m, mev)]++;
+    }
+
+    game_context_free(&ctx);
+    return 0;
+}
+
+/* every seat the plan fills has somebody in it */
+static int
+crew_ready(char plr, const struct MissionType *plan)
+{
+    for (int i = 0; i < 1 + plan[0].Joint; i++) {
+        const struct MissionType *m = &plan[i];
+        int crew = (m->PCrew > 0) ? m->PCrew : m->BCrew;
+
+        if (m->Men == 0) {
+            continue;
+        }
+
+        if (m->Men > ASTRONAUT_FLT_CREW_MAX || crew < 1 ||
+            crew > ASTRONAUT_CREW_MAX || m->Prog < 0 ||
+            m->Prog > ASTRONAUT_POOLS) {
+            return 0;
+        }
+
+        for (int j = 0; j < m->Men; j++) {
+            if (Data->P[plr].Crew[m->Prog][crew - 1][j] <= 0) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Set a planned mission up the way Launch() would, and keep what is
+ * needed to fly it again and again.  The game, and the Mis the
+ * planning screens look at, are put back the way they were afterwards.
+ * Not for use while a mission is being flown, as this reuses the
+ * globals of mc.h.
+ *
+ * \param plan  the mission, followed by its second part if it is a
+ * joint one; it may be one of Data->P[plr].Mission, or a copy
+ * FAILS.CDR must have been loaded by LoadFailTable() beforehand, as
+ * the rollouts have no way to report failing to.
+ *
+ * \return 0, or -1 if there is no mission or it lacks a crew; free
+ * the model with mission_odds_model_free() after a 0
+ */
+int
+mission_odds_model(char plr, const struct MissionType *plan,
+                   struct odds_model *model)
+{
+    struct MissionType *pads = Data->P[plr].Mission;
+    struct Players *data;
+    struct game_snapshot *snap;
+    struct mStr keep = Mis;
+    int mis = 0;
+
+    assert(plan && model);
+
+    if (plan[0].MissionCode == Mission_None || plan[0].part == 1 ||
+        !crew_ready(plr, plan)) {
+        return -1;
+    }
+
+    data = (struct Players *)xmalloc(sizeof(*data));
+    snap = game_snapshot_fork();
+
+    /* fly from the plan's own pad, as steps look missions up by pad */
+    if (plan >= pads && plan < pads + MAX_LAUNCHPADS) {
+        mis = plan - pads;
+    } else {
+        memmove(&pads[0], plan, (1 + plan[0].Joint) * sizeof(*plan));
+    }
+
+    STEP = FINAL = JOINT = PastBANG = 0;
+    memset(MH, 0x00, sizeof MH);
+    memset(Mev, 0x00, sizeof Mev);
+
+    if (pads[mis].MissionCode == Mission_SubOrbital) {
+        pads[mis].Duration = 1;
+    }
+
+    MANNED[0] = pads[mis].Men;
+    MANNED[1] = pads[mis].Joint ? pads[mis + 1].Men : 0;
+    JOINT = pads[mis].Joint;
+
+    try {
+        LaunchSetup(plr, mis);
+        read_model(plr, mis, model, data);
+    } catch (...) {
+        game_snapshot_restore(snap);
+        game_snapshot_free(snap);
+        free(data);
+        Mis = keep;
+        throw;
+    }
+
+    game_snapshot_restore(snap);
+    game_snapshot_free(snap);
+    Mis = keep;
+    return 0;
+}
+
+void
+mission_odds_model_free(struct odds_model *model)
+{
+    free(model->data);
+    model->data = NULL;
+}
+
+/**
+ * Fly a mission model many times over.  The rollouts are shared among
+ * up to ODDS_THREADS threads, each with a stream of its own from the
+ * seed, so the odds only depend on the model, the rollouts and the seed.
+ * None are flown on the calling thread, whose game mustn't change.
+ */
+void
+mission_odds_run(const struct odds_model *model, int rollouts,
+                 uint64_t seed, struct mission_odds *odds)
+{
+    struct odds_job jobs[ODDS_THREADS];
+    SDL_Thread *threads[ODDS_THREADS];
+    int n = (rollouts + ODDS_CHUNK - 1) / ODDS_CHUNK;
+    int i, k;
+
+    assert(model && odds);
+
+    n = MAX(1, MIN(n, ODDS_THREADS));
+    memset(jobs, 0, sizeof(jobs));
+
+    for (i = 0; i < n; i++) {
+        jobs[i].m = model;
+        jobs[i].seed = seed + i;
+        jobs[i].rollouts = MAX(rollouts, 0) / n + (i < MAX(rollouts, 0) % n);
+        threads[i] = SDL_CreateThread(odds_thread, &jobs[i]);
+
+        if (!threads[i]) {
+            WARNING3("can't fly %d rollouts: %s", jobs[i].rollouts,
+                     SDL_GetError());
+            jobs[i].rollouts = 0;
+        }
+    }
+
+    memset(odds, 0, sizeof(*odds));
+
+    for (i = 0; i < n; i++) {
+        if (threads[i]) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+
+        odds->rollouts += jobs[i].rollouts;
+    }
+
+    for (k = 0; k < ODDS_OUTCOMES; k++) {
+        for (i = 0; i < n; i++) {
+            odds->count[k] += jobs[i].count[k];
+        }
+
+        odds->p[k] = odds->rollouts ? (double)odds->count[k] / odds->rollouts : 0;
+        mission_odds_interval(odds->count[k], odds->rollouts,
+                              &odds->low[k], &odds->high[k]);
+    }
+}
+
+/**
+ * The odds of a planned mission, for the planning screens.  The seed
+ * comes from the game's random stream, without drawing on it, so asking
+ * again before anything happens gives the same answer.  The last few
+ * answers are kept, and given again while the plan, the seed and the
+ * player's game are unchanged, so a screen may ask on every redraw.
+ *
+ * \return 0, or -1 if the mission can't be flown as planned; when no
+ * rollout could be flown, odds->rollouts is 0 and the odds unknown
+ */
+int
+mission_odds(char plr, const struct MissionType *plan, int rollouts,
+             struct mission_odds *odds)
+{
+    struct odds_model model;
+    struct rng r = game_rng;
+    uint64_t seed = rng_next(&r);
+    uint64_t key = 0xcbf29ce484222325ULL;
+    struct odds_cached *c;
+
+    assert(plan && odds);
+
+    key = odds_hash(key, &plr, sizeof(plr));
+    key = odds_hash(key, &rollouts, sizeof(rollouts));
+    key = odds_hash(key, &seed, sizeof(seed));
+    key = odds_hash(key, plan, (1 + plan[0].Joint) * sizeof(*plan));
+    key = odds_hash(key, Data, sizeof(*Data));
+
+    for (int i = 0; i < ODDS_CACHED; i++) {
+        if (odds_cache[i].rollouts && odds_cache[i].key == key) {
+            *odds = odds_cache[i].odds;
+            return 0;
+        }
+    }
+
+    if (mission_odds_model(plr, plan, &model) != 0) {
+        return -1;
+    }
+
+    mission_odds_run(&model, rollouts, seed, odds);
+    mission_odds_model_free(&model);
+
+    DEBUG6("odds of %s: success %.3f, partial %.3f, death %.3f, all dead %.3f",
+           plan[0].Name, odds->p[ODDS_SUCCESS], odds->p[ODDS_PARTIAL],
+           odds->p[ODDS_DEATH], odds->p[ODDS_ALL_DEAD]);
+
+    if (odds->rollouts > 0) {
+        c = &odds_cache[odds_cache_next];
+        odds_cache_next = (odds_cache_next + 1) % ODDS_CACHED;
+        c->key = key;
+        c->rollouts = odds->rollouts;
+        c->odds = *odds;
+    }
+
+    return 0;
+}
+
+/**
+ * How the mission history screen reads a MaxFail() result.
+ *
+ * \param unmanned  nobody flew the mission
+ * \return an odds_outcome
+ */
+int
+mission_odds_outcome(int unmanned, int result)
+{
+    if (result < 500 || result >= 5000) {
+        return ODDS_SUCCESS;
+    } else if (unmanned || result == 1999) {
+        return ODDS_FAILURE;
+    } else if (result < 1999) {
+        return ODDS_PARTIAL;
+    } else if (result < 3000) {
+        return ODDS_INJURY;
+    } else if (result < 4000) {
+        return ODDS_DEATH;
+    }
+
+    return ODDS_ALL_DEAD;
+}
+
+/**
+ * The Wilson score interval at 95% for count out of rollouts, which
+ * stays within 0 to 1 even when count is 0 or all of them.
+ */
+void
+mission_odds_interval(int count, int rollouts, double *low, double *high)
+{
+    const double z = 1.96;
+    double n = rollouts, p, centre, half;
+
+    if (rollouts <= 0) {
+        *low = 0;
+        *high = 1;
+        return;
+    }
+
+    p = count / n;
+    centre = (p + z * z / (2 * n)) / (1 + z * z / n);
+    half = z * sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+    *low = MAX(0.0, centre - half);
+    *high = MIN(1.0, centre + half);
+}
@@ -0,0 +1,77 @@
+#ifndef MISSION_ODDS_H
+#define MISSION_ODDS_H
+
+/**
+ * \file mission_odds.h How likely a planned mission is to go well.
+ *
+ * The odds are found by flying the mission many times over with
+ * MisCheck() and FailEval() themselves, with fresh dice each time and
+ * #dryRun set, so no clip is played and nothing waits.
+ *
+ * mission_odds_model() sets the mission up on the calling thread the
+ * way Launch() does, inside a game snapshot, so the game is left as it
+ * was.  mission_odds_run() flies copies of the model on threads of its
+ * own, each with a game of its own and a random stream from the seed,
+ * so a seed gives the same odds every time.
+ *
+ * The VAB shows the odds of the hardware selected, and the Launch Pad
+ * menu those of each mission with hardware to fly on (see vab.h).
+ * mission_odds() remembers its last few answers, so redrawing a screen
+ * doesn't fly the mission again.  FAILS.CDR is loaded at startup.
+ *
+ * The rollouts fly the way the computer player does: a scrub offer is
+ * always turned down.  The one-clip replay rule of MissionPast() and
+ * the safety cheat are left out.
+ */
+
+#include <stdint.h>
+
+#include "data.h"
+
+/** how a mission turns out, as the mission history screen puts it */
+enum odds_outcome {
+    ODDS_SUCCESS,
+    ODDS_PARTIAL,           /**< partial failure */
+    ODDS_FAILURE,
+    ODDS_INJURY,
+    ODDS_DEATH,             /**< some of the crew lost */
+    ODDS_ALL_DEAD,          /**< a whole crew lost */
+    ODDS_OUTCOMES
+};
+
+/** a mission as LaunchSetup() leaves it, ready to be flown */
+struct odds_model {
+    struct Players *data;       /**< a copy of Data, which the pointers
+                                     below point into */
+    struct MisEval mev[60];     /**< Mev */
+    Equipment *mh[2][8];        /**< MH */
+    struct MisAst ma[2][4];     /**< MA */
+    struct mStr mis;            /**< Mis */
+    char manned[2], cap[2], lm[2], doc[2], eva[2];
+    char joint, mcc, early;     /**< JOINT, mcc and fEarly */
+    char plr;
+    char pad;                   /**< the pad the mission flies from */
+    char ai;                    /**< AI[plr], whom the dice are rolled for */
+    char steps;                 /**< steps in mev */
+};
+
+struct mission_odds {
+    int rollouts;
+    int count[ODDS_OUTCOMES];
+    double p[ODDS_OUTCOMES];    /**< share of the rollouts */
+    double low[ODDS_OUTCOMES];  /**< 95% confidence interval of p */
+    double high[ODDS_OUTCOMES];
+};
+
+int mission_odds_model(char plr, const struct MissionType *plan,
+                       struct odds_model *model);
+void mission_odds_model_free(struct odds_model *model);
+void mission_odds_run(const struct odds_model *model, int rollouts,
+                      uint64_t seed, struct mission_odds *odds);
+int mission_odds(char plr, const struct MissionType *plan, int rollouts,
+                 struct mission_odds *odds);
+int mission_odds_outcome(int unmanned, int result);
+void mission_odds_interval(int count, int rollouts,
+                           double *low, double *high);
+
+#endif /* MISSION_ODDS_H */
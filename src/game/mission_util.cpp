@@ -4,6 +4,7 @@
 
 #include <cstring>
 #include <cstdio>
+#include <vector>
 
 #include "Buzz_inc.h"
 #include "ioexception.h"
@@ -14,6 +15,7 @@ LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT);
 
 namespace
 {
+const std::vector<struct mStr> &MissionPlans();
 bool MarsInRange(unsigned int year, unsigned int season);
 bool JupiterInRange(unsigned int year, unsigned int season);
 bool SaturnInRange(unsigned int year, unsigned int season);
@@ -144,46 +146,30 @@ const char *GetDurationParens(int duration)
 
 /* Gets the mission template for the specified mission code.
  *
- * Opens "MISSION.DAT" and loads the mission data from the file.
+ * MISSION.DAT is read into memory by the first call, and later calls
+ * are served from that copy.
  *
  * TODO: This is dependent on the exact size of internal structures.
  *       MISSION.DAT relies on 226-byte mStr structs.
  *
  * \param code  A unique index for the mission.
  * \return  the mStr with the given mStr.Index value.
- * \throws IOException  if unable to read MISSION.DAT.
+ * \throws IOException  if unable to read MISSION.DAT, or if there is
+ *                      no mission with that code.
  */
 struct mStr GetMissionPlan(const int code)
 {
-    mStr mission;
-    FILE *fin = sOpen("MISSION.DAT", "rb", 0);
-
-    if (! fin) {
-        throw IOException("Error opening file MISSION.DAT");
-    }
+    const std::vector<struct mStr> &plans = MissionPlans();
 
-    // Find Mission Type
-    if (fseek(fin, code * (sizeof(struct mStr)), SEEK_SET)) {
-        char error[1000];
-        sprintf(error, "Error %d while seeking position in file "
-                "MISSION.DAT: Seeking position %lu"
-                " (%d blocks of size %lu)",
-                ferror(fin),
-                static_cast<const size_t>(code) * (sizeof(struct mStr)),
-                code, sizeof(struct mStr));
-        fclose(fin);
+    if (code < 0 || static_cast<size_t>(code) >= plans.size()) {
+        char error[200];
+        snprintf(error, sizeof(error), "No mission %d in MISSION.DAT "
+                 "(%lu missions)", code,
+                 static_cast<unsigned long>(plans.size()));
         throw IOException(error);
-        // throw IOException("Error seeking position in file MISSION.DAT");
-    }
-
-    if (fread(&mission, sizeof(struct mStr), 1, fin) != 1) {
-        fclose(fin);
-        throw IOException("Error reading from file MISSION.DAT");
     }
 
-    fclose(fin);
-
-    return mission;
+    return plans[code];
 }
 
 
@@ -221,6 +207,49 @@ bool MissionTimingOk(int mission, unsigned int year, unsigned int season)
 namespace  // Start of local namespace
 {
 
+/* Reads every mission template in MISSION.DAT.
+ *
+ * mStr holds only single-byte fields, so the records need no byte
+ * swapping.
+ */
+std::vector<struct mStr> LoadMissionPlans()
+{
+    std::vector<struct mStr> plans;
+    struct mStr mission;
+    FILE *fin = sOpen("MISSION.DAT", "rb", 0);
+
+    if (! fin) {
+        throw IOException("Error opening file MISSION.DAT");
+    }
+
+    while (fread(&mission, sizeof(struct mStr), 1, fin) == 1) {
+        plans.push_back(mission);
+    }
+
+    if (ferror(fin) || plans.empty()) {
+        fclose(fin);
+        throw IOException("Error reading from file MISSION.DAT");
+    }
+
+    fclose(fin);
+
+    return plans;
+}
+
+
+/* The mission templates, loaded on first use.
+ *
+ * The compiler guards initialization of the local static, so concurrent
+ * first calls load the file only once. If loading throws, the next call
+ * tries again.
+ */
+const std::vector<struct mStr> &MissionPlans()
+{
+    static const std::vector<struct mStr> plans(LoadMissionPlans());
+    return plans;
+}
+
+
 /* Is Mars at the right point in its orbit where a rocket launched at
  * the given time will be able to intercept it?
  */
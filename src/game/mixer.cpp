@@ -0,0 +1,207 @@
+// This file mixes 16-bit PCM samples for the audio callback.
+
+#include "display/simd.h"
+
+#include "mixer.h"
+
+#include <assert.h>
+
+/*
+ * Every kernel computes dst + ((src * gain) >> 16) * 2 with saturation,
+ * which is what SSE2 pmulhw/paddsw give us, so the scalar and vector
+ * paths produce identical output.
+ */
+static inline int16_t
+mix_sample(int16_t dst, int16_t src, int gain)
+{
+    int v = dst + ((src * gain) >> 16) * 2;
+
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (int16_t) v;
+}
+
+static void
+mix_scalar(int16_t *dst, const int16_t *src, unsigned samples, int gain)
+{
+    unsigned i;
+
+    for (i = 0; i < samples; ++i) {
+        dst[i] = mix_sample(dst[i], src[i], gain);
+    }
+}
+
+#ifdef DISPLAY_SIMD_X86
+
+DISPLAY_SIMD_TARGET("sse2")
+static void
+mix_sse2(int16_t *dst, const int16_t *src, unsigned samples, int gain)
+{
+    const __m128i g = _mm_set1_epi16((short) gain);
+    unsigned i = 0;
+
+    for (; i + 8 <= samples; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        s = _mm_slli_epi16(_mm_mulhi_epi16(s, g), 1);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_adds_epi16(d, s));
+    }
+
+    mix_scalar(dst + i, src + i, samples - i, gain);
+}
+
+DISPLAY_SIMD_TARGET("avx2")
+static void
+mix_avx2(int16_t *dst, const int16_t *src, unsigned samples, int gain)
+{
+    const __m256i g = _mm256_set1_epi16((short) gain);
+    unsigned i = 0;
+
+    for (; i + 16 <= samples; i += 16) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        s = _mm256_slli_epi16(_mm256_mulhi_epi16(s, g), 1);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_adds_epi16(d, s));
+    }
+
+    mix_sse2(dst + i, src + i, samples - i, gain);
+}
+
+#endif
+
+typedef void (*mix_function)(int16_t *, const int16_t *, unsigned, int);
+
+static mix_function mix_kernel;
+static const char *mix_kernel_name;
+
+static void
+choose_kernel(void)
+{
+    mix_kernel = mix_scalar;
+    mix_kernel_name = "scalar";
+
+#ifdef DISPLAY_SIMD_X86
+
+    if (display::simd::hasAVX2()) {
+        mix_kernel = mix_avx2;
+        mix_kernel_name = "avx2";
+    } else if (display::simd::hasSSE2()) {
+        mix_kernel = mix_sse2;
+        mix_kernel_name = "sse2";
+    }
+
+#endif
+}
+
+/** Gain for a channel at volume out of max_volume, when voices channels
+ * are mixed together. Dividing by the number of voices keeps the sum of
+ * full scale sources from clipping.
+ */
+int
+mixer_gain(unsigned volume, unsigned max_volume, unsigned voices)
+{
+    assert(max_volume > 0 && voices > 0);
+
+    if (volume > max_volume) {
+        volume = max_volume;
+    }
+
+    return (int)(volume * (unsigned) MIXER_UNITY_GAIN / max_volume / voices);
+}
+
+/** Start a voice at gain, without ramping. */
+void
+mixer_init_voice(struct mixer_voice *voice, int gain)
+{
+    assert(gain >= 0 && gain <= MIXER_UNITY_GAIN);
+
+    voice->gain = gain;
+    voice->target = gain;
+}
+
+/** Change the gain of a voice; the new gain is reached gradually. */
+void
+mixer_set_gain(struct mixer_voice *voice, int gain)
+{
+    assert(gain >= 0 && gain <= MIXER_UNITY_GAIN);
+
+    voice->target = gain;
+}
+
+/** Does mixing this voice have no effect? */
+int
+mixer_voice_silent(const struct mixer_voice *voice)
+{
+    return voice->gain == 0 && voice->target == 0;
+}
+
+/**
+ * Add samples from src to dst, scaled by the gain of voice.
+ *
+ * While the voice is ramping the gain changes by at most
+ * MIXER_UNITY_GAIN / MIXER_RAMP_SAMPLES per sample; this part is done one
+ * sample at a time, the steady state by the fastest available kernel.
+ */
+void
+mixer_mix(int16_t *dst, const int16_t *src, unsigned samples,
+          struct mixer_voice *voice)
+{
+    const int step = MIXER_UNITY_GAIN / MIXER_RAMP_SAMPLES;
+    unsigned i = 0;
+
+    if (!mix_kernel) {
+        choose_kernel();
+    }
+
+    while (voice->gain != voice->target && i < samples) {
+        if (voice->gain < voice->target) {
+            voice->gain += step;
+
+            if (voice->gain > voice->target) {
+                voice->gain = voice->target;
+            }
+        } else {
+            voice->gain -= step;
+
+            if (voice->gain < voice->target) {
+                voice->gain = voice->target;
+            }
+        }
+
+        dst[i] = mix_sample(dst[i], src[i], voice->gain);
+        ++i;
+    }
+
+    if (i < samples && voice->gain) {
+        mix_kernel(dst + i, src + i, samples - i, voice->gain);
+    }
+}
+
+/** Name of the kernel mixer_mix() uses on this CPU. */
+const char *
+mixer_kernel_name(void)
+{
+    if (!mix_kernel) {
+        choose_kernel();
+    }
+
+    return mix_kernel_name;
+}
+
+/** Force the portable kernel (non-zero) or go back to the fastest one. */
+void
+mixer_use_scalar(int scalar)
+{
+    choose_kernel();
+
+    if (scalar) {
+        mix_kernel = mix_scalar;
+        mix_kernel_name = "scalar";
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include <stdint.h>
+
+/**
+ * \file mixer.h Sample mixing for the audio callback.
+ *
+ * Gains are Q15 fixed point, so MIXER_UNITY_GAIN leaves a sample unchanged.
+ * Mixing saturates instead of wrapping around, and gain changes are spread
+ * over MIXER_RAMP_SAMPLES samples so they don't click.
+ */
+
+#define MIXER_UNITY_GAIN    32767
+#define MIXER_RAMP_SAMPLES  256
+
+struct mixer_voice {
+    int gain;       /**< gain currently applied, Q15 */
+    int target;     /**< gain we are ramping towards, Q15 */
+};
+
+int mixer_gain(unsigned volume, unsigned max_volume, unsigned voices);
+void mixer_init_voice(struct mixer_voice *voice, int gain);
+void mixer_set_gain(struct mixer_voice *voice, int gain);
+int mixer_voice_silent(const struct mixer_voice *voice);
+void mixer_mix(int16_t *dst, const int16_t *src, unsigned samples,
+               struct mixer_voice *voice);
+const char *mixer_kernel_name(void);
+void mixer_use_scalar(int scalar);
+
+#endif /* MIXER_H */
@@ -38,6 +38,12 @@
 #include "fake_unistd.h"
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
 #include "mmfile.h"
 #include "macros.h"
 #include "utils.h"
@@ -45,6 +51,59 @@
 
 LOG_DEFAULT_CATEGORY(multimedia)
 
+/* Ogg page header: "OggS", version, flags, granule position, serial
+ * number, sequence number, CRC, segment count, then the segment table */
+#define OGG_HEADER_SIZE 27
+
+/**
+ * Point a page at the next one in a mapped file, without copying it.
+ * The CRC is not checked; a local file is trusted like any other.
+ *
+ * \return -1 on error
+ * \return  0 on end of file
+ * \return  1 on successful page read
+ */
+static int
+map_page(mm_file *mf, ogg_page *pg)
+{
+    const unsigned char *p = mf->map + mf->map_pos;
+    size_t left = mf->map_size - mf->map_pos;
+    size_t header, body = 0;
+    unsigned i;
+
+    /* a truncated last page is dropped, as ogg_sync would */
+    if (left < OGG_HEADER_SIZE) {
+        return 0;
+    }
+
+    if (memcmp(p, "OggS", 4) != 0) {
+        return -1;
+    }
+
+    header = OGG_HEADER_SIZE + p[OGG_HEADER_SIZE - 1];
+
+    if (left < header) {
+        return 0;
+    }
+
+    for (i = OGG_HEADER_SIZE; i < header; i++) {
+        body += p[i];
+    }
+
+    if (left < header + body) {
+        return 0;
+    }
+
+    /* libogg only reads pages, whatever the pointer types say */
+    pg->header = (unsigned char *) p;
+    pg->header_len = header;
+    pg->body = (unsigned char *) p + header;
+    pg->body_len = body;
+    mf->map_pos += header + body;
+
+    return (ogg_page_version(pg) == 0) ? 1 : -1;
+}
+
 /** --
  *
  * \return -1 on error
@@ -61,6 +120,10 @@ get_page(mm_file *mf, ogg_page *pg)
 
     assert(mf);
 
+    if (mf->map) {
+        return map_page(mf, pg);
+    }
+
     while (0 == (res = ogg_sync_pageout(&mf->sync, pg))) {
         p = ogg_sync_buffer(&mf->sync, bufsize);
 
@@ -77,6 +140,8 @@ get_page(mm_file *mf, ogg_page *pg)
             ERROR1("buffer overflow in ogg_sync_wrote");
             return -1;
         }
+
+        mf->copied += n;
     }
 
     /* XXX: following may segfault if non-ogg file is read */
@@ -313,22 +378,47 @@ end:
     return rval;
 }
 
+/* copy a plane in one go when both are laid out alike, else by rows */
+static void
+copy_plane(uint8_t *dst, int dst_pitch, const uint8_t *src, int src_pitch,
+           unsigned w, unsigned h)
+{
+    unsigned i;
+
+    if (!h) {
+        return;
+    }
+
+    if (dst_pitch == src_pitch && src_pitch > 0) {
+        memcpy(dst, src, (h - 1) * src_pitch + w);
+        return;
+    }
+
+    for (i = 0; i < h; ++i) {
+        memcpy(dst + i * dst_pitch, src + i * src_pitch, w);
+    }
+}
+
+/* copy the picture of a decoded frame to planes in overlay order */
 static int
-yuv_to_overlay(const mm_file *mf, const yuv_buffer *yuv, SDL_Overlay *ovl)
+yuv_to_planes(const mm_file *mf, const yuv_buffer *yuv, Uint32 format,
+              uint8_t *const *planes, const Uint16 *pitches,
+              unsigned ovl_w, unsigned ovl_h)
 {
-    unsigned i, h, w, xoff, yoff;
+    unsigned h, w, xoff, yoff;
     uint8_t *yp, *up, *vp;
 
     assert(mf);
     assert(yuv);
-    assert(ovl);
+    assert(planes);
+    assert(pitches);
 
-    h = MIN(mf->video_info->frame_height, (unsigned) ovl->h);
-    w = MIN(mf->video_info->frame_width, (unsigned) ovl->w);
+    h = MIN(mf->video_info->frame_height, ovl_h);
+    w = MIN(mf->video_info->frame_width, ovl_w);
     xoff = mf->video_info->offset_x;
     yoff = mf->video_info->offset_y;
 
-    switch (ovl->format) {
+    switch (format) {
     case SDL_IYUV_OVERLAY:
         up = yuv->u;
         vp = yuv->v;
@@ -357,16 +447,9 @@ yuv_to_overlay(const mm_file *mf, const yuv_buffer *yuv, SDL_Overlay *ovl)
         return -1;
     }
 
-    if (SDL_LockYUVOverlay(ovl) < 0) {
-        WARNING1("unable to lock overlay");
-        return -1;
-    }
-
     /* luna goes first */
-    for (i = 0; i < h; ++i) {
-        memcpy(ovl->pixels[0] + i * ovl->pitches[0],
-               yp + (i + yoff) * yuv->y_stride + xoff, w);
-    }
+    copy_plane(planes[0], pitches[0],
+               yp + yoff * yuv->y_stride + xoff, yuv->y_stride, w, h);
 
     xoff /= 2;
     yoff /= 2;
@@ -375,20 +458,35 @@ yuv_to_overlay(const mm_file *mf, const yuv_buffer *yuv, SDL_Overlay *ovl)
     h = h / 2 + h % 2;
 
     /* handle 2x2 subsampled u and v planes */
-    for (i = 0; i < h; ++i) {
-        memcpy(ovl->pixels[1] + i * ovl->pitches[1],
-               up + (i + yoff) * yuv->uv_stride + xoff, w);
-        memcpy(ovl->pixels[2] + i * ovl->pitches[2],
-               vp + (i + yoff) * yuv->uv_stride + xoff, w);
+    copy_plane(planes[1], pitches[1],
+               up + yoff * yuv->uv_stride + xoff, yuv->uv_stride, w, h);
+    copy_plane(planes[2], pitches[2],
+               vp + yoff * yuv->uv_stride + xoff, yuv->uv_stride, w, h);
+    return 0;
+}
+
+static int
+yuv_to_overlay(const mm_file *mf, const yuv_buffer *yuv, SDL_Overlay *ovl)
+{
+    int rv;
+
+    assert(ovl);
+
+    if (SDL_LockYUVOverlay(ovl) < 0) {
+        WARNING1("unable to lock overlay");
+        return -1;
     }
 
+    rv = yuv_to_planes(mf, yuv, ovl->format, ovl->pixels, ovl->pitches,
+                       ovl->w, ovl->h);
     SDL_UnlockYUVOverlay(ovl);
-    return 0;
+    return rv;
 }
 
-/* rval < 0: error, > 0: have audio or video */
-int
-mm_open_fp(mm_file *mf, FILE *file)
+/* set up decoders for the streams of a file opened either way
+ * rval < 0: error, > 0: have audio or video */
+static int
+open_streams(mm_file *mf)
 {
     int retval = -1;
     int res = 0;
@@ -396,21 +494,6 @@ mm_open_fp(mm_file *mf, FILE *file)
     int have_theora = 0;
     ogg_page pg;
 
-    assert(mf);
-    memset(mf, 0, sizeof(*mf));
-
-    mf->file = file;
-
-    // This is important.  If there is no file
-    // then we need to reset the audio and video
-    // pointers so that the other functions
-    // ignore the file.
-    if (!mf->file) {
-        mf->audio = NULL;
-        mf->video = NULL;
-        return retval;
-    }
-
     ogg_sync_init(&mf->sync);
 
     /* get first page to start things up */
@@ -456,6 +539,28 @@ err:
     return retval;
 }
 
+/* rval < 0: error, > 0: have audio or video */
+int
+mm_open_fp(mm_file *mf, FILE *file)
+{
+    assert(mf);
+    memset(mf, 0, sizeof(*mf));
+
+    mf->file = file;
+
+    // This is important.  If there is no file
+    // then we need to reset the audio and video
+    // pointers so that the other functions
+    // ignore the file.
+    if (!mf->file) {
+        mf->audio = NULL;
+        mf->video = NULL;
+        return -1;
+    }
+
+    return open_streams(mf);
+}
+
 int
 mm_open(mm_file *mf, const char *fname)
 {
@@ -465,6 +570,84 @@ mm_open(mm_file *mf, const char *fname)
     return mm_open_fp(mf, fopen(fname, "rb"));
 }
 
+/* read a whole file into memory, where it can't be mapped */
+static int
+read_whole(mm_file *mf, FILE *file)
+{
+    long size;
+
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 ||
+        fseek(file, 0, SEEK_SET) != 0) {
+        return -1;
+    }
+
+    mf->map = (unsigned char *)xmalloc(size ? size : 1);
+    mf->map_size = size;
+    mf->map_owned = 1;
+
+    if (fread((void *) mf->map, 1, size, file) != (size_t) size) {
+        return -1;
+    }
+
+    mf->copied += size;
+    return 0;
+}
+
+/**
+ * Open a file by mapping it into memory.  Ogg pages are then parsed in
+ * place instead of being copied through stdio and the ogg_sync buffer.
+ * Where mmap() is not available the file is read into memory in one go.
+ *
+ * \return rval < 0: error, > 0: have audio or video
+ */
+int
+mm_open_mapped(mm_file *mf, const char *fname)
+{
+    FILE *file;
+    int rv;
+
+    assert(mf);
+    assert(fname);
+    memset(mf, 0, sizeof(*mf));
+    INFO2("mapping file `%s'", fname);
+
+#ifdef HAVE_SYS_MMAN_H
+    {
+        int fd = open(fname, O_RDONLY);
+        struct stat st;
+
+        if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map != MAP_FAILED) {
+                close(fd);
+                mf->map = (const unsigned char *) map;
+                mf->map_size = st.st_size;
+                return open_streams(mf);
+            }
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+
+    if ((file = fopen(fname, "rb")) == NULL) {
+        return -1;
+    }
+
+    rv = read_whole(mf, file);
+    fclose(file);
+
+    if (rv < 0) {
+        mm_close(mf);
+        return -1;
+    }
+
+    return open_streams(mf);
+}
+
 unsigned
 mm_ignore(mm_file *mf, unsigned mask)
 {
@@ -484,6 +667,17 @@ mm_close(mm_file *mf)
         mf->file = NULL;
     }
 
+    if (mf->map) {
+#ifdef HAVE_SYS_MMAN_H
+        if (!mf->map_owned) {
+            munmap((void *) mf->map, mf->map_size);
+        } else
+#endif
+            free((void *) mf->map);
+
+        mf->map = NULL;
+    }
+
     if (mf->audio) {
         ogg_stream_destroy(mf->audio);
         mf->audio = NULL;
@@ -556,6 +750,34 @@ mm_video_info(const mm_file *mf, unsigned *width, unsigned *height,
     return 1;
 }
 
+/**
+ * Presentation time of the last decoded video frame, from its granule
+ * position.
+ *
+ * \return seconds from the start of the stream, or < 0 if no frame has
+ * been decoded yet or there is no video in file
+ */
+double
+mm_video_time(const mm_file *mf)
+{
+    ogg_int64_t frame;
+
+    assert(mf);
+
+    if (!mf->video || mf->video_ctx->granulepos < 0) {
+        return -1;
+    }
+
+    frame = theora_granule_frame(mf->video_ctx, mf->video_ctx->granulepos);
+
+    if (frame < 0) {
+        return -1;
+    }
+
+    return (double) frame * mf->video_info->fps_denominator
+           / mf->video_info->fps_numerator;
+}
+
 /**
  * \return rval < 0: no audio in file
  **/
@@ -579,12 +801,13 @@ mm_audio_info(const mm_file *mf, unsigned *channels, unsigned *rate)
     return 1;
 }
 
+/* Decode the next video frame, but don't show it yet.
+ * rval < 0: error, == 0: end of video, > 0: decoded */
 int
-mm_decode_video(mm_file *mf, SDL_Overlay *ovl)
+mm_decode_video_frame(mm_file *mf)
 {
     int rv = 0;
     ogg_packet pkt;
-    yuv_buffer yuv;
 
     assert(mf);
 
@@ -613,15 +836,210 @@ mm_decode_video(mm_file *mf, SDL_Overlay *ovl)
         }
     }
 
+    return 1;
+}
+
+/* Copy the last frame decoded by mm_decode_video_frame() to an overlay.
+ * rval < 0: error, 0: ok */
+int
+mm_show_video(mm_file *mf, SDL_Overlay *ovl)
+{
+    yuv_buffer yuv;
+
+    assert(mf);
+    assert(mf->video);
+
+    theora_decode_YUVout(mf->video_ctx, &yuv);
+    return yuv_to_overlay(mf, &yuv, ovl);
+}
+
+/* rval < 0: error, == 0: end of video, > 0: frame shown */
+int
+mm_decode_video(mm_file *mf, SDL_Overlay *ovl)
+{
+    int rv = mm_decode_video_frame(mf);
+
+    if (rv <= 0) {
+        return rv;
+    }
+
+    if (mm_show_video(mf, ovl) < 0) {
+        return -1;
+    }
+
+    return 1;
+}
+
+/* height of each plane of a 4:2:0 picture */
+static unsigned
+plane_height(unsigned plane, unsigned h)
+{
+    return plane ? h / 2 + h % 2 : h;
+}
+
+/**
+ * Allocate a ring of frames laid out like an overlay, so that showing
+ * one copies each plane in a single block.
+ *
+ * \return 0 on success, -1 if the overlay format is not planar
+ */
+int
+mm_ring_init(mm_frame_ring *ring, unsigned count, const SDL_Overlay *ovl)
+{
+    size_t frame_size = 0;
+    unsigned i, p;
+
+    assert(ring);
+    assert(ovl);
+    assert(count > 0);
+
+    memset(ring, 0, sizeof(*ring));
+
+    if (ovl->format != SDL_IYUV_OVERLAY && ovl->format != SDL_YV12_OVERLAY) {
+        WARNING1("only IYUV and YV12 SDL overlay formats supported");
+        return -1;
+    }
+
+    ring->format = ovl->format;
+    ring->w = ovl->w;
+    ring->h = ovl->h;
+
+    for (p = 0; p < 3; p++) {
+        ring->pitches[p] = ovl->pitches[p];
+        frame_size += ovl->pitches[p] * plane_height(p, ovl->h);
+    }
+
+    ring->count = count;
+    ring->data = (uint8_t *)xmalloc(count * frame_size);
+    ring->frames = (mm_frame *)xcalloc(count, sizeof(mm_frame));
+
+    for (i = 0; i < count; i++) {
+        uint8_t *data = ring->data + i * frame_size;
+
+        for (p = 0; p < 3; p++) {
+            ring->frames[i].planes[p] = data;
+            data += ring->pitches[p] * plane_height(p, ring->h);
+        }
+    }
+
+    return 0;
+}
+
+void
+mm_ring_free(mm_frame_ring *ring)
+{
+    assert(ring);
+
+    free(ring->frames);
+    free(ring->data);
+    memset(ring, 0, sizeof(*ring));
+}
+
+/** The oldest frame in the ring, or NULL if it is empty. */
+mm_frame *
+mm_ring_front(mm_frame_ring *ring)
+{
+    assert(ring);
+
+    return ring->fill ? &ring->frames[ring->head] : NULL;
+}
+
+/** Free the oldest frame. */
+void
+mm_ring_pop(mm_frame_ring *ring)
+{
+    assert(ring);
+    assert(ring->fill > 0);
+
+    ring->head = (ring->head + 1) % ring->count;
+    ring->fill--;
+}
+
+/** The frame to decode into next, or NULL if the ring is full. */
+mm_frame *
+mm_ring_back(mm_frame_ring *ring)
+{
+    assert(ring);
+
+    if (!ring->frames || ring->fill == ring->count) {
+        return NULL;
+    }
+
+    return &ring->frames[(ring->head + ring->fill) % ring->count];
+}
+
+/** Add the frame returned by mm_ring_back() to the ring. */
+void
+mm_ring_push(mm_frame_ring *ring)
+{
+    assert(ring);
+    assert(ring->fill < ring->count);
+
+    ring->fill++;
+}
+
+/* Decode the next video frame into a frame of a ring.  Only the frame
+ * itself is written, so the rest of the ring may be in use meanwhile.
+ * rval < 0: error, == 0: end of video, > 0: decoded */
+int
+mm_decode_video_to(mm_file *mf, const mm_frame_ring *ring, mm_frame *frame)
+{
+    yuv_buffer yuv;
+    int rv;
+
+    assert(ring);
+    assert(frame);
+
+    rv = mm_decode_video_frame(mf);
+
+    if (rv <= 0) {
+        return rv;
+    }
+
     theora_decode_YUVout(mf->video_ctx, &yuv);
+    frame->pts = mm_video_time(mf);
 
-    if (yuv_to_overlay(mf, &yuv, ovl) < 0) {
+    if (yuv_to_planes(mf, &yuv, ring->format, frame->planes, ring->pitches,
+                      ring->w, ring->h) < 0) {
         return -1;
     }
 
     return 1;
 }
 
+/* Copy a frame of a ring to an overlay.
+ * rval < 0: error, 0: ok */
+int
+mm_show_frame(const mm_frame_ring *ring, const mm_frame *frame,
+              SDL_Overlay *ovl)
+{
+    unsigned p;
+
+    assert(ring);
+    assert(frame);
+    assert(ovl);
+
+    if (ovl->format != ring->format) {
+        WARNING1("frame and overlay formats differ");
+        return -1;
+    }
+
+    if (SDL_LockYUVOverlay(ovl) < 0) {
+        WARNING1("unable to lock overlay");
+        return -1;
+    }
+
+    for (p = 0; p < 3; p++) {
+        copy_plane(ovl->pixels[p], ovl->pitches[p],
+                   frame->planes[p], ring->pitches[p],
+                   MIN((unsigned) ovl->pitches[p], ring->pitches[p]),
+                   plane_height(p, MIN((unsigned) ovl->h, ring->h)));
+    }
+
+    SDL_UnlockYUVOverlay(ovl);
+    return 0;
+}
+
 /* for now just 16bit signed values, mono channels FIXME
  * maybe use SDL_AudioConvert() for this */
 int
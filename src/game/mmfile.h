@@ -24,15 +24,50 @@ typedef struct {
     theora_state *video_ctx;
     unsigned end_of_stream;
     unsigned drop_packets;
+    const unsigned char *map;   /**< whole file, from mm_open_mapped() */
+    size_t map_size;
+    size_t map_pos;             /**< next page */
+    int map_owned;              /**< read into memory, not mapped */
+    unsigned long copied;       /**< bytes copied in before parsing */
 } mm_file;
 
+/** a decoded picture, with its planes in overlay order */
+typedef struct {
+    double pts;                 /**< from mm_video_time() */
+    uint8_t *planes[3];
+} mm_frame;
+
+/** frames decoded ahead, laid out like the overlay they go to */
+typedef struct {
+    mm_frame *frames;
+    uint8_t *data;
+    unsigned count;
+    unsigned head;              /**< oldest frame */
+    unsigned fill;              /**< frames in the ring */
+    Uint32 format;
+    unsigned w, h;
+    Uint16 pitches[3];
+} mm_frame_ring;
+
 extern int mm_open(mm_file *mf, const char *fname);
 extern int mm_open_fp(mm_file *mf, FILE *file);
+extern int mm_open_mapped(mm_file *mf, const char *fname);
 extern unsigned mm_ignore(mm_file *mf, unsigned mask);
 extern int mm_close(mm_file *mf);
 extern int mm_video_info(const mm_file *mf, unsigned *width, unsigned *height, float *fps);
+extern double mm_video_time(const mm_file *mf);
 extern int mm_audio_info(const mm_file *mf, unsigned *channels, unsigned *rate);
 extern int mm_decode_video(mm_file *mf, SDL_Overlay *ovl);
+extern int mm_decode_video_frame(mm_file *mf);
+extern int mm_show_video(mm_file *mf, SDL_Overlay *ovl);
+extern int mm_ring_init(mm_frame_ring *ring, unsigned count, const SDL_Overlay *ovl);
+extern void mm_ring_free(mm_frame_ring *ring);
+extern mm_frame *mm_ring_front(mm_frame_ring *ring);
+extern void mm_ring_pop(mm_frame_ring *ring);
+extern mm_frame *mm_ring_back(mm_frame_ring *ring);
+extern void mm_ring_push(mm_frame_ring *ring);
+extern int mm_decode_video_to(mm_file *mf, const mm_frame_ring *ring, mm_frame *frame);
+extern int mm_show_frame(const mm_frame_ring *ring, const mm_frame *frame, SDL_Overlay *ovl);
 extern int mm_decode_audio(mm_file *mf, void *buf, int buflen);
 #if 0
 extern int mm_convert_audio(mm_file *mf, void *buf, int buflen, SDL_AudioSpec *spec);
@@ -48,7 +48,8 @@
 #include "endianness.h"
 #include "filesystem.h"
 
-struct Astros *abuf;
+GAME_LOCAL struct Astros *abuf;
+GAME_LOCAL_RESET(abuf);
 
 #if 1
 char tame[29][40] = {
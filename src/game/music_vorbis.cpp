@@ -25,6 +25,7 @@
 #include "pace.h"
 #include "utils.h"
 #include "sdlhelper.h"
+#include "audio_stream.h"
 
 // A map of music_tracks to filenames
 struct music_key {
@@ -66,72 +67,43 @@ struct music_key {
     { M_MAX_MUSIC, NULL },
 };
 
+// XXX: Trim the last two seconds from each track, since it's broken
+// This should really be done on the Vorbis files, rather than in the player
+// (the old loader cut 2 * 11025 bytes, i.e. 11025 samples)
+#define MUSIC_TRIM_SAMPLES 11025
+
 // This structure defines each track
 struct music_file {
-    // Pointer to the audio buffer, once loaded from disk
-    char *buf;
-    size_t buf_size;
+    // The stream decoding this track while it plays
+    struct audio_stream *stream;
 
     // Can this track be played? i.e., does it exist?
     int unplayable;
 
     // Is this track playing?
     int playing;
-
-    // The SDL audio chunk describing this track
-    struct audio_chunk chunk;
 };
 struct music_file music_files[M_MAX_MUSIC];
 
-// Ensure that the specified music track is in memory, loading it if required
-void music_load(enum music_track track)
+// Find the file name for the specified track, or return 0 if it isn't known
+static int music_file_name(enum music_track track, char *fname, size_t size)
 {
-    char fname[20] = "";
     int i;
-    ssize_t bytes;
-
-    // Check to see if the track is already loaded or known broken; if so, we're already done
-    if (music_files[track].buf != NULL || music_files[track].unplayable) {
-        return;
-    }
 
-    // Find the name for this track
     for (i = 0; music_key[i].track != M_MAX_MUSIC; i++) {
         if (music_key[i].track == track && music_key[i].name) {
-            snprintf(fname, sizeof(fname), "%s.OGG", music_key[track].name);
-            break;
+            snprintf(fname, size, "%s.OGG", music_key[i].name);
+            return 1;
         }
     }
 
-    // Bail out if this track isn't known
-    if (strlen(fname) == 0) {
-        music_files[track].unplayable = 1;
-        return;
-    }
-
-    // Load the file
-    bytes = load_audio_file(fname, &music_files[track].buf, &music_files[track].buf_size);
-
-    // Handle failure gracefully
-    if (bytes < 0) {
-        free(music_files[track].buf);
-        music_files[track].unplayable = 1;
-        return;
-    }
-
-    // XXX: Trim the last two seconds from the audio file, since it's broken
-    // This should really be done on the Vorbis files, rather than in the player
-    if (bytes > 2 * 11025) {
-        music_files[track].buf_size -= 2 * 11025;
-        music_files[track].buf = (char *)xrealloc(music_files[track].buf, music_files[track].buf_size);
-    }
+    return 0;
 }
 
 // Start playing the given track
 void music_start_loop(enum music_track track, int loop)
 {
-    // Load the track as necessary
-    music_load(track);
+    char fname[20] = "";
 
     // Ensure that this track is playable
     if (music_files[track].unplayable) {
@@ -143,17 +115,32 @@ void music_start_loop(enum music_track track, int loop)
         return;
     }
 
-    // Initialize the audio chunk
-    music_files[track].chunk.data = music_files[track].buf;
-    music_files[track].chunk.size = music_files[track].buf_size;
-    music_files[track].chunk.loop = loop;
+    // Bail out if this track isn't known
+    if (!music_file_name(track, fname, sizeof(fname))) {
+        music_files[track].unplayable = 1;
+        return;
+    }
 
     // XXX: Stop the existing music, since we need the music channel
     // This should be changed to dynamic channel allocation, to allow layering music tracks
     music_stop();
 
+    // Without a sound device the track plays silently, with no decoder
+    if (!av_have_audio()) {
+        music_files[track].playing = 1;
+        return;
+    }
+
+    // Start decoding the track; a broken file is noticed by music_pump()
+    music_files[track].stream = audio_stream_open(fname, loop, MUSIC_TRIM_SAMPLES);
+
+    if (!music_files[track].stream) {
+        music_files[track].unplayable = 1;
+        return;
+    }
+
     // Play the track, and indicate that it's playing
-    play(&music_files[track].chunk, AV_MUSIC_CHANNEL);
+    av_play_stream(music_files[track].stream, AV_MUSIC_CHANNEL);
     music_files[track].playing = 1;
 }
 
@@ -165,6 +152,8 @@ void music_stop_track(enum music_track track)
         // This should be assigned on a per-track basis
         av_silence(AV_MUSIC_CHANNEL);
 
+        audio_stream_close(music_files[track].stream);
+        music_files[track].stream = NULL;
         music_files[track].playing = 0;
     }
 }
@@ -202,8 +191,23 @@ int music_is_track_playing(enum music_track track)
 
 void music_pump()
 {
-    // TODO: Check to see that all the tracks we think are playing actually are
-    // This doesn't apply to looped tracks, since those keep playing forever
+    int i;
+
+    // Check to see that all the tracks we think are playing actually are
+    for (i = 0; i < M_MAX_MUSIC; i++) {
+        struct audio_stream *stream = music_files[i].stream;
+
+        if (!music_files[i].playing || !stream) {
+            continue;
+        }
+
+        if (audio_stream_failed(stream)) {
+            music_files[i].unplayable = 1;
+            music_stop_track((music_track)i);
+        } else if (audio_stream_finished(stream)) {
+            music_stop_track((music_track)i);
+        }
+    }
 }
 
 void music_set_mute(int muted)
@@ -40,7 +40,8 @@
 #include "pace.h"
 #include "filesystem.h"
 
-struct order Order[7] ;
+GAME_LOCAL struct order Order[7];
+GAME_LOCAL_RESET(Order);
 
 char Month[12][11] = {
     "JANUARY ", "FEBRUARY ", "MARCH ", "APRIL ", "MAY ", "JUNE ",
@@ -41,6 +41,7 @@
 #include "news_suq.h"
 #include "sdlhelper.h"
 #include "pace.h"
+#include "media_clock.h"
 #include "gr.h"
 #include "endianness.h"
 #include "utils.h"
@@ -51,16 +52,27 @@
 
 static char *news_shots[] = { "angle", "opening", "closing" };
 
-double load_news_anim_start;
+/* paces the anim being played, and the frame rate it was made for */
+static GAME_LOCAL struct media_clock news_clock;
+static GAME_LOCAL float news_fps = 15;
+GAME_LOCAL_RESET(news_clock);
+GAME_LOCAL_RESET(news_fps);
 
 #define PHYS_PAGE_OFFSET  0x4000
 #define BUFFR_FRAMES 1
 #define FIRST_FRAME 0
 #define TOMS_BUGFIX 69
 
-int evflag;
-static int bufsize, LOAD_US = 0, LOAD_SV = 0;
-static int Frame, MaxFrame, AnimIndex = 255;
+GAME_LOCAL int evflag;
+static GAME_LOCAL int bufsize, LOAD_US = 0, LOAD_SV = 0;
+static GAME_LOCAL int Frame, MaxFrame, AnimIndex = 255;
+GAME_LOCAL_RESET(evflag);
+GAME_LOCAL_RESET(bufsize);
+GAME_LOCAL_RESET(LOAD_US);
+GAME_LOCAL_RESET(LOAD_SV);
+GAME_LOCAL_RESET(Frame);
+GAME_LOCAL_RESET(MaxFrame);
+GAME_LOCAL_RESET(AnimIndex);
 
 enum news_type {
     NEWS_ANGLE,
@@ -651,6 +663,7 @@ News(char plr)
     music_start_loop((plr % 2) ? M_NEW1950 : M_NEW1970, false);
 
     /* Tom's News kludge, also open and load first anim */
+    media_clock_start(&news_clock, "news");
     fp = LoadNewsAnim(plr, BW, NEWS_ANGLE, TOMS_BUGFIX, fp);
     loc = 1;
     Status = 0;
@@ -839,6 +852,7 @@ News(char plr)
     }
 
     mm_close(fp);
+    media_clock_stop(&news_clock);
 
     display::graphics.newsRect().w = 0;
 
@@ -887,34 +901,23 @@ ResolveEvent(char plr)
 int
 PlayNewsAnim(mm_file *fp)
 {
-    double delta;
-    double fps = 15;            /* TODO hardcoded fps here! */
-    int skip_frame = 0;
+    double start;
 
     if (Frame == MaxFrame) {
         return 1;
     }
 
-    delta = get_time() - load_news_anim_start;
+    start = get_time();
 
-    if (Frame < (int)(delta * fps)) {
-        skip_frame = 1;
-    }
-
-    if (mm_decode_video(fp, display::graphics.newsOverlay()) <= 0) {
+    if (mm_decode_video_frame(fp) <= 0) {
         MaxFrame = Frame;
         return 1;
     }
 
-    /* TODO skipping frames should not use decode_video */
-    if (!skip_frame) {
-        static double diff = 0;
-        double t1 = get_time(), to_sleep;
-
-        to_sleep = (Frame - delta * fps) / fps - diff;
-        idle_loop_secs(to_sleep);
-        diff = get_time() - t1 - to_sleep;
-        CTRACE4(video, "sleep % 4.3f, drift % 4.3f", to_sleep, diff);
+    if (media_clock_wait(&news_clock, MAX(mm_video_time(fp), 0),
+                         1.0 / news_fps, get_time() - start)) {
+        mm_show_video(fp, display::graphics.newsOverlay());
+        gr_sync();
     }
 
     Frame += 1;
@@ -976,8 +979,7 @@ LoadNewsAnim(int plr, int bw, int type, int Mode, mm_file *fp)
         /* XXX error checking */
         mm_open_fp(fp, sOpen(fname, "rb", FT_VIDEO));
 
-        /* XXX we know fps anyway */
-        mm_video_info(fp, &w, &h, NULL);
+        mm_video_info(fp, &w, &h, &news_fps);
         display::graphics.newsRect().h = h;
         display::graphics.newsRect().w = w;
         display::graphics.newsRect().x = 4;
@@ -1011,7 +1013,8 @@ LoadNewsAnim(int plr, int bw, int type, int Mode, mm_file *fp)
         FadeIn(2, 10, 0, 0); /* was: 50 */
     }
 
-    load_news_anim_start = get_time();
+    /* the frame on screen now is due now */
+    media_clock_restart(&news_clock, MAX(mm_video_time(fp), 0));
 
     return fp;
 }
@@ -1,9 +1,11 @@
 #ifndef NEWS_H
 #define NEWS_H
 
+#include "game_context.h"
+
 void AIEvent(char plr);
 void News(char plr);
 
-extern int evflag;
+extern GAME_LOCAL int evflag;
 
 #endif // NEWS_H
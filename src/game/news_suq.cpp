@@ -895,7 +895,7 @@ char REvent(char plr)
 
     case 64:  /* launch facility repair 10MB's */
         for (j = 0; j < 20; j++) {
-            i = rand() % 3;
+            i = brandom(3);
 
             if (Data->P[plr].LaunchFacility[i] == 1 && Data->P[plr].Mission[i].MissionCode == Mission_None) {
                 break;
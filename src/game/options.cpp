@@ -18,6 +18,8 @@
 
 // This file handles Advanced Preferences.
 
+#include "display/graphics.h"
+
 #include "Buzz_inc.h"
 #include "options.h"
 #include "macros.h"
@@ -96,6 +98,14 @@ static struct {
         "audio", &options.want_audio, "%u", 0,
         "Set to 0 if you don't want audio in game."
     },
+    {
+        "audio_cache_kb", &options.audio_cache_kb, "%u", 0,
+        "Kilobytes of decoded voices and sound effects kept in memory for reuse."
+    },
+    {
+        "image_cache_kb", &options.image_cache_kb, "%u", 0,
+        "Kilobytes of decoded images kept in memory so screens open faster."
+    },
     {
         "nofail",  &options.want_cheats, "%u", 0,
         "Set to 1 if you want every mission step check to succeed."
@@ -108,6 +118,10 @@ static struct {
         "fullscreen", &options.want_fullscreen, "%u", 0,
         "Set to 1 if you want (ugly) full-screen game."
     },
+    {
+        "scale", &options.want_scale, "%u", 0,
+        "Set to 1, 2, 3 or 4 to choose how much the 320x200 screen is enlarged (default 2)."
+    },
     {
         "debuglevel", &options.want_debug, "%u", 0,
         "Set to positive values to increase debugging verbosity."
@@ -172,9 +186,12 @@ static void
 usage(int fail)
 {
     fprintf(stderr, "usage:   raceintospace [options...]\n"
-            "options: -a -i -f -v -n\n"
+            "options: -a -i -f -v -n -s\n"
             "\t-v verbose mode\n\t\tadd this several times to get to DEBUG level\n"
             "\t-f fullscreen mode\n\t\tugly\n"
+            "\t-s seed\n\t\tplay the same game as another one with this seed;\n"
+            "\t\tonly games between computer players come out the same,\n"
+            "\t\tas screens draw from the same numbers as the game\n"
            );
     exit((fail) ? EXIT_FAILURE : EXIT_SUCCESS);
 }
@@ -427,10 +444,16 @@ setup_options(int argc, char *argv[])
 
     /* setup default values */
     options.want_audio = 1;
+    options.audio_cache_kb = 4096;
+    options.image_cache_kb = 4096;
     options.want_intro = 1;
     options.want_cheats = 0;
     options.want_fullscreen = 0;
+    options.want_scale = display::Graphics::DEFAULT_SCALE;
     options.want_debug = 0;
+    options.headless = 0;
+    options.seed = 0;
+    options.seed_set = 0;
     options.feat_shorter_advanced_training = 0;
     options.feat_female_nauts = 0;
     options.feat_random_nauts = 0;   //Naut Randomize, Nikakd, 10/8/10
@@ -453,6 +476,12 @@ setup_options(int argc, char *argv[])
         write_default_config();
     }
 
+    if (options.want_scale < display::Scaler::MIN_FACTOR
+        || options.want_scale > display::Scaler::MAX_FACTOR) {
+        WARNING2("unsupported scale %u, using the default", options.want_scale);
+        options.want_scale = display::Graphics::DEFAULT_SCALE;
+    }
+
     /* first pass: command line options */
     for (pos = 1; pos < argc; ++pos) {
         str = argv[pos];
@@ -484,6 +513,11 @@ setup_options(int argc, char *argv[])
             options.want_fullscreen = 1;
         } else if (strcmp(str, "-v") == 0) {
             options.want_debug++;
+        } else if (strcmp(str, "-s") == 0 && pos + 1 < argc) {
+            options.seed = strtoul(argv[pos + 1], NULL, 0);
+            options.seed_set = 1;
+            shift_argv(argv + pos, argc - pos, 1);
+            argc--;
         } else {
             ERROR2("unknown option %s", str);
             usage(1);
@@ -5,10 +5,16 @@ typedef struct {
     char *dir_savegame;
     char *dir_gamedata;
     unsigned want_audio;
+    unsigned audio_cache_kb;
+    unsigned image_cache_kb;
     unsigned want_fullscreen;
+    unsigned want_scale;
     unsigned want_intro;
     unsigned want_cheats;
     unsigned want_debug;
+    unsigned headless;      /**< no display, audio or delays, for raceintospace-sim */
+    unsigned seed;          /**< random seed of a new game, if seed_set */
+    unsigned seed_set;      /**< a seed was given; otherwise one comes from the clock */
     unsigned feat_shorter_advanced_training;
     unsigned feat_female_nauts;
     unsigned feat_random_nauts;
@@ -9,9 +9,15 @@
 #include "pace.h"
 #include "utils.h"
 #include "game_main.h"
+#include "options.h"
 #include "sdlhelper.h"
 #include "gr.h"
 #include "mmfile.h"
+#include "audio_cache.h"
+#include "image_cache.h"
+#include "filesystem.h"
+#include "prefetch.h"
+#include "rng.h"
 
 #include <ctype.h>
 
@@ -50,6 +56,8 @@ void OpenEmUp(void)
     randomize();
     seq_init();
     letter_dat = slurp_gamedat("letter.dat");
+    ImageCache::prewarm("images/prewarm.txt");
+    prefetch_init(Filesystem::decodeImage, load_audio_path);
 }
 
 int PCX_D(char *src_raw, char *dest_raw, unsigned src_size)
@@ -191,6 +199,7 @@ void FadeIn(char wh, int steps, int val, char mode)
     }
 
     av_set_fading(AV_FADE_IN, from, to, steps, !!mode);
+    prefetch_screen_ready();
 }
 
 void FadeOut(char wh, int steps, int val, char mode)
@@ -225,7 +234,7 @@ int brandom(int limit)
         return (0);
     }
 
-    return (int)(limit * (rand() / (RAND_MAX + 1.0)));
+    return rng_below(&game_rng, limit);
 }
 
 /* Run-length Encoding (RLE) Compression algorithm.
@@ -285,6 +294,16 @@ void StopAudio(char mode)
 void CloseEmUp(unsigned char error, unsigned int value)
 {
     /* DEBUG */ /* fprintf (stderr, "CloseEmUp()\n"); */
+    ImageCache::Stats images = ImageCache::stats();
+    INFO5("image cache: %lu hits, %lu misses, %lu evictions, %lu KB",
+          images.hits, images.misses, images.evictions,
+          (unsigned long)(images.bytes / 1024));
+    struct prefetch_stats prefetched;
+    prefetch_get_stats(&prefetched);
+    INFO5("prefetch: %lu hints, %lu ready, %lu collected, %lu waited",
+          prefetched.hinted, prefetched.ready, prefetched.collected,
+          prefetched.waited);
+    prefetch_shutdown();
     exit(EXIT_SUCCESS);
 }
 
@@ -406,9 +425,13 @@ void LMove(void *p)
     local.copyTo(display::graphics.legacyScreen(), 320 / 4, 200 / 4);
 }
 
+/** Seed the game from the seed option, or from the clock without one. */
 void randomize(void)
 {
-    srand(get_time() * 1000);
+    unsigned seed = options.seed_set ? options.seed : (unsigned)(get_time() * 1000);
+
+    INFO2("random seed %u", seed);
+    rng_seed(&game_rng, seed);
 }
 
 /** do nothing for a few seconds.
@@ -421,6 +444,10 @@ void idle_loop_secs(double secs)
 {
     double start;
 
+    if (options.headless) {
+        return;
+    }
+
     gr_sync();
 
     start = get_time();
@@ -443,14 +470,15 @@ void idle_loop(int ticks)
     idle_loop_secs(ticks / 2000.0);
 }
 
-char *soundbuf;
-size_t soundbuf_size = 0;
-size_t soundbuf_used = 0;
-struct audio_chunk news_chunk;
+/* voice loaded by NGetVoice() or PlayAudio(), and the one being played */
+static struct audio_pcm *voice_pcm;
+static struct audio_pcm *playing_pcm;
+static struct audio_chunk news_chunk;
 
-ssize_t load_audio_file(const char *name, char **data, size_t *size)
+/* decode an opened audio file into *data, growing it as needed */
+static ssize_t decode_audio(mm_file *mf, const char *name,
+                            char **data, size_t *size)
 {
-    mm_file mf;
     unsigned channels, rate;
     const size_t def_size = 16 * 1024;
     size_t offset = 0;
@@ -460,23 +488,15 @@ ssize_t load_audio_file(const char *name, char **data, size_t *size)
     /* make compiler happy */
     start *= 1.0;
 
-    assert(name);
-    assert(data);
-    assert(size);
-
-    if (mm_open_fp(&mf, sOpen(name, "rb", FT_AUDIO)) < 0) {
-        return -1;
-    }
-
-    if (mm_audio_info(&mf, &channels, &rate) < 0) {
+    if (mm_audio_info(mf, &channels, &rate) < 0) {
         CWARNING3(audio, "no audio data in file `%s'", name);
-        mm_close(&mf);
+        mm_close(mf);
         return -1;
     }
 
     if (channels != 1 || rate != 11025) {
         CERROR3(audio, "file `%s' should be mono, 11025Hz", name);
-        mm_close(&mf);
+        mm_close(mf);
         return -1;
     }
 
@@ -484,7 +504,7 @@ ssize_t load_audio_file(const char *name, char **data, size_t *size)
         *data = (char *)xmalloc(*size = def_size);
     }
 
-    while (0 < (read = mm_decode_audio(&mf,
+    while (0 < (read = mm_decode_audio(mf,
                                        *data + offset, *size - offset))) {
         offset += read;
 
@@ -493,7 +513,7 @@ ssize_t load_audio_file(const char *name, char **data, size_t *size)
         }
     }
 
-    mm_close(&mf);
+    mm_close(mf);
 
     CDEBUG4(audio, "loading file `%s' took %5.4f seconds",
             name, get_time() - start);
@@ -501,43 +521,86 @@ ssize_t load_audio_file(const char *name, char **data, size_t *size)
     return offset;
 }
 
+ssize_t load_audio_file(const char *name, char **data, size_t *size)
+{
+    mm_file mf;
+
+    assert(name);
+    assert(data);
+    assert(size);
+
+    if (mm_open_fp(&mf, sOpen(name, "rb", FT_AUDIO)) < 0) {
+        return -1;
+    }
+
+    return decode_audio(&mf, name, data, size);
+}
+
+/* like load_audio_file(), but from a path found by locate_file(); it
+ * doesn't use the file lookup, so it can run on any thread */
+ssize_t load_audio_path(const char *path, char **data, size_t *size)
+{
+    mm_file mf;
+
+    assert(path);
+    assert(data);
+    assert(size);
+
+    if (mm_open(&mf, path) < 0) {
+        return -1;
+    }
+
+    return decode_audio(&mf, path, data, size);
+}
+
+/* make the named file the voice PlayVoice() will play */
+static void load_voice(const char *fname)
+{
+    struct audio_pcm *pcm = audio_cache_get(fname);
+
+    audio_cache_release(voice_pcm);
+    voice_pcm = pcm;
+}
+
 void NGetVoice(char plr, char val)
 {
     char fname[100];
-    ssize_t bytes = 0;
 
     sprintf(fname, "%s_%03d.ogg", (plr ? "sov" : "usa"), val);
-    bytes = load_audio_file(fname, &soundbuf, &soundbuf_size);
-    soundbuf_used = (bytes > 0) ? bytes : 0;
+    load_voice(fname);
 }
 
 void PlayVoice(void)
 {
-    if (!soundbuf_used) {
+    if (!voice_pcm) {
         return;
     }
 
-    news_chunk.data = soundbuf;
-    news_chunk.size = soundbuf_used;
+    /* the channel holds its own reference while the chunk is queued */
+    StopVoice();
+    playing_pcm = audio_cache_ref(voice_pcm);
+
+    news_chunk.data = playing_pcm->data;
+    news_chunk.size = playing_pcm->size;
     news_chunk.next = NULL;
     play(&news_chunk, AV_SOUND_CHANNEL);
 }
 
 void KillVoice(void)
 {
-    av_silence(AV_SOUND_CHANNEL);
+    StopVoice();
 }
 
 void StopVoice(void)
 {
     av_silence(AV_SOUND_CHANNEL);
+    audio_cache_release(playing_pcm);
+    playing_pcm = NULL;
 }
 
 void PlayAudio(char *name, char mode)
 {
-    ssize_t bytes = 0;
-    bytes = load_audio_file(name, &soundbuf, &soundbuf_size);
-    soundbuf_used = (bytes > 0) ? bytes : 0;
+    load_voice(name);
     PlayVoice();
 }
 
@@ -557,7 +620,6 @@ int getch(void)
 void play_audio(int sidx, int mode)
 {
     char filename[40];
-    ssize_t size;
     char *name = seq_filename(sidx, mode);
 
     if (!name) {
@@ -568,7 +630,6 @@ void play_audio(int sidx, int mode)
 
     snprintf(filename, sizeof(filename), "%s.ogg", name);
     CINFO3(audio, "play sound file `%s'", filename);
-    size = load_audio_file(filename, &soundbuf, &soundbuf_size);
-    soundbuf_used = (size > 0) ? size : 0;
+    load_voice(filename);
     PlayVoice();
 }
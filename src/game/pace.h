@@ -11,6 +11,7 @@
 #include "fake_unistd.h"
 #endif
 
+void OpenEmUp(void);
 void delay(int millisecs);
 void FadeIn(char wh, int steps, int val, char mode);
 void FadeOut(char wh, int steps, int val, char mode);
@@ -29,6 +30,7 @@ void NGetVoice(char plr, char val);
 void PlayVoice(void);
 void KillVoice(void);
 ssize_t load_audio_file(const char *, char **data, size_t *size);
+ssize_t load_audio_path(const char *path, char **data, size_t *size);
 void idle_loop(int ticks);
 void play_audio(int sidx, int mode);
 void bzdelay(int ticks);
@@ -54,6 +54,7 @@
 #include "pace.h"
 #include "endianness.h"
 #include "filesystem.h"
+#include "prefetch.h"
 
 #include <stdio.h>
 #include <boost/shared_ptr.hpp>
@@ -223,6 +224,7 @@ void PortRestore(unsigned int Count);
 int MapKey(char plr, int key, int old) ;
 void Port(char plr);
 char PortSel(char plr, char loc);
+void PortPrefetch(char plr, int loc);
 char Request(char plr, char *s, char md);
 size_t ImportPortHeader(FILE *fin, struct PortHeader &target);
 size_t ImportMOBJ(FILE *fin, MOBJ &target);
@@ -850,6 +852,12 @@ void UpdatePortOverlays(void)
 
 void Master(char plr)
 {
+    // Played by SpotCrap() as the spaceport animations start
+    static const char *const spotSounds[] = {
+        "jet.ogg", "vcrash.ogg", "train.ogg", "crawler.ogg", "vthrust.ogg",
+        "gate.ogg", "svprops.ogg", "heli_00.ogg", "radarsv.ogg",
+        "radarus.ogg", "lightng.ogg", "crane.ogg", "truck.ogg"
+    };
     int i, r_value, t_value = 0, g_value = 0;
     sFin = NULL;
     helpText = "i000";
@@ -864,10 +872,22 @@ void Master(char plr)
         Data->P[plr].Mission[i].Joint = Mis.Jt;
     }
 
+#if BABYSND
+
+    if (!IsChannelMute(AV_SOUND_CHANNEL)) {
+        for (i = 0; i < (int)ARRAY_LENGTH(spotSounds); i++) {
+            prefetch_audio(spotSounds[i], PREFETCH_LIKELY);
+        }
+    }
+
+#endif
+
     // Entering screen for the first time so fade out and in.
+    prefetch_screen_begin("Spaceport");
     FadeOut(2, 10, 0, 0);
     DrawSpaceport(plr);
     FadeIn(2, 10, 0, 0);
+    prefetch_screen_end();
 
     int height = display::graphics.legacyScreen()->height();
     int width = display::graphics.legacyScreen()->width();
@@ -1250,6 +1270,7 @@ void Port(char plr)
     int i, j, kMode, kEnt, k;
     char good, res;
     int kPad, pKey, gork;
+    int hinted = -1;  // the location images were last hinted for
     FILE *fin;
     int32_t stable[55];
     uint16_t Count, *bone;
@@ -1344,6 +1365,11 @@ void Port(char plr)
                     y <= MObj[(kMode == 0) ? i : kEnt].Reg[Data->P[plr].Port[(kMode == 0) ? i : kEnt]].CD[j].y2) {
                     PortText(5, 196, MObj[i].Name, 11);
 
+                    if (i != hinted) {
+                        PortPrefetch(plr, i);
+                        hinted = i;
+                    }
+
                     if (MObj[i].Reg[Data->P[plr].Port[i]].sNum > 0) {
                         fseek(fin, stable[MObj[i].Reg[Data->P[plr].Port[i]].sNum], SEEK_SET);
                         fread_uint16_t(&Count, 1, fin);
@@ -1411,7 +1437,10 @@ void Port(char plr)
                                 SUSPEND = 1;
                             }
 
+                            prefetch_screen_begin(MObj[i].Name);
                             res = PortSel(plr, i);
+                            prefetch_screen_end();
+                            hinted = -1;
 
                             switch (res) {
                             case pNOREDRAW:
@@ -1566,6 +1595,72 @@ void Port(char plr)
 }
 
 
+/**
+ * Hints at the images a Port location opens with, so they can be
+ * decoded while the player is still pointing at it.
+ *
+ * Screens whose images depend on more than the player aren't listed.
+ */
+void PortPrefetch(char plr, int loc)
+{
+    char filename[128];
+
+    switch (loc) {
+    case PORT_Pentagon:
+        prefetch_image("images/intel_background.png", PREFETCH_NEXT);
+        break;
+
+    case PORT_Cemetery:
+        snprintf(filename, sizeof(filename), "images/cemetery.%d.png", plr);
+        prefetch_image(filename, PREFETCH_NEXT);
+        break;
+
+    case PORT_MedicalCtr:
+        snprintf(filename, sizeof(filename), "images/hospital.%d.png", plr);
+        prefetch_image(filename, PREFETCH_NEXT);
+        break;
+
+    case PORT_Research:
+        snprintf(filename, sizeof(filename), "images/rd_men.%d.png", plr);
+        prefetch_image(filename, PREFETCH_NEXT);
+        // fall through
+
+    case PORT_VAB:
+        snprintf(filename, sizeof(filename), "images/vab.img.%d.png", plr);
+        prefetch_image(filename, PREFETCH_NEXT);
+        break;
+
+    case PORT_Mercury:
+    case PORT_Gemini:
+    case PORT_Apollo:
+    case PORT_XMS:
+    case PORT_Jupiter:
+        // Programs() is given 1 for Mercury up to 5 for Jupiter
+        snprintf(filename, sizeof(filename), "images/aprog.%d.%d.png",
+                 plr, PORT_Mercury - loc + 1);
+        prefetch_image(filename, PREFETCH_NEXT);
+        break;
+
+    case PORT_LaunchPad_A:
+    case PORT_LaunchPad_B:
+    case PORT_LaunchPad_C:
+        for (int i = 0; i < 6; i += 2) {
+            snprintf(filename, sizeof(filename), "images/lfacil.but.%d.png",
+                     i + plr);
+            prefetch_image(filename, PREFETCH_NEXT);
+        }
+
+        break;
+
+    case PORT_MissionControl:
+        prefetch_image("images/lpads.but.1.png", PREFETCH_NEXT);
+        break;
+
+    default:
+        break;
+    }
+}
+
 /**
  * This is the code that controls the jumpoff point from the Spaceports
  * to the various areas.  It basically assigns a help message, then
@@ -0,0 +1,523 @@
+// This file decodes the images and sounds of likely next screens on a
+// background thread.
+
+#include "prefetch.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#include <SDL/SDL.h>
+
+#include "audio_cache.h"
+#include "filesystem.h"
+#include "fs.h"
+#include "logging.h"
+#include "pace.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(filesys)
+
+enum job_kind {
+    JOB_IMAGE,
+    JOB_AUDIO
+};
+
+enum job_state {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE
+};
+
+/*
+ * A job belongs to the main thread while queued or done, and to the
+ * worker while running; state and the queue are only touched with the
+ * lock held.
+ */
+struct prefetch_job {
+    job_kind kind;
+    std::string name;           /* as the cache asks for it */
+    char *path;                 /* audio files are found before queueing */
+    int priority;
+    unsigned long order;        /* later hints have higher numbers */
+    job_state state;
+    bool failed;
+    ImageCache::Image image;
+    char *data;
+    ssize_t bytes;
+};
+
+/* highest priority first, then the latest hint */
+struct job_order {
+    bool operator()(const prefetch_job *a, const prefetch_job *b) const
+    {
+        if (a->priority != b->priority) {
+            return a->priority > b->priority;
+        }
+
+        return a->order > b->order;
+    }
+};
+
+typedef std::map<std::string, prefetch_job *> job_index;
+typedef std::set<prefetch_job *, job_order> job_queue;
+
+static struct {
+    ImageCache::Loader decode_image;
+    prefetch_audio_loader decode_audio;
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *queued;           /* a job was queued, or quit was set */
+    SDL_cond *finished;         /* a job is done */
+    int quit;
+    int collecting;             /* prefetch_collect() is claiming jobs */
+    job_index jobs[JOB_AUDIO + 1];
+    job_queue queue;
+    unsigned long order;
+    struct prefetch_stats stats;
+} pf = {Filesystem::decodeImage, NULL};
+
+/* the screen being opened, timed from prefetch_screen_begin() */
+static struct {
+    char name[32];
+    double start;
+    int pending;                /* not faded in yet */
+    struct prefetch_stats stats;
+} screen;
+
+static void
+job_free(prefetch_job *job)
+{
+    free(job->path);
+    free(job->data);
+    delete job;
+}
+
+static void
+job_decode(prefetch_job *job)
+{
+    if (job->kind == JOB_IMAGE) {
+        try {
+            job->image = pf.decode_image(job->name);
+        } catch (const std::exception &err) {
+            job->failed = true;
+        }
+    } else {
+        size_t size = 0;
+
+        job->bytes = pf.decode_audio(job->path, &job->data, &size);
+        job->failed = (job->bytes <= 0);
+    }
+}
+
+static int
+worker_thread(void *arg)
+{
+    SDL_mutexP(pf.lock);
+
+    while (!pf.quit) {
+        if (pf.queue.empty()) {
+            SDL_CondWait(pf.queued, pf.lock);
+            continue;
+        }
+
+        prefetch_job *job = *pf.queue.begin();
+
+        pf.queue.erase(pf.queue.begin());
+        job->state = JOB_RUNNING;
+        SDL_mutexV(pf.lock);
+
+        job_decode(job);
+
+        SDL_mutexP(pf.lock);
+        job->state = JOB_DONE;
+        SDL_CondBroadcast(pf.finished);
+    }
+
+    SDL_mutexV(pf.lock);
+    return 0;
+}
+
+/*
+ * Take the job for a file out of the index, waiting for it if the worker
+ * is decoding it.  A job that hasn't been started is dropped, since the
+ * caller would only wait for the worker to do what it can do itself.
+ *
+ * \return the finished job, or NULL if there wasn't one
+ */
+static prefetch_job *
+job_claim(job_kind kind, const std::string &name)
+{
+    prefetch_job *job = NULL;
+
+    if (!pf.thread) {
+        return NULL;
+    }
+
+    SDL_mutexP(pf.lock);
+
+    job_index::iterator it = pf.jobs[kind].find(name);
+
+    if (it != pf.jobs[kind].end()) {
+        job = it->second;
+        pf.jobs[kind].erase(it);
+
+        if (job->state == JOB_QUEUED) {
+            pf.queue.erase(job);
+            pf.stats.missed++;
+            job_free(job);
+            job = NULL;
+        } else if (job->state == JOB_RUNNING) {
+            double start = get_time();
+
+            while (job->state != JOB_DONE) {
+                SDL_CondWait(pf.finished, pf.lock);
+            }
+
+            pf.stats.waited++;
+            pf.stats.wait_secs += get_time() - start;
+        } else if (pf.collecting) {
+            pf.stats.collected++;
+        } else {
+            pf.stats.ready++;
+        }
+    }
+
+    SDL_mutexV(pf.lock);
+    return job;
+}
+
+/*
+ * Queue a decode, or move an existing one to the front of its new
+ * priority.  Takes ownership of path.
+ */
+static void
+job_hint(job_kind kind, const char *name, char *path, int priority)
+{
+    SDL_mutexP(pf.lock);
+
+    job_index::iterator it = pf.jobs[kind].find(name);
+    prefetch_job *job;
+
+    if (it != pf.jobs[kind].end()) {
+        job = it->second;
+        free(path);
+
+        if (job->state == JOB_QUEUED) {
+            pf.queue.erase(job);
+            job->priority = std::max(job->priority, priority);
+            job->order = ++pf.order;
+            pf.queue.insert(job);
+        }
+
+        SDL_mutexV(pf.lock);
+        return;
+    }
+
+    job = new prefetch_job;
+    job->kind = kind;
+    job->name = name;
+    job->path = path;
+    job->priority = priority;
+    job->order = ++pf.order;
+    job->state = JOB_QUEUED;
+    job->failed = false;
+    job->data = NULL;
+    job->bytes = 0;
+
+    pf.jobs[kind][name] = job;
+    pf.queue.insert(job);
+    pf.stats.hinted++;
+    SDL_CondSignal(pf.queued);
+    SDL_mutexV(pf.lock);
+}
+
+/**
+ * Start the worker.
+ *
+ * \param decode_image decoder for images; Filesystem::decodeImage()
+ * \param decode_audio decoder for audio files; load_audio_path()
+ */
+void
+prefetch_init(ImageCache::Loader decode_image,
+              prefetch_audio_loader decode_audio)
+{
+    assert(decode_image);
+    assert(decode_audio);
+
+    prefetch_shutdown();
+
+    pf.decode_image = decode_image;
+    pf.decode_audio = decode_audio;
+    pf.quit = 0;
+    memset(&pf.stats, 0, sizeof(pf.stats));
+
+    pf.lock = SDL_CreateMutex();
+    pf.queued = SDL_CreateCond();
+    pf.finished = SDL_CreateCond();
+    pf.thread = SDL_CreateThread(worker_thread, NULL);
+
+    if (!pf.thread) {
+        WARNING2("can't start the prefetch thread: %s", SDL_GetError());
+        SDL_DestroyCond(pf.finished);
+        SDL_DestroyCond(pf.queued);
+        SDL_DestroyMutex(pf.lock);
+    }
+}
+
+/** Stop the worker and drop every unclaimed decode. */
+void
+prefetch_shutdown(void)
+{
+    if (!pf.thread) {
+        return;
+    }
+
+    SDL_mutexP(pf.lock);
+    pf.quit = 1;
+    SDL_CondSignal(pf.queued);
+    SDL_mutexV(pf.lock);
+
+    SDL_WaitThread(pf.thread, NULL);
+    pf.thread = NULL;
+
+    for (int kind = JOB_IMAGE; kind <= JOB_AUDIO; kind++) {
+        for (job_index::iterator it = pf.jobs[kind].begin();
+             it != pf.jobs[kind].end(); ++it) {
+            job_free(it->second);
+        }
+
+        pf.jobs[kind].clear();
+    }
+
+    pf.queue.clear();
+
+    SDL_DestroyCond(pf.finished);
+    SDL_DestroyCond(pf.queued);
+    SDL_DestroyMutex(pf.lock);
+}
+
+/**
+ * Decode an image ahead of time, unless it is already cached.
+ *
+ * \param filename the name Filesystem::readImage() will be given
+ */
+void
+prefetch_image(const char *filename, int priority)
+{
+    assert(filename);
+
+    if (!pf.thread || ImageCache::stats().budget == 0) {
+        return;
+    }
+
+    prefetch_collect();
+
+    if (!ImageCache::cached(filename)) {
+        job_hint(JOB_IMAGE, filename, NULL, priority);
+    }
+}
+
+/**
+ * Decode an audio file ahead of time, unless it is already cached.
+ *
+ * \param name the name PlayAudio() or NGetVoice() will use
+ */
+void
+prefetch_audio(const char *name, int priority)
+{
+    struct audio_cache_stats stats;
+    char *path;
+
+    assert(name);
+
+    audio_cache_get_stats(&stats);
+
+    if (!pf.thread || stats.budget == 0) {
+        return;
+    }
+
+    prefetch_collect();
+
+    if (audio_cache_has(name)) {
+        return;
+    }
+
+    /* the file system lookup isn't thread-safe, so do it here */
+    if ((path = locate_file(name, FT_AUDIO)) == NULL) {
+        return;
+    }
+
+    job_hint(JOB_AUDIO, name, path, priority);
+}
+
+/**
+ * Move finished decodes into the image and audio caches.
+ *
+ * The caches ask prefetch_load_image() and prefetch_load_audio() for
+ * them, which takes them out of the index.
+ */
+void
+prefetch_collect(void)
+{
+    std::set<std::string> done[JOB_AUDIO + 1];
+
+    if (!pf.thread) {
+        return;
+    }
+
+    SDL_mutexP(pf.lock);
+
+    for (int kind = JOB_IMAGE; kind <= JOB_AUDIO; kind++) {
+        for (job_index::iterator it = pf.jobs[kind].begin();
+             it != pf.jobs[kind].end(); ++it) {
+            if (it->second->state == JOB_DONE && !it->second->failed) {
+                done[kind].insert(it->first);
+            }
+        }
+    }
+
+    SDL_mutexV(pf.lock);
+    pf.collecting = 1;
+
+    for (std::set<std::string>::iterator it = done[JOB_IMAGE].begin();
+         it != done[JOB_IMAGE].end(); ++it) {
+        ImageCache::get(*it);
+    }
+
+    for (std::set<std::string>::iterator it = done[JOB_AUDIO].begin();
+         it != done[JOB_AUDIO].end(); ++it) {
+        audio_cache_release(audio_cache_get(it->c_str()));
+    }
+
+    /* the cache may have been full, or the decode failed */
+    for (int kind = JOB_IMAGE; kind <= JOB_AUDIO; kind++) {
+        for (std::set<std::string>::iterator it = done[kind].begin();
+             it != done[kind].end(); ++it) {
+            prefetch_job *job = job_claim((job_kind)kind, *it);
+
+            if (job) {
+                job_free(job);
+            }
+        }
+    }
+
+    pf.collecting = 0;
+}
+
+void
+prefetch_get_stats(struct prefetch_stats *stats)
+{
+    assert(stats);
+
+    if (pf.thread) {
+        SDL_mutexP(pf.lock);
+    }
+
+    *stats = pf.stats;
+
+    if (pf.thread) {
+        SDL_mutexV(pf.lock);
+    }
+}
+
+/**
+ * ImageCache loader: the prefetched image, or a fresh decode.
+ *
+ * \throws std::runtime_error  if the image can't be read.
+ */
+ImageCache::Image
+prefetch_load_image(const std::string &filename)
+{
+    prefetch_job *job = job_claim(JOB_IMAGE, filename);
+
+    if (job && !job->failed) {
+        ImageCache::Image image = job->image;
+
+        job_free(job);
+        return image;
+    }
+
+    /* a failed decode is repeated here to report the error */
+    if (job) {
+        job_free(job);
+    }
+
+    return pf.decode_image(filename);
+}
+
+/** audio_cache loader: the prefetched samples, or a fresh decode. */
+ssize_t
+prefetch_load_audio(const char *name, char **data, size_t *size)
+{
+    prefetch_job *job = job_claim(JOB_AUDIO, name);
+
+    if (job && !job->failed) {
+        ssize_t bytes = job->bytes;
+
+        free(*data);
+        *data = job->data;
+        *size = bytes;
+        job->data = NULL;
+        job_free(job);
+        return bytes;
+    }
+
+    if (job) {
+        job_free(job);
+    }
+
+    return load_audio_file(name, data, size);
+}
+
+/**
+ * Start timing a screen, from the fade out of the one before it.
+ *
+ * The time is logged when the screen fades in.
+ */
+void
+prefetch_screen_begin(const char *name)
+{
+    assert(name);
+
+    strncpy(screen.name, name, sizeof(screen.name) - 1);
+    screen.name[sizeof(screen.name) - 1] = '\0';
+    screen.start = get_time();
+    screen.pending = 1;
+    prefetch_get_stats(&screen.stats);
+}
+
+/** The screen is faded in, so log how long it took to get there. */
+void
+prefetch_screen_ready(void)
+{
+    struct prefetch_stats now;
+
+    if (!screen.pending) {
+        return;
+    }
+
+    screen.pending = 0;
+    prefetch_get_stats(&now);
+
+    INFO6("%s: interactive after %.1f ms (%lu prefetched, "
+          "%lu waited for %.1f ms)",
+          screen.name, (get_time() - screen.start) * 1000,
+          now.ready - screen.stats.ready,
+          now.waited - screen.stats.waited,
+          (now.wait_secs - screen.stats.wait_secs) * 1000);
+    DEBUG2("%lu hints arrived too late",
+           now.missed - screen.stats.missed);
+}
+
+/** The screen was left; forget it if it never faded in. */
+void
+prefetch_screen_end(void)
+{
+    screen.pending = 0;
+}
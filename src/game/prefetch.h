@@ -0,0 +1,59 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <string>
+
+#include "image_cache.h"
+
+/**
+ * \file prefetch.h Decoding the assets of the next screen ahead of time.
+ *
+ * Screens hint at what the player is likely to open next, and a worker
+ * thread decodes those images and sounds while the current screen is
+ * still up.  The image and audio caches load through prefetch_load_image()
+ * and prefetch_load_audio(), which hand over a finished decode, wait for
+ * one in progress, or decode on the spot if the file was never hinted.
+ *
+ * Hints of a higher priority are decoded first; within a priority the
+ * latest hint goes first.  Finished decodes are moved into the caches on
+ * the next hint, so they are bounded by the cache budgets.  Everything
+ * except the worker runs on the main thread.
+ */
+
+enum prefetch_priority {
+    PREFETCH_LIKELY = 0,        /**< may be needed this turn */
+    PREFETCH_NEXT = 1           /**< the pointer is on its way there */
+};
+
+/** Decodes an audio file, found by locate_file(), like load_audio_file() */
+typedef ssize_t (*prefetch_audio_loader)(const char *path, char **data,
+                                         size_t *size);
+
+struct prefetch_stats {
+    unsigned long hinted;       /**< decodes queued */
+    unsigned long ready;        /**< asked for after they were decoded */
+    unsigned long waited;       /**< asked for while being decoded */
+    unsigned long missed;       /**< asked for before being started */
+    unsigned long collected;    /**< moved into a cache unasked */
+    double wait_secs;           /**< main thread time spent waiting */
+};
+
+void prefetch_init(ImageCache::Loader decode_image,
+                   prefetch_audio_loader decode_audio);
+void prefetch_shutdown(void);
+void prefetch_image(const char *filename, int priority);
+void prefetch_audio(const char *name, int priority);
+void prefetch_collect(void);
+void prefetch_get_stats(struct prefetch_stats *stats);
+
+ImageCache::Image prefetch_load_image(const std::string &filename);
+ssize_t prefetch_load_audio(const char *name, char **data, size_t *size);
+
+void prefetch_screen_begin(const char *name);
+void prefetch_screen_ready(void);
+void prefetch_screen_end(void);
+
+#endif /* PREFETCH_H */
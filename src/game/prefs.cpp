@@ -293,6 +293,66 @@ void CLevels(char side, char wh, DisplayContext &dctx)
 }
 
 
+/**
+ * Load the hardware model and roster chosen in the preferences.
+ *
+ * Starting hardware is only reset for a new game.  The roster is copied
+ * to MEN.DAT, where the astronaut recruitment screens read it from.
+ *
+ * \param where  as for Prefs()
+ */
+void SetupGameModel(int where)
+{
+    FILE *fin;
+    int32_t size;
+    int i, k;
+
+    if ((where == 0 || where == 3) && (Data->Def.Input == 2 || Data->Def.Input == 3)) {
+        fin = sOpen("HIST.DAT", "rb", 0);
+        fread(&Data->P[0].Probe[PROBE_HW_ORBITAL], 28 * (sizeof(Equipment)), 1, fin);
+        fread(&Data->P[1].Probe[PROBE_HW_ORBITAL], 28 * (sizeof(Equipment)), 1, fin);
+        fclose(fin);
+    }
+
+    // Random Equipment
+    if ((where == 0 || where == 3) && (Data->Def.Input == 4 || Data->Def.Input == 5)) {
+        RandomizeEq();
+    }
+
+    for (i = 0; i < NUM_PLAYERS; i++) {
+        for (k = 0; k < 7; k++) {
+            Data->P[i].Probe[k].MSF = Data->P[i].Probe[k].MaxRD;
+            Data->P[i].Rocket[k].MSF = Data->P[i].Rocket[k].MaxRD;
+            Data->P[i].Manned[k].MSF = Data->P[i].Manned[k].MaxRD;
+            Data->P[i].Misc[k].MSF = Data->P[i].Misc[k].MaxRD;
+        }
+    }
+
+    if (Data->Def.Input == 0 || Data->Def.Input == 2 || Data->Def.Input == 4) {
+        // Hist Crews
+        fin = sOpen("CREW.DAT", "rb", 0);
+        size = fread(buffer, 1, BUFFER_SIZE, fin);
+        fclose(fin);
+        fin = sOpen("MEN.DAT", "wb", 1);
+        fwrite(buffer, size, 1, fin);
+        fclose(fin);
+    } else if (Data->Def.Input == 1 || Data->Def.Input == 3 || Data->Def.Input == 5) {
+        // User Crews
+        fin = sOpen("USER.DAT", "rb", FT_SAVE);
+
+        if (!fin) {
+            fin = sOpen("USER.DAT", "rb", FT_DATA);
+        }
+
+        size = fread(buffer, 1, BUFFER_SIZE, fin);
+        fclose(fin);
+        fin = sOpen("MEN.DAT", "wb", 1);
+        fwrite(buffer, size, 1, fin);
+        fclose(fin);
+    }
+}
+
+
 /**
  * Opens the settings menu for changing game settings.
  *
@@ -341,9 +401,7 @@ void CLevels(char side, char wh, DisplayContext &dctx)
 void Prefs(int where)
 {
     int num, hum1 = 0, hum2 = 0;
-    FILE *fin;
     char ch, Name[20], ksel = 0;
-    int32_t size;
     DisplayContext dctx;
 
     if (where != 3) {
@@ -428,52 +486,7 @@ void Prefs(int where)
 
                     key = 0;
 
-                    if ((where == 0 || where == 3) && (Data->Def.Input == 2 || Data->Def.Input == 3)) {
-                        fin = sOpen("HIST.DAT", "rb", 0);
-                        fread(&Data->P[0].Probe[PROBE_HW_ORBITAL], 28 * (sizeof(Equipment)), 1, fin);
-                        fread(&Data->P[1].Probe[PROBE_HW_ORBITAL], 28 * (sizeof(Equipment)), 1, fin);
-                        fclose(fin);
-                    }
-
-                    // Random Equipment
-                    if ((where == 0 || where == 3) && (Data->Def.Input == 4 || Data->Def.Input == 5)) {
-                        RandomizeEq();
-                    }
-
-                    int i, k;
-
-                    for (i = 0; i < NUM_PLAYERS; i++) {
-                        for (k = 0; k < 7; k++) {
-                            Data->P[i].Probe[k].MSF = Data->P[i].Probe[k].MaxRD;
-                            Data->P[i].Rocket[k].MSF = Data->P[i].Rocket[k].MaxRD;
-                            Data->P[i].Manned[k].MSF = Data->P[i].Manned[k].MaxRD;
-                            Data->P[i].Misc[k].MSF = Data->P[i].Misc[k].MaxRD;
-                        }
-                    }
-
-                    if (Data->Def.Input == 0 || Data->Def.Input == 2 || Data->Def.Input == 4) {
-                        // Hist Crews
-                        fin = sOpen("CREW.DAT", "rb", 0);
-                        size = fread(buffer, 1, BUFFER_SIZE, fin);
-                        fclose(fin);
-                        fin = sOpen("MEN.DAT", "wb", 1);
-                        fwrite(buffer, size, 1, fin);
-                        fclose(fin);
-                    } else if (Data->Def.Input == 1 || Data->Def.Input == 3 || Data->Def.Input == 5) {
-                        // User Crews
-                        fin = sOpen("USER.DAT", "rb", FT_SAVE);
-
-                        if (!fin) {
-                            fin = sOpen("USER.DAT", "rb", FT_DATA);
-                        }
-
-                        size = fread(buffer, 1, BUFFER_SIZE, fin);
-                        fclose(fin);
-                        fin = sOpen("MEN.DAT", "wb", 1);
-                        fwrite(buffer, size, 1, fin);
-                        fclose(fin);
-                    }
-
+                    SetupGameModel(where);
                     music_stop();
                     return;
                 }
@@ -2,5 +2,6 @@
 #define PREFS_H
 
 void Prefs(int where);
+void SetupGameModel(int where);
 
 #endif // PREFS_H
@@ -28,7 +28,9 @@
 #include "mis_c.h"
 #include "mis_m.h"
 
-char tYr, tMo;
+GAME_LOCAL char tYr, tMo;
+GAME_LOCAL_RESET(tYr);
+GAME_LOCAL_RESET(tMo);
 
 void Set_Dock(char plr, char total);
 void Set_LM(char plr, char total);
@@ -36,6 +36,7 @@
 #include "draw.h"
 #include "ast4.h"
 #include "game_main.h"
+#include "game_snapshot.h"
 #include "place.h"
 #include "sdlhelper.h"
 #include "gr.h"
@@ -46,8 +47,10 @@
 #include "hardware_buttons.h"
 #include "hardware.h"
 
-int call;
-int wh;
+GAME_LOCAL int call;
+GAME_LOCAL int wh;
+GAME_LOCAL_RESET(call);
+GAME_LOCAL_RESET(wh);
 boost::shared_ptr<display::PalettizedSurface> rd_men;
 
 
@@ -766,7 +769,7 @@ RDUnit(char hardwareTypeIndex, char hardwareIndex, char nRolls,
     int diceType = 6 + Data->P[playerIndex].RD_Mods_For_Turn;
 
     for (int i = 0; i < nRolls; i++) {
-        diceRoll += rand() % diceType + 1;
+        diceRoll += brandom(diceType) + 1;
     }
 
     eq.Safety += diceRoll;
@@ -1092,14 +1095,11 @@ void DrawHPurc(char player_index)
 char HPurc(char player_index)
 {
     short hardware, unit;
-    FILE *undo;
+    struct game_snapshot *undo;
 
     HardwareButtons hardware_buttons(30, player_index);
 
-    remove_savedat("UNDO.TMP");
-    undo = sOpen("UNDO.TMP", "wb", 1);
-    fwrite(Data, sizeof(struct Players), 1, undo);
-    fclose(undo);
+    undo = game_snapshot_fork();
 
     hardware = HARD1;
     unit = UNIT1;
@@ -1137,9 +1137,7 @@ char HPurc(char player_index)
         } else if ((x > 266 && y > 164 && x < 314 && y < 174 && mousebuttons > 0) || key == 'Z') {
             InBox(266, 164, 314, 174);
             WaitForMouseUp();
-            undo = sOpen("UNDO.TMP", "rb", 1);
-            fread(Data, sizeof(struct Players), 1, undo);
-            fclose(undo);
+            game_snapshot_restore(undo);
             ShowUnit(hardware, unit, player_index);
             OutBox(266, 164, 314, 174);
             key = 0;
@@ -1270,7 +1268,7 @@ char HPurc(char player_index)
             call = 0;
             HARD1 = PROBE_HARDWARE;
             UNIT1 = PROBE_HW_ORBITAL;
-            remove_savedat("UNDO.TMP");
+            game_snapshot_free(undo);
             return 0;   // Continue
         } else if ((x >= 5 && y >= 73 && x <= 152 && y <= 83 && mousebuttons > 0) || key == 'V') {  // Gateway to RD
             InBox(5, 73, 152, 83);
@@ -1278,10 +1276,10 @@ char HPurc(char player_index)
             HARD1 = hardware;
             UNIT1 = unit;
             music_stop();
-            remove_savedat("UNDO.TMP");
 
             // DM Screen, Nikakd, 10/8/10 (Removed line)
             if (call == 1) {
+                game_snapshot_free(undo);
                 return 1;
             }
 
@@ -1289,6 +1287,7 @@ char HPurc(char player_index)
             wh = RD(player_index);
 
             if (call == 0) {
+                game_snapshot_free(undo);
                 return 0;    // Exit
             }
 
@@ -1300,9 +1299,7 @@ char HPurc(char player_index)
             hardware_buttons.drawButtons(hardware);
 
             // Just Added stuff by mike
-            undo = sOpen("UNDO.TMP", "wb", 1);
-            fwrite(Data, sizeof(struct Players), 1, undo);
-            fclose(undo);
+            game_snapshot_take(undo);
 
             FadeIn(2, 10, 0, 0);
             music_start(M_FILLER);
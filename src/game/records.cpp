@@ -18,6 +18,8 @@
 
 // This file handles the Mission Records screen
 
+#include <SDL/SDL.h>
+
 #include "display/graphics.h"
 
 #include "Buzz_inc.h"
@@ -40,8 +42,17 @@ LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
 void RecChange(int i, int j, int k, int temp, int max, char Rec_Change, char hold);
 int ISDOCK(int a);
 
-char NREC[56][3];
-Record_Entry rec[56][3];
+GAME_LOCAL char NREC[56][3];
+GAME_LOCAL Record_Entry rec[56][3];
+GAME_LOCAL_RESET(NREC);
+GAME_LOCAL_RESET(rec);
+
+/*
+ * RECORDS.DAT is read, changed and written back as a whole by games
+ * that may be played at once, so those updates hold records_lock.  It
+ * is made by MakeRecords(), at start-up, before there are other threads.
+ */
+static SDL_mutex *records_lock;
 
 void Move2rec(char *pos, char *pos2, char val);
 void ClearRecord(char *pos2);
@@ -142,6 +153,10 @@ void MakeRecords(void)
     FILE *file;
     int i, j;
 
+    if (!records_lock) {
+        records_lock = SDL_CreateMutex();
+    }
+
     if ((file = sOpen("RECORDS.DAT", "rb", FT_SAVE_CHECK)) == NULL) {
         file = sOpen("RECORDS.DAT", "wb", 1);
 
@@ -734,6 +749,7 @@ void SafetyRecords(char plr, int temp)
 {
     int j, k;
     FILE *fin, *bo;
+    SDL_mutexP(records_lock);
     fin = sOpen("RECORDS.DAT", "rb", 1);
 
     for (int i = 0; i < 56; i++) {
@@ -819,6 +835,7 @@ void SafetyRecords(char plr, int temp)
     }
 
     fclose(bo);
+    SDL_mutexV(records_lock);
 
     return;
 }
@@ -845,6 +862,7 @@ void UpdateRecords(char Ty)
     fread(Miss, 60 * (sizeof(struct mStr)), 1, file);
     fclose(file);
 
+    SDL_mutexP(records_lock);
     file = sOpen("RECORDS.DAT", "rb", 1);
 
     for (i = 0; i < 56; i++) {
@@ -2054,6 +2072,7 @@ void UpdateRecords(char Ty)
     }
 
     fclose(file);
+    SDL_mutexV(records_lock);
     return;
 }
 
@@ -19,6 +19,8 @@
     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
+#include "game_context.h"
+
 void Records(char plr);
 void UpdateRecords(char Ty);
 void SafetyRecords(char plr, int temp);
@@ -36,7 +38,7 @@ typedef struct pEtype {
     char astro[14];
 }  Record_Entry;
 
-extern Record_Entry rec[56][3];
+extern GAME_LOCAL Record_Entry rec[56][3];
 
 /* The beauty of awk */
 
@@ -34,9 +34,14 @@
 #include "Buzz_inc.h"
 #include "mmfile.h"
 #include "game_main.h"
+#include "options.h"
 #include "sdlhelper.h"
 #include "gr.h"
 #include "pace.h"
+#include "utils.h"
+#include "media_clock.h"
+#include "seq_index.h"
+#include "video_sequence.h"
 
 LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
 
@@ -50,17 +55,14 @@ static int
 find_replay(REPLAY *rep, struct oGROUP *grp, char player, int num,
             const char *type)
 {
-    FILE *fseq = NULL;
-    struct oGROUP group;
+    const struct oGROUP *group;
     size_t offset = 0;
-    int retval = 0;
+    int index;
 
     assert(rep);
 
     /** \note uses SEQ.DAT */
-    fseq = sOpen("SEQ.DAT", "rb", 0);
-
-    if (!fseq) {
+    if (seq_index_load() < 0) {
         return -1;
     }
 
@@ -68,41 +70,24 @@ find_replay(REPLAY *rep, struct oGROUP *grp, char player, int num,
         offset = (player * 100) + num;
         memcpy(rep, &interimData.tempReplay[offset], sizeof(REPLAY));
 
-        if (grp && fseek(fseq, sizeof_oGROUP * rep->Off[0], SEEK_SET) == 0) {
-            fread_oGROUP(grp, 1, fseq);
+        if (grp && (group = seq_group(rep->Off[0])) != NULL) {
+            memcpy(grp, group, sizeof(*group));
         }
     } else {
-        int j = 0;
-
-        while (fread_oGROUP(&group, 1, fseq)) {
-            if (strncmp(group.ID, "XXXX", 4) == 0) {
-                /* bad sequence? */
-                retval = -1;
-                goto done;
-            }
-
-            if (strcmp(&group.ID[3], type) == 0) {
-                break;
-            }
-
-            j++;
+        if ((index = seq_find_group(type)) < 0) {
+            /* bad sequence? */
+            return -1;
         }
 
         rep->Qty = 1;
-        rep->Off[0] = j;
+        rep->Off[0] = index;
 
         if (grp) {
-            memcpy(grp, &group, sizeof(group));
+            memcpy(grp, seq_group(index), sizeof(*grp));
         }
     }
 
-done:
-
-    if (fseq) {
-        fclose(fseq);
-    }
-
-    return retval;
+    return 0;
 }
 
 /**
@@ -114,17 +99,17 @@ void
 Replay(char plr, int num, int dx, int dy, int width, int height, const char *Type)
 {
     int keep_going;
-    int i, kk, mode, max;
-    FILE *seqf, *fseqf;
-    int32_t offset;
-    struct oGROUP group;
-    struct oFGROUP fgroup;
-    struct Table table;
+    std::vector<std::string> clips;
+    struct video_sequence *seq;
+    struct media_clock clock;
     REPLAY Rep;
-
-    mm_file vidfile;
+    double pts;
     float fps;
 
+    if (options.headless) {
+        return;
+    }
+
     if (find_replay(&Rep, NULL, plr, num, Type) < 0) {
         return;
     }
@@ -132,122 +117,55 @@ Replay(char plr, int num, int dx, int dy, int width, int height, const char *Typ
     /** \note uses SEQ.DAT
      *  \note uses FSEQ.DAT
      */
-    seqf = sOpen("SEQ.DAT", "rb", 0);
-
-    if (!seqf) {
-        return;
-    }
-
-    fseqf = sOpen("FSEQ.DAT", "rb", 0);
-
-    if (!fseqf) {
-        fclose(seqf);
+    if (seq_replay_clips(&Rep, clips) <= 0) {
         return;
     }
 
     WaitForMouseUp();
 
-    DEBUG2("video sequence: %d segments", Rep.Qty);
-
-    for (kk = 0; kk < Rep.Qty; kk++) {
-        DEBUG3("playing segment %d: %d", kk, Rep.Off[kk]);
-
-        if (Rep.Off[kk] < 1000) {  //Specs: success seq
-            fseek(seqf, Rep.Off[kk] * sizeof_oGROUP, SEEK_SET);
-            fread_oGROUP(&group, 1, seqf);
-            max = group.ID[1] - '0';
-            mode = 0;
-        } else {
-            //Specs: failure seq
-            int j = 0;
-            // MAX 50 Tables
-            i = Rep.Off[kk] / 1000;
-            j = Rep.Off[kk] % 1000;
-
-            if (i == 0 || i == 50) {
-                goto done;
-            }
-
-            i--;                   //Specs: offset index kludge
-            fseek(fseqf, i * sizeof_Table, SEEK_SET);
-            fread_Table(&table, 1, fseqf);
-            offset = table.foffset;
-            fseek(fseqf, offset + j * sizeof_oFGROUP, SEEK_SET);
-            fread_oFGROUP(&fgroup, 1, fseqf);
-            mode = 1;
-            max = fgroup.ID[1] - '0';
-        }
-
-        i = 0;
-
-        keep_going = 1;
-
-        //  update_map = 0;
-        while (keep_going && i < max) {
-            int frm_idx;
-            char *seq_fname = NULL;
-            char fname[20];
+    DEBUG3("video sequence: %d segments, %d clips", Rep.Qty,
+           (int) clips.size());
 
-            if (mode == 1) {       /* failure */
-                frm_idx = fgroup.oLIST[i].aIdx;
-            } else {
-                frm_idx = group.oLIST[i].aIdx;
-            }
-
-            /* here we should create YUV Overlay, but we can't use it on
-             * pallettized surface, so we use a global Overlay initialized in
-             * sdl.c. */
-            seq_fname = seq_filename(frm_idx, mode);
+    /* here we should create YUV Overlay, but we can't use it on
+     * pallettized surface, so we use a global Overlay initialized in
+     * sdl.c. */
+    if ((seq = video_sequence_open(clips,
+                                   display::graphics.videoOverlay())) == NULL) {
+        return;
+    }
 
-            if (!seq_fname) {
-                seq_fname = "(unknown)";
-            }
+    keep_going = 1;
+    media_clock_start(&clock, "replay");
 
-            /** \todo assumption on file extension */
-            snprintf(fname, sizeof(fname), "%s.ogg", seq_fname);
+    while (keep_going) {
+        double start = get_time();
 
-            INFO2("opening video file `%s'", fname);
+        display::graphics.videoRect().x = dx;
+        display::graphics.videoRect().y = dy;
+        display::graphics.videoRect().w = width;
+        display::graphics.videoRect().h = height;
 
-            if (mm_open_fp(&vidfile, sOpen(fname, "rb", FT_VIDEO)) <= 0) {
-                goto done;
-            }
+        if (video_sequence_next(seq, &pts, &fps) <= 0) {
+            break;
+        }
 
-            /** \todo do not ignore width/height */
-            if (mm_video_info(&vidfile, NULL, NULL, &fps) <= 0) {
-                goto done;
+        if (media_clock_wait(&clock, pts, 1.0 / fps, get_time() - start)) {
+            if (video_sequence_show(seq, display::graphics.videoOverlay()) < 0) {
+                break;
             }
 
-            while (keep_going) {
-                display::graphics.videoRect().x = dx;
-                display::graphics.videoRect().y = dy;
-                display::graphics.videoRect().w = width;
-                display::graphics.videoRect().h = height;
-
-                /** \todo track decoding time and adjust delays */
-                if (mm_decode_video(&vidfile, display::graphics.videoOverlay()) <= 0) {
-                    break;
-                }
-
-                if (bioskey(0) || grGetMouseButtons()) {
-                    keep_going = 0;
-                }
-
-                /** \todo idle_loop is too inaccurate for this */
-                idle_loop_secs(1.0 / fps);
-            }
+            gr_sync();
+        }
 
-            mm_close(&vidfile);
-            i++;
+        if (bioskey(0) || grGetMouseButtons()) {
+            keep_going = 0;
         }
     }
 
-done:
-    mm_close(&vidfile);
+    media_clock_stop(&clock);
+    video_sequence_close(seq);
     display::graphics.videoRect().w = 0;
     display::graphics.videoRect().h = 0;
-    fclose(fseqf);
-    fclose(seqf);
-    return;
 }
 
 void
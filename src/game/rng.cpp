@@ -0,0 +1,164 @@
+// This file holds the random number generator games are played with.
+
+#include "rng.h"
+
+#include <assert.h>
+#include <string.h>
+
+GAME_LOCAL struct rng game_rng;
+GAME_LOCAL_RESET(game_rng);
+
+/*
+ * MisRandom() used to add up 250 rolls of brandom(7) - 3 and start over
+ * until the total fell within a window.  The distribution of that total
+ * is worked out once here as a cumulative table, scaled to 2^32, which
+ * rng_bell() looks a single 32-bit draw up in.  bell_guide[k] is the
+ * first value whose table entry is above k << 24, so the lookup starts
+ * at most a step or two short of the answer.
+ */
+#define BELL_ROLLS  250
+#define BELL_SIDES  7
+#define BELL_LOW    (-57)   /* window of totals, nval 50 to 150 */
+#define BELL_SPAN   (BELL_ROLLS * (BELL_SIDES - 1) + 1)
+
+static uint64_t bell_cdf[RNG_BELL_VALUES];
+static unsigned char bell_guide[256];
+
+static void
+bell_init(void)
+{
+    static double pmf[BELL_SPAN], next[BELL_SPAN];
+    double sum = 0, acc = 0;
+    int k, i;
+
+    /* pmf[t] is the chance of the rolls adding up to t, counted from 0 */
+    memset(pmf, 0, sizeof(pmf));
+    pmf[0] = 1;
+
+    for (k = 0; k < BELL_ROLLS; k++) {
+        int top = k * (BELL_SIDES - 1);
+
+        memset(next, 0, sizeof(next));
+
+        for (i = 0; i <= top; i++) {
+            for (int side = 0; side < BELL_SIDES; side++) {
+                next[i + side] += pmf[i] / BELL_SIDES;
+            }
+        }
+
+        memcpy(pmf, next, sizeof(pmf));
+    }
+
+    /* shift to rolls of -3 to 3, and keep the window only */
+    double *win = pmf + BELL_ROLLS * (BELL_SIDES - 1) / 2 + BELL_LOW;
+
+    for (i = 0; i < RNG_BELL_VALUES; i++) {
+        sum += win[i];
+    }
+
+    for (i = 0; i < RNG_BELL_VALUES; i++) {
+        acc += win[i];
+        bell_cdf[i] = (uint64_t)(acc / sum * 4294967296.0 + 0.5);
+    }
+
+    bell_cdf[RNG_BELL_VALUES - 1] = (uint64_t)1 << 32;
+
+    for (k = 0, i = 0; k < 256; k++) {
+        while (bell_cdf[i] <= ((uint64_t)k << 24)) {
+            i++;
+        }
+
+        bell_guide[k] = i;
+    }
+}
+
+/* fill the tables before main(), so no thread can race to do it */
+static struct bell_setup {
+    bell_setup()
+    {
+        bell_init();
+    }
+} bell_setup_once;
+
+static inline uint64_t
+rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Start a stream from a seed.  Equal seeds give equal streams.
+ */
+void
+rng_seed(struct rng *r, uint64_t seed)
+{
+    assert(r);
+
+    /* splitmix64 spreads the seed over the whole state */
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        r->s[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * The next 64 random bits of a stream.
+ *
+ * A stream never seeded is all zero, which xoshiro never leaves, so it
+ * would only ever give 0.  Threads other than the one a game was seeded
+ * on start out like that, and such a stream is seeded with 0 on its first
+ * draw instead.
+ */
+uint64_t
+rng_next(struct rng *r)
+{
+    uint64_t *s = r->s;
+
+    if ((s[0] | s[1] | s[2] | s[3]) == 0) {
+        rng_seed(r, 0);
+    }
+
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * A number from 0 to limit - 1, scaled the way brandom() always has,
+ * so a negative limit gives a number from limit + 1 to 0.
+ */
+int
+rng_below(struct rng *r, int limit)
+{
+    uint32_t x = rng_next(r) >> 32;
+
+    return (int)(limit * (x / 4294967296.0));
+}
+
+/**
+ * A number from 0 to 100, distributed like MisRandom() always has: a
+ * bell around 57.
+ */
+int
+rng_bell(struct rng *r)
+{
+    uint64_t x = rng_next(r) >> 32;
+    int i = bell_guide[x >> 24];
+
+    while (x >= bell_cdf[i]) {
+        i++;
+    }
+
+    return i;
+}
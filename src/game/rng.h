@@ -0,0 +1,31 @@
+#ifndef RNG_H
+#define RNG_H
+
+/**
+ * \file rng.h The random number stream of a game.
+ *
+ * A small xoshiro256** generator, so a game played from the same seed
+ * makes the same choices and rolls the same dice every time.  Each
+ * thread has its own stream in game_rng, like the rest of the game
+ * state, and brandom() and MisRandom() draw from it.
+ */
+
+#include <stdint.h>
+
+#include "game_context.h"
+
+struct rng {
+    uint64_t s[4];
+};
+
+/** most values rng_bell() returns, plus one */
+#define RNG_BELL_VALUES 101
+
+extern GAME_LOCAL struct rng game_rng;
+
+void rng_seed(struct rng *r, uint64_t seed);
+uint64_t rng_next(struct rng *r);
+int rng_below(struct rng *r, int limit);
+int rng_bell(struct rng *r);
+
+#endif /* RNG_H */
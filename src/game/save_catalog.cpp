@@ -0,0 +1,250 @@
+// This file keeps a catalog of the saved games and their headers
+
+#include "save_catalog.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#include "Buzz_inc.h"
+#include "options.h"
+#include "logging.h"
+
+
+LOG_DEFAULT_CATEGORY(filesys)
+
+namespace
+{
+
+// The catalog lives next to the saves. It is only a cache, so it uses
+// the native layout and is rebuilt whenever it doesn't look right.
+const char CATALOG_NAME[] = "SAVES.CAT";
+const uint32_t CATALOG_MAGIC = 0x52695343;  // 'RiSC'
+const uint32_t CATALOG_VERSION = 1;
+
+struct CatalogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;    // sizeof(SaveFileHdr) when written
+    uint32_t count;
+};
+
+struct CatalogRecord {
+    char name[64];          // as in struct ffblk
+    int64_t mtime;
+    int64_t size;
+    SaveFileHdr header;
+};
+
+typedef std::map<std::string, SaveCatalogEntry> Catalog;
+
+SaveGameType ClassifySave(const SaveFileHdr &header);
+Catalog LoadCatalog();
+bool ReadHeader(SaveCatalogEntry &entry);
+void StoreCatalog(const std::vector<SaveCatalogEntry> &saves);
+};
+
+
+//----------------------------------------------------------------------
+// Header function definitions
+//----------------------------------------------------------------------
+
+
+/* Lists the saved games along with their headers.
+ *
+ * Headers are kept in a catalog file in the savegame directory. A save
+ * is only opened if it is new or its modification time or size changed
+ * since the catalog was written, so an unchanged directory costs one
+ * read of the catalog plus a stat() per save. The catalog is rewritten
+ * when anything changed.
+ *
+ * \return  every readable save, in directory order.
+ */
+std::vector<SaveCatalogEntry> ReadSaveCatalog()
+{
+    Catalog catalog = LoadCatalog();
+    std::vector<SaveCatalogEntry> saves;
+    struct ffblk ffblk;
+    bool changed = false;
+    int done = first_saved_game(&ffblk);
+
+    for (; !done; done = next_saved_game(&ffblk)) {
+        std::string path =
+            std::string(options.dir_savegame) + "/" + ffblk.ff_name;
+        struct stat st;
+
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+
+        Catalog::iterator it = catalog.find(ffblk.ff_name);
+
+        if (it != catalog.end() &&
+            it->second.mtime == static_cast<int64_t>(st.st_mtime) &&
+            it->second.size == static_cast<int64_t>(st.st_size)) {
+            saves.push_back(it->second);
+            catalog.erase(it);
+            continue;
+        }
+
+        SaveCatalogEntry entry;
+        entry.name = ffblk.ff_name;
+        entry.mtime = st.st_mtime;
+        entry.size = st.st_size;
+        changed = true;
+
+        if (ReadHeader(entry)) {
+            saves.push_back(entry);
+        }
+    }
+
+    // Anything left over has been deleted
+    if (changed || !catalog.empty()) {
+        StoreCatalog(saves);
+    }
+
+    return saves;
+}
+
+
+//----------------------------------------------------------------------
+// Local definitions
+//----------------------------------------------------------------------
+
+namespace  // Start of local namespace
+{
+
+/* Works out the kind of game from the country codes, as the load
+ * screen always has.
+ */
+SaveGameType ClassifySave(const SaveFileHdr &header)
+{
+    if (header.Country[0] == 8 || header.Country[1] == 9) {
+        return SAVEGAME_PlayByMail;
+    } else if (header.Country[0] == 6 || header.Country[1] == 7) {
+        return SAVEGAME_Modem;
+    }
+
+    return SAVEGAME_Normal;
+}
+
+
+/* Reads the catalog file, if there is a usable one.
+ */
+Catalog LoadCatalog()
+{
+    Catalog catalog;
+    CatalogHeader header;
+    long size;
+    FILE *fin = sOpen(CATALOG_NAME, "rb", FT_SAVE_CHECK);
+
+    if (!fin) {
+        return catalog;
+    }
+
+    if (fread(&header, sizeof(header), 1, fin) != 1 ||
+        header.magic != CATALOG_MAGIC ||
+        header.version != CATALOG_VERSION ||
+        header.headerSize != sizeof(SaveFileHdr)) {
+        INFO2("ignoring out of date `%s'", CATALOG_NAME);
+        fclose(fin);
+        return catalog;
+    }
+
+    // Check the count against the file before trusting it with memory
+    if (fseek(fin, 0, SEEK_END) != 0 || (size = ftell(fin)) < 0 ||
+        (size - sizeof(header)) / sizeof(CatalogRecord) < header.count ||
+        fseek(fin, sizeof(header), SEEK_SET) != 0) {
+        WARNING2("`%s' is truncated", CATALOG_NAME);
+        fclose(fin);
+        return catalog;
+    }
+
+    std::vector<CatalogRecord> records(header.count);
+
+    if (header.count &&
+        fread(&records[0], sizeof(CatalogRecord), header.count, fin)
+        != header.count) {
+        WARNING2("`%s' is truncated", CATALOG_NAME);
+        fclose(fin);
+        return catalog;
+    }
+
+    fclose(fin);
+
+    for (size_t i = 0; i < records.size(); i++) {
+        SaveCatalogEntry entry;
+
+        records[i].name[sizeof(records[i].name) - 1] = '\0';
+        entry.name = records[i].name;
+        entry.header = records[i].header;
+        entry.mtime = records[i].mtime;
+        entry.size = records[i].size;
+        entry.type = ClassifySave(entry.header);
+        catalog[entry.name] = entry;
+    }
+
+    return catalog;
+}
+
+
+/* Fills in the header of a save from the file itself.
+ */
+bool ReadHeader(SaveCatalogEntry &entry)
+{
+    FILE *fin = sOpen(entry.name.c_str(), "rb", FT_SAVE);
+
+    if (!fin) {
+        return false;
+    }
+
+    memset(&entry.header, 0, sizeof(entry.header));
+    fread(&entry.header, 1, sizeof(entry.header), fin);
+    fclose(fin);
+
+    entry.type = ClassifySave(entry.header);
+    return true;
+}
+
+
+/* Writes the catalog file. Failing to is harmless, the headers will
+ * just be read from the saves again next time.
+ */
+void StoreCatalog(const std::vector<SaveCatalogEntry> &saves)
+{
+    CatalogHeader header;
+    std::vector<CatalogRecord> records(saves.size());
+
+    for (size_t i = 0; i < saves.size(); i++) {
+        memset(&records[i], 0, sizeof(records[i]));
+        strncpy(records[i].name, saves[i].name.c_str(),
+                sizeof(records[i].name) - 1);
+        records[i].mtime = saves[i].mtime;
+        records[i].size = saves[i].size;
+        records[i].header = saves[i].header;
+    }
+
+    header.magic = CATALOG_MAGIC;
+    header.version = CATALOG_VERSION;
+    header.headerSize = sizeof(SaveFileHdr);
+    header.count = records.size();
+
+    FILE *fout = sOpen(CATALOG_NAME, "wb", FT_SAVE);
+
+    if (!fout) {
+        return;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, fout) != 1 ||
+        (header.count &&
+         fwrite(&records[0], sizeof(CatalogRecord), header.count, fout)
+         != header.count)) {
+        WARNING2("could not write `%s'", CATALOG_NAME);
+    }
+
+    fclose(fout);
+}
+
+};  // End of local namespace
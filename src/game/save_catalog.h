@@ -0,0 +1,21 @@
+#ifndef SAVE_CATALOG_H
+#define SAVE_CATALOG_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "data.h"
+
+struct SaveCatalogEntry {
+    std::string name;       // file name within the savegame directory
+    SaveFileHdr header;
+    int64_t mtime;
+    int64_t size;
+    SaveGameType type;
+};
+
+std::vector<SaveCatalogEntry> ReadSaveCatalog();
+
+#endif // SAVE_CATALOG_H
@@ -30,6 +30,11 @@
 #include "display/surface.h"
 
 #include "sdlhelper.h"
+#include "mixer.h"
+#include "audio_stream.h"
+#include "audio_cache.h"
+#include "prefetch.h"
+#include "pace.h"
 #include <assert.h>
 #include <memory.h>
 #include <SDL/SDL.h>
@@ -55,6 +60,20 @@ int av_mouse_pressed_latched;
 
 static SDL_Color pal_colors[256];
 
+/* pal_colors mapped to display pixel values, see transform_palette() */
+static Uint32 display_colors[256];
+
+/* overlay areas shown by the previous av_sync(), in screen coordinates */
+static SDL_Rect shown_video_rect;
+static SDL_Rect shown_news_rect;
+
+/* presentation statistics, see av_sync() */
+static struct {
+    unsigned frames;
+    unsigned long long pixels;
+    unsigned last_pixels;
+} sync_stats;
+
 static struct audio_channel Channels[AV_NUM_CHANNELS];
 
 /* information about current fading operation */
@@ -68,6 +87,17 @@ static struct {
     unsigned end;
 } fade_info;
 
+/* palette version and fading state display_colors was built from */
+static struct {
+    int valid;
+    unsigned version;
+    unsigned from;
+    unsigned to;
+    unsigned step;
+    unsigned steps;
+    unsigned force_black;
+} pal_key;
+
 /** Assume we have audio until we try to initialize and find that we can't */
 static int have_audio = 1;
 
@@ -86,20 +116,23 @@ audio_callback(void *userdata, Uint8 *stream, int len)
         int pos = 0;
         struct audio_channel *chp = &Channels[ch];
 
-        if (!chp->mute && chp->volume) {
+        /* a muted channel is paused once it has faded out */
+        if (chp->stream) {
+            if (!mixer_voice_silent(&chp->voice)) {
+                audio_stream_mix(chp->stream, (int16_t *) stream, len / 2,
+                                 &chp->voice);
+            }
+        } else if (!mixer_voice_silent(&chp->voice)) {
             struct audio_chunk *ac = chp->chunk;
 
             while (ac) {
                 int bytes =
                     MIN(len - pos, (int) ac->size - (int) chp->offset);
 
-                int i = 0;
                 int16_t *dst = (int16_t *)(stream + pos);
                 const int16_t *src = (int16_t *)((uint8_t *) ac->data + chp->offset);
 
-                for (i = 0; i < bytes / 2; ++i) {
-                    dst[i] += src[i] * chp->volume / AV_MAX_VOLUME / AV_NUM_CHANNELS;
-                }
+                mixer_mix(dst, src, bytes / 2, &chp->voice);
 
                 pos += bytes;
                 chp->offset += bytes;
@@ -127,6 +160,17 @@ audio_callback(void *userdata, Uint8 *stream, int len)
     }
 }
 
+/** Gain the mixer should apply to a channel in its current state. */
+static int
+channel_gain(const struct audio_channel *chp)
+{
+    if (chp->mute) {
+        return 0;
+    }
+
+    return mixer_gain(chp->volume, AV_MAX_VOLUME, AV_NUM_CHANNELS);
+}
+
 /** Check if animation sound playback is in progress.
  * Currently #AV_SOUND_CHANNEL is used only for animation sounds.
  * \return 0 means busy playing audio; 1 means idle
@@ -156,6 +200,13 @@ IsChannelMute(int channel)
     return Channels[channel].mute;
 }
 
+/** Check whether sound is played at all, as it isn't when headless. */
+int
+av_have_audio(void)
+{
+    return have_audio;
+}
+
 void
 play(struct audio_chunk *new_chunk, int channel)
 {
@@ -197,16 +248,44 @@ av_silence(int channel)
     } else {
         assert(channel >= 0 && channel < AV_NUM_CHANNELS);
 
-        if (Channels[channel].chunk) {
+        if (Channels[channel].chunk || Channels[channel].stream) {
             SDL_LockAudio();
             Channels[channel].chunk = NULL;
             Channels[channel].chunk_tailp = &Channels[channel].chunk;
             Channels[channel].offset = 0;
+            Channels[channel].stream = NULL;
             SDL_UnlockAudio();
         }
     }
 }
 
+/**
+ * Play a stream on a channel, replacing whatever the channel was playing.
+ *
+ * The caller still owns the stream and must av_silence() the channel
+ * before closing it.
+ */
+void
+av_play_stream(struct audio_stream *stream, int channel)
+{
+    struct audio_channel *chp;
+
+    assert(channel >= 0 && channel < AV_NUM_CHANNELS);
+
+    chp = &Channels[channel];
+
+    if (!have_audio) {
+        return;
+    }
+
+    SDL_LockAudio();
+    chp->chunk = NULL;
+    chp->chunk_tailp = &chp->chunk;
+    chp->offset = 0;
+    chp->stream = stream;
+    SDL_UnlockAudio();
+}
+
 Uint32
 sdl_timer_callback(Uint32 interval, void *param)
 {
@@ -229,8 +308,18 @@ av_setup(void)
     std::string title(PACKAGE_STRING);
 #endif
 
+    /* draw off screen, and don't open a sound device or fade */
+    if (options.headless) {
+        SDL_putenv("SDL_VIDEODRIVER=dummy");
+        SDL_putenv("SDL_AUDIODRIVER=dummy");
+        have_audio = 0;
+    }
+
+    if (!options.want_audio) {
+        have_audio = 0;
+    }
 
-    display::graphics.create(title, (options.want_fullscreen == 1));
+    display::graphics.create(title, (options.want_fullscreen == 1), options.want_scale);
 
 
 #ifdef SET_SDL_ICON
@@ -253,12 +342,14 @@ av_setup(void)
 
     fade_info.step = 1;
     fade_info.steps = 1;
-    do_fading = 1;
+    do_fading = !options.headless;
 
     SDL_EnableUNICODE(1);
     SDL_EnableKeyRepeat(SDL_DEFAULT_REPEAT_DELAY,
                         SDL_DEFAULT_REPEAT_INTERVAL);
 
+    audio_cache_init(options.audio_cache_kb * 1024, prefetch_load_audio);
+
     if (have_audio) {
         int i = 0;
 
@@ -272,10 +363,12 @@ av_setup(void)
         /* initialize audio channels */
         for (i = 0; i < AV_NUM_CHANNELS; ++i) {
             Channels[i].volume = AV_MAX_VOLUME;
+            mixer_init_voice(&Channels[i].voice, channel_gain(&Channels[i]));
             Channels[i].mute = 0;
             Channels[i].chunk = NULL;
             Channels[i].chunk_tailp = &Channels[i].chunk;
             Channels[i].offset = 0;
+            Channels[i].stream = NULL;
         }
 
         /* we don't care what we got, library will convert for us */
@@ -284,6 +377,7 @@ av_setup(void)
             NOTICE1("disabling audio");
             have_audio = 0;
         } else {
+            INFO2("mixing audio with the %s kernel", mixer_kernel_name());
             SDL_PauseAudio(0);
         }
     }
@@ -412,6 +506,11 @@ av_process_event(SDL_Event *evp)
         av_mouse_cur_y = evp->motion.y;
         break;
 
+    case SDL_VIDEOEXPOSE:
+        /* window contents were lost, repaint everything on next sync */
+        display::graphics.screen()->markDirty();
+        break;
+
     /* ignore these events */
     case SDL_KEYUP:
     case SDL_ACTIVEEVENT:
@@ -429,6 +528,11 @@ av_step(void)
 {
     SDL_Event ev;
 
+    /* events are only pumped on the main thread, and there are none */
+    if (options.headless) {
+        return;
+    }
+
     /* Have the music system update itself as required */
     music_pump();
 
@@ -448,6 +552,10 @@ av_block(void)
 {
     SDL_Event ev;
 
+    if (options.headless) {
+        return;
+    }
+
     if (SDL_WaitEvent(&ev)) {
         av_process_event(&ev);
         av_step();                 /* soak up any other currently available events */
@@ -491,113 +599,15 @@ NUpdateVoice(void)
     av_step();
 }
 
-static SDL_Surface *
-SDL_Scale2x(SDL_Surface *src, SDL_Surface *dst)
-{
-    int x, y, bpp;
-    uint8_t *from, *to;
-    SDL_Rect clp;
-    SDL_PixelFormat *pf;
-
-    assert(src);
-    assert(src != dst);
-
-    pf = src->format;
-
-    if (!dst)
-        dst = SDL_CreateRGBSurface(SDL_SWSURFACE,
-                                   2 * src->w, 2 * src->h,
-                                   pf->BitsPerPixel, pf->Rmask, pf->Gmask, pf->Bmask, pf->Amask);
-
-    if (!dst) {
-        return NULL;
-    }
-
-    bpp = pf->BytesPerPixel;
-
-    if (2 * src->h != dst->h
-        || 2 * src->w != dst->w || bpp != dst->format->BytesPerPixel) {
-        SDL_SetError("dst surface size or bpp mismatch (%d vs %d)",
-                     bpp, dst->format->BytesPerPixel);
-        return NULL;
-    }
-
-    if (bpp == 1) {
-        SDL_SetColors(dst, pf->palette->colors, 0, pf->palette->ncolors);
-    }
-
-    if (SDL_MUSTLOCK(src)) {
-        SDL_LockSurface(src);
-    }
-
-    if (SDL_MUSTLOCK(dst)) {
-        SDL_LockSurface(dst);
-    }
-
-    SDL_GetClipRect(dst, &clp);
-
-    for (y = clp.y / 2; y < clp.y / 2 + clp.h / 2; ++y) {
-        for (x = clp.x / 2; x < clp.x / 2 + clp.w / 2; ++x) {
-            from = ((uint8_t *) src->pixels) + y * src->pitch + x * bpp;
-            to = ((uint8_t *) dst->pixels) + 2 * y * dst->pitch +
-                 2 * x * bpp;
-
-            switch (bpp) {
-#define ASSIGN do { \
-                    *(TYPE (to)) = *(TYPE from); \
-                    *(TYPE (to+bpp)) = *(TYPE from); \
-                    *(TYPE (to+dst->pitch)) = *(TYPE from); \
-                    *(TYPE (to+dst->pitch+bpp)) = *(TYPE from); \
-                } while (0)
-
-            case 1:
-#define TYPE (uint8_t *)
-                ASSIGN;
-                break;
-#undef TYPE
-
-            case 2:
-#define TYPE (uint16_t *)
-                ASSIGN;
-                break;
-#undef TYPE
-
-            case 3:
-#define TYPE (uint8_t *)
-                ASSIGN;
-                to++;
-                from++;
-                ASSIGN;
-                to++;
-                from++;
-                ASSIGN;
-                to++;
-                from++;
-                break;
-#undef TYPE
-
-            case 4:
-#define TYPE (uint32_t *)
-                ASSIGN;
-                break;
-#undef TYPE
-#undef ASSIGN
-            }
-        }
-    }
-
-    if (SDL_MUSTLOCK(dst)) {
-        SDL_UnlockSurface(dst);
-    }
-
-    if (SDL_MUSTLOCK(src)) {
-        SDL_UnlockSurface(src);
-    }
-
-    return dst;
-}
-
-static void
+/**
+ * Recompute the faded palette and the display color table.
+ *
+ * This is skipped unless the screen palette changed (its version advanced)
+ * or the fading state moved on since the previous call.
+ *
+ * \return 1 if the colors changed, 0 otherwise
+ */
+static int
 transform_palette(void)
 {
     unsigned i, j, step, steps;
@@ -605,14 +615,36 @@ transform_palette(void)
         unsigned start, end;
     } ranges[] = {{0, fade_info.from}, {fade_info.to, 256}};
 
-    display::AutoPal p(display::graphics.legacyScreen());
+    const display::PaletteInterface &p = display::graphics.legacyScreen()->palette();
+    SDL_PixelFormat *format = display::graphics.displaySurface()->format;
+
+    if (pal_key.valid
+        && pal_key.version == p.version()
+        && pal_key.from == fade_info.from
+        && pal_key.to == fade_info.to
+        && pal_key.step == fade_info.step
+        && pal_key.steps == fade_info.steps
+        && pal_key.force_black == fade_info.force_black) {
+        return 0;
+    }
+
+    pal_key.valid = 1;
+    pal_key.version = p.version();
+    pal_key.from = fade_info.from;
+    pal_key.to = fade_info.to;
+    pal_key.step = fade_info.step;
+    pal_key.steps = fade_info.steps;
+    pal_key.force_black = fade_info.force_black;
 
     for (j = 0; j < ARRAY_LENGTH(ranges); ++j) {
         for (i = ranges[j].start; i < ranges[j].end; ++i) {
             if (!fade_info.force_black) {
-                pal_colors[i].r = p.pal[3 * i] * 4;
-                pal_colors[i].g = p.pal[3 * i + 1] * 4;
-                pal_colors[i].b = p.pal[3 * i + 2] * 4;
+                const Color c = p.get(i);
+
+                /* only the top 6 bits are significant, as in AutoPal */
+                pal_colors[i].r = (c.r >> 2) * 4;
+                pal_colors[i].g = (c.g >> 2) * 4;
+                pal_colors[i].b = (c.b >> 2) * 4;
             } else {
                 pal_colors[i].r = 0;
                 pal_colors[i].g = 0;
@@ -627,6 +659,8 @@ transform_palette(void)
     assert(steps != 0 && step <= steps);
 
     for (i = fade_info.from; i < fade_info.to; ++i) {
+        const Color c = p.get(i);
+
         /*
          * This should be done this way, but unfortunately some image files
          * have palettes for which pal * 4 overflows single byte. They display
@@ -636,51 +670,140 @@ transform_palette(void)
         pal_colors[i].b = pal[3 * i + 2] * 4 * step / steps;
          */
 
-        pal_colors[i].r = p.pal[3 * i] * 4;
+        pal_colors[i].r = (c.r >> 2) * 4;
         pal_colors[i].r = pal_colors[i].r * step / steps;
-        pal_colors[i].g = p.pal[3 * i + 1] * 4;
+        pal_colors[i].g = (c.g >> 2) * 4;
         pal_colors[i].g = pal_colors[i].g * step / steps;
-        pal_colors[i].b = p.pal[3 * i + 2] * 4;
+        pal_colors[i].b = (c.b >> 2) * 4;
         pal_colors[i].b = pal_colors[i].b * step / steps;
     }
+
+    for (i = 0; i < 256; ++i) {
+        display_colors[i] = SDL_MapRGB(format,
+                                       pal_colors[i].r, pal_colors[i].g, pal_colors[i].b);
+    }
+
+    return 1;
+}
+
+/** Mark the screen area under an overlay dirty if the overlay moved or
+ * went away, so the picture underneath gets repainted.
+ */
+static void
+track_overlay(SDL_Rect *shown, const SDL_Rect &current)
+{
+    if (shown->w && shown->h
+        && (shown->x != current.x || shown->y != current.y
+            || shown->w != current.w || shown->h != current.h)) {
+        display::graphics.screen()->markDirty(shown->x, shown->y, shown->w, shown->h);
+    }
+
+    *shown = current;
+}
+
+/** Number of display pixels pushed to the screen by the last av_sync().
+ */
+unsigned
+av_sync_pixels(void)
+{
+    return sync_stats.last_pixels;
 }
 
+/**
+ * Present the screen.
+ *
+ * Only the part of the legacy screen modified since the previous call is
+ * scaled, converted and pushed to the display, unless the palette changed
+ * (e.g. while fading), in which case every pixel has a new color.
+ *
+ * Palette indices are turned into display pixels through display_colors
+ * while scaling, so there is no intermediate 8bpp surface or SDL blit.
+ */
 void
 av_sync(void)
 {
     SDL_Rect r;
+    display::Surface *screen = display::graphics.screen();
+    SDL_Surface *out = display::graphics.displaySurface();
+    const int scale = display::graphics.scale();
 
 #ifdef PROFILE_GRAPHICS
-    float tot_area = 0;
-    int i = 0;
     Uint32 ticks = SDL_GetTicks();
 #endif
 
-    SDL_Scale2x(display::graphics.screen()->surface(), display::graphics.scaledScreenSurface());
+    if (options.headless) {
+        return;
+    }
+
     /* copy palette and handle fading! */
-    transform_palette();
-    SDL_SetColors(display::graphics.scaledScreenSurface(), pal_colors, 0, 256);
-    SDL_BlitSurface(display::graphics.scaledScreenSurface(), NULL, display::graphics.displaySurface(), NULL);
+    if (transform_palette()) {
+        /* every pixel on screen may have a new color */
+        screen->markDirty();
+    }
+
+    track_overlay(&shown_video_rect, display::graphics.videoRect());
+    track_overlay(&shown_news_rect, display::graphics.newsRect());
+
+    sync_stats.last_pixels = 0;
+
+    if (screen->isDirty()) {
+        const SDL_Rect &dirty = screen->dirtyRect();
+        SDL_Surface *src = screen->surface();
+
+        assert(!SDL_MUSTLOCK(src));
+
+        if (SDL_MUSTLOCK(out)) {
+            SDL_LockSurface(out);
+        }
+
+        /* scale and convert straight into the display surface */
+        display::graphics.scaler().scaleConvert(
+            (const uint8_t *) src->pixels, src->pitch,
+            (uint8_t *) out->pixels, out->pitch, out->format->BytesPerPixel,
+            display_colors, dirty.x, dirty.y, dirty.w, dirty.h);
+
+        if (SDL_MUSTLOCK(out)) {
+            SDL_UnlockSurface(out);
+        }
+
+        SDL_UpdateRect(out, scale * dirty.x, scale * dirty.y,
+                       scale * dirty.w, scale * dirty.h);
+
+        sync_stats.last_pixels = scale * scale * dirty.w * dirty.h;
+        screen->clearDirty();
+    }
+
+    sync_stats.frames++;
+    sync_stats.pixels += sync_stats.last_pixels;
 
     if (display::graphics.videoRect().h && display::graphics.videoRect().w) {
-        r.h = 2 * display::graphics.videoRect().h;
-        r.w = 2 * display::graphics.videoRect().w;
-        r.x = 2 * display::graphics.videoRect().x;
-        r.y = 2 * display::graphics.videoRect().y;
+        r.h = scale * display::graphics.videoRect().h;
+        r.w = scale * display::graphics.videoRect().w;
+        r.x = scale * display::graphics.videoRect().x;
+        r.y = scale * display::graphics.videoRect().y;
         SDL_DisplayYUVOverlay(display::graphics.videoOverlay(), &r);
     }
 
     if (display::graphics.newsRect().h && display::graphics.newsRect().w) {
-        r.h = 2 * display::graphics.newsRect().h;
-        r.w = 2 * display::graphics.newsRect().w;
-        r.x = 2 * display::graphics.newsRect().x;
-        r.y = 2 * display::graphics.newsRect().y;
+        r.h = scale * display::graphics.newsRect().h;
+        r.w = scale * display::graphics.newsRect().w;
+        r.x = scale * display::graphics.newsRect().x;
+        r.y = scale * display::graphics.newsRect().y;
         SDL_DisplayYUVOverlay(display::graphics.newsOverlay(), &r);
     }
 
-    //TODO: Since we're not always tracking the right dirty area (due to the graphics refactoring)
-    // for now we update the entire display every time.
-    SDL_UpdateRect(display::graphics.displaySurface(), 0, 0, 640, 400);
+    TRACE3("sync pushed %u pixels (%u%% of display)",
+           sync_stats.last_pixels, sync_stats.last_pixels * 100 / (out->w * out->h));
+
+#ifdef PROFILE_GRAPHICS
+
+    if (sync_stats.frames % 100 == 0) {
+        INFO4("%u frames, %.0f pixels/frame average, last sync took %u ms",
+              sync_stats.frames, (double) sync_stats.pixels / sync_stats.frames,
+              SDL_GetTicks() - ticks);
+    }
+
+#endif
 }
 
 void
@@ -694,7 +817,36 @@ MuteChannel(int channel, int mute)
         }
     } else {
         assert(channel >= 0 && channel < AV_NUM_CHANNELS);
+        SDL_LockAudio();
         Channels[channel].mute = mute;
+        mixer_set_gain(&Channels[channel].voice, channel_gain(&Channels[channel]));
+        SDL_UnlockAudio();
+    }
+}
+
+/**
+ * Change the volume of a channel. The mixer ramps to the new volume
+ * instead of jumping, so this doesn't click.
+ *
+ * \param channel channel number or #AV_ALL_CHANNELS
+ * \param volume between 0 and #AV_MAX_VOLUME
+ */
+void
+av_set_volume(int channel, int volume)
+{
+    int i;
+
+    if (channel == AV_ALL_CHANNELS) {
+        for (i = 0; i < AV_NUM_CHANNELS; ++i) {
+            av_set_volume(i, volume);
+        }
+    } else {
+        assert(channel >= 0 && channel < AV_NUM_CHANNELS);
+        assert(volume >= 0 && volume <= AV_MAX_VOLUME);
+        SDL_LockAudio();
+        Channels[channel].volume = volume;
+        mixer_set_gain(&Channels[channel].voice, channel_gain(&Channels[channel]));
+        SDL_UnlockAudio();
     }
 }
 
@@ -3,6 +3,10 @@
 
 #include <SDL/SDL.h>
 
+#include "mixer.h"
+
+struct audio_stream;
+
 struct audio_chunk {
     struct audio_chunk *next;
     void *data;
@@ -12,23 +16,29 @@ struct audio_chunk {
 
 struct audio_channel {
     unsigned                volume;
+    struct mixer_voice      voice;           // gain derived from volume and mute
     unsigned                mute;
     struct audio_chunk     *chunk;           // played chunk
     struct audio_chunk    **chunk_tailp;     // tail of chunk list?
     unsigned                offset;          // data offset in chunk
+    struct audio_stream    *stream;          // played instead of chunks
 };
 
 
 int IsChannelMute(int channel);
+int av_have_audio(void);
 void NUpdateVoice(void);
 void av_step(void);
 void av_silence(int channel);
+void av_play_stream(struct audio_stream *stream, int channel);
 void MuteChannel(int channel, int mute);
+void av_set_volume(int channel, int volume);
 char AnimSoundCheck(void);
 void av_block(void);
 void UpdateAudio(void);
 void av_set_fading(int type, int from, int to, int steps, int preserve);
 void av_sync(void);
+unsigned av_sync_pixels(void);
 void av_setup(void);
 void play(struct audio_chunk *cp, int channel);
 
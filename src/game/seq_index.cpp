@@ -0,0 +1,220 @@
+// This file keeps the mission video sequence tables in memory.
+
+#include "seq_index.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Buzz_inc.h"
+#include "pace.h"
+
+LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
+
+/* FSEQ.DAT starts with this many tables */
+#define FSEQ_TABLES 50
+
+static struct {
+    int loaded;                     /* 0 not yet, 1 ok, -1 failed */
+    std::vector<struct oGROUP> groups;
+    std::vector<std::vector<struct oFGROUP> > fgroups;
+} seq;
+
+static int
+load_groups(void)
+{
+    FILE *fin = sOpen("SEQ.DAT", "rb", 0);
+    struct oGROUP group;
+
+    if (!fin) {
+        return -1;
+    }
+
+    while (fread_oGROUP(&group, 1, fin)) {
+        seq.groups.push_back(group);
+    }
+
+    fclose(fin);
+    return 0;
+}
+
+static int
+load_fgroups(void)
+{
+    FILE *fin = sOpen("FSEQ.DAT", "rb", 0);
+    struct Table tables[FSEQ_TABLES];
+
+    if (!fin) {
+        return -1;
+    }
+
+    if (fread_Table(tables, FSEQ_TABLES, fin) != FSEQ_TABLES) {
+        fclose(fin);
+        return -1;
+    }
+
+    seq.fgroups.resize(FSEQ_TABLES);
+
+    for (int i = 0; i < FSEQ_TABLES; i++) {
+        std::vector<struct oFGROUP> &table = seq.fgroups[i];
+
+        table.resize(tables[i].size / sizeof_oFGROUP);
+
+        if (table.empty() || fseek(fin, tables[i].foffset, SEEK_SET) != 0) {
+            table.clear();
+            continue;
+        }
+
+        table.resize(fread_oFGROUP(&table[0], table.size(), fin));
+    }
+
+    fclose(fin);
+    return 0;
+}
+
+/**
+ * Read both files, unless that has been done already.
+ *
+ * \return 0 on success, -1 if either file can't be read
+ */
+int
+seq_index_load(void)
+{
+    if (seq.loaded) {
+        return (seq.loaded < 0) ? -1 : 0;
+    }
+
+    if (load_groups() < 0 || load_fgroups() < 0) {
+        WARNING1("can't read the video sequence tables");
+        seq.groups.clear();
+        seq.fgroups.clear();
+        seq.loaded = -1;
+        return -1;
+    }
+
+    DEBUG3("%u success and %u failure sequence tables",
+           (unsigned) seq.groups.size(), (unsigned) seq.fgroups.size());
+    seq.loaded = 1;
+    return 0;
+}
+
+/** The SEQ.DAT record at an index, or NULL. */
+const struct oGROUP *
+seq_group(int index)
+{
+    if (seq_index_load() < 0 || index < 0 ||
+        index >= (int) seq.groups.size()) {
+        return NULL;
+    }
+
+    return &seq.groups[index];
+}
+
+/**
+ * Find the SEQ.DAT record of a sequence type, matched against the
+ * ID from its fourth character on.
+ *
+ * \return its index, or -1 if the "XXXX" end marker comes first
+ */
+int
+seq_find_group(const char *type)
+{
+    assert(type);
+
+    if (seq_index_load() < 0) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < seq.groups.size(); i++) {
+        if (strncmp(seq.groups[i].ID, "XXXX", 4) == 0) {
+            return -1;
+        }
+
+        if (strcmp(&seq.groups[i].ID[3], type) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** An FSEQ.DAT record, or NULL. */
+const struct oFGROUP *
+seq_fgroup(int table, int entry)
+{
+    if (seq_index_load() < 0 || table < 0 || table >= FSEQ_TABLES ||
+        entry < 0 || entry >= (int) seq.fgroups[table].size()) {
+        return NULL;
+    }
+
+    return &seq.fgroups[table][entry];
+}
+
+/**
+ * List the video files of every segment of a replay, in order.
+ *
+ * The list stops before the first segment or clip that can't be
+ * resolved, which is where playing it used to stop.
+ *
+ * \return number of files listed, or -1 if the tables can't be read
+ */
+int
+seq_replay_clips(const REPLAY *rep, std::vector<std::string> &clips)
+{
+    assert(rep);
+
+    clips.clear();
+
+    if (seq_index_load() < 0) {
+        return -1;
+    }
+
+    for (int kk = 0; kk < rep->Qty; kk++) {
+        const struct oLIST *list;
+        int mode, max;
+
+        if (rep->Off[kk] < 1000) {  //Specs: success seq
+            const struct oGROUP *group = seq_group(rep->Off[kk]);
+
+            if (!group) {
+                break;
+            }
+
+            list = group->oLIST;
+            max = group->ID[1] - '0';
+            mode = 0;
+        } else {
+            //Specs: failure seq
+            int table = rep->Off[kk] / 1000;
+
+            if (table == 50) {
+                break;
+            }
+
+            //Specs: offset index kludge
+            const struct oFGROUP *fgroup =
+                seq_fgroup(table - 1, rep->Off[kk] % 1000);
+
+            if (!fgroup) {
+                break;
+            }
+
+            list = fgroup->oLIST;
+            max = fgroup->ID[1] - '0';
+            mode = 1;
+        }
+
+        for (int i = 0; i < max && i < 5; i++) {
+            char *name = seq_filename(list[i].aIdx, mode);
+
+            if (!name) {
+                return clips.size();
+            }
+
+            /** \todo assumption on file extension */
+            clips.push_back(std::string(name) + ".ogg");
+        }
+    }
+
+    return clips.size();
+}
@@ -0,0 +1,25 @@
+#ifndef SEQ_INDEX_H
+#define SEQ_INDEX_H
+
+#include <string>
+#include <vector>
+
+#include "data.h"
+#include "gamedata.h"
+
+/**
+ * \file seq_index.h SEQ.DAT and FSEQ.DAT, read once and kept in memory.
+ *
+ * SEQ.DAT lists the video clips of each successful mission step and
+ * FSEQ.DAT those of each failure, in 50 tables.  A replay segment offset
+ * below 1000 is an index into SEQ.DAT; from 1000 up, offset / 1000 - 1 is
+ * the FSEQ.DAT table and offset % 1000 the entry within it.
+ */
+
+int seq_index_load(void);
+const struct oGROUP *seq_group(int index);
+int seq_find_group(const char *type);
+const struct oFGROUP *seq_fgroup(int table, int entry);
+int seq_replay_clips(const REPLAY *rep, std::vector<std::string> &clips);
+
+#endif /* SEQ_INDEX_H */
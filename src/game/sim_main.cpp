@@ -0,0 +1,316 @@
+// This file plays whole campaigns between two computer players, with no
+// display, audio or delays, for balancing the AI and catching regressions.
+//
+// usage: raceintospace-sim [-g games] [-j threads] [-l level] [-s seed] [-v]
+//                          [NAME=value...]
+//
+// Every game is started with game_context_reset(), so it starts from the
+// initial value of every GAME_LOCAL variable rather than from what an
+// earlier game on the same thread left in them.  Game n is played from
+// seed + n, so a run can be played again game for game, whatever the
+// number of threads.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <SDL/SDL.h>
+
+#include "Buzz_inc.h"
+#include "endianness.h"
+#include "fail_table.h"
+#include "filesystem.h"
+#include "game_context.h"
+#include "game_main.h"
+#include "image_cache.h"
+#include "options.h"
+#include "pace.h"
+#include "prefetch.h"
+#include "prefs.h"
+#include "records.h"
+#include "rng.h"
+#include "sdlhelper.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
+
+static const char *const side_name[NUM_PLAYERS] = {"USA", "USSR"};
+
+/* how a campaign ended */
+struct sim_result {
+    int winner;         /* side that landed on the Moon first, or -1 */
+    char season;
+    char year;
+    int prestige[NUM_PLAYERS];
+    int missions[NUM_PLAYERS];
+};
+
+/* the campaigns shared out between the threads */
+struct sim_pool {
+    const struct Players *start;   /* the game every campaign starts from */
+    unsigned seed;
+    struct sim_result *results;
+    int games;
+    int next;           /* next game to hand out */
+    SDL_mutex *lock;
+};
+
+static void
+usage(void)
+{
+    fprintf(stderr, "usage:   raceintospace-sim [options...] [NAME=value...]\n"
+            "options: -g -j -l -s -v\n"
+            "\t-g games\n\t\tnumber of campaigns to play (default 1)\n"
+            "\t-j threads\n\t\tnumber of campaigns to play at once (default 1)\n"
+            "\t-l level\n\t\tcomputer difficulty, 0 to 2 (default 2)\n"
+            "\t-s seed\n\t\tseed of the first game (default from the clock)\n"
+            "\t-v verbose mode\n\t\tadd this several times to get to DEBUG level\n"
+           );
+    exit(EXIT_FAILURE);
+}
+
+/* set up a new game like the preferences screen would, with both sides
+ * played by the computer */
+static void
+sim_new_game(int level)
+{
+    FILE *fin;
+
+    fin = sOpen("URAST.DAT", "rb", 0);
+    fread(Data, 1, (sizeof(struct Players)), fin);
+    fclose(fin);
+    SwapGameDat();
+
+    if (Data->Checksum != (sizeof(struct Players))) {
+        CRITICAL1("wrong version of data file");
+        exit(EXIT_FAILURE);
+    }
+
+    Data->Def.Plr1 = 2;
+    Data->Def.Plr2 = 3;
+    Data->Def.Lev1 = Data->Def.Lev2 = level;
+    Data->Def.Ast1 = Data->Def.Ast2 = 0;
+    Data->Def.Input = 2;  // Historical Model / Historical Roster
+    SetupGameModel(0);
+
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        Data->plr[i] = i + 2;
+    }
+}
+
+/* prestige earned by the missions a side has flown */
+static int
+sim_prestige(char p)
+{
+    int total = 0;
+
+    for (int i = 0; i < Data->P[p].PastMissionCount; i++) {
+        total += Data->P[p].History[i].Prestige;
+    }
+
+    return total;
+}
+
+/* play one campaign from the start game in the game of this thread */
+static void
+sim_play(const struct Players *start, unsigned seed,
+         struct sim_result *result)
+{
+    memcpy(Data, start, sizeof(struct Players));
+    rng_seed(&game_rng, seed);
+
+    LOAD = QUIT = 0;
+    MAIL = -1;
+    Option = -1;
+    xMODE = xMODE_NOCOPRO;
+
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        plr[i] = Data->plr[i];
+        AI[i] = 1;
+    }
+
+    InitData();
+    MainLoop();
+
+    result->winner = Data->Prestige[Prestige_MannedLunarLanding].Place;
+    result->season = Data->Season;
+    result->year = Data->Year;
+
+    for (int i = 0; i < NUM_PLAYERS; i++) {
+        result->prestige[i] = sim_prestige(i);
+        result->missions[i] = Data->P[i].PastMissionCount;
+    }
+}
+
+/* play campaigns from the pool, each in a new game, until none is left */
+static int
+sim_thread(void *arg)
+{
+    struct sim_pool *pool = (struct sim_pool *)arg;
+    struct GameContext ctx;
+
+    game_context_init(&ctx);
+
+    for (;;) {
+        int n;
+
+        SDL_mutexP(pool->lock);
+        n = pool->next++;
+        SDL_mutexV(pool->lock);
+
+        if (n >= pool->games) {
+            break;
+        }
+
+        game_context_reset(&ctx);
+        sim_play(pool->start, pool->seed + n, &pool->results[n]);
+    }
+
+    game_context_free(&ctx);
+    return 0;
+}
+
+static void
+sim_report(int game, const struct sim_result *r)
+{
+    printf("game %d: %s in %s 19%d, prestige %d/%d, missions %d/%d\n",
+           game,
+           (r->winner == 0 || r->winner == 1) ? side_name[r->winner] : "nobody",
+           r->season ? "fall" : "spring", r->year,
+           r->prestige[0], r->prestige[1],
+           r->missions[0], r->missions[1]);
+}
+
+/* wins and averages over all the campaigns */
+static void
+sim_summary(int games, const struct sim_result *results)
+{
+    int wins[NUM_PLAYERS + 1] = {0};
+    double year = 0, prestige[NUM_PLAYERS] = {0}, missions[NUM_PLAYERS] = {0};
+
+    for (int g = 0; g < games; g++) {
+        const struct sim_result *r = &results[g];
+
+        wins[(r->winner == 0 || r->winner == 1) ? r->winner : NUM_PLAYERS]++;
+        year += r->year + (r->season ? 0.5 : 0.0);
+
+        for (int i = 0; i < NUM_PLAYERS; i++) {
+            prestige[i] += r->prestige[i];
+            missions[i] += r->missions[i];
+        }
+    }
+
+    printf("wins %s %d, %s %d, nobody %d; mean end 19%.1f, "
+           "prestige %.1f/%.1f, missions %.1f/%.1f\n",
+           side_name[0], wins[0], side_name[1], wins[1], wins[NUM_PLAYERS],
+           year / games, prestige[0] / games, prestige[1] / games,
+           missions[0] / games, missions[1] / games);
+}
+
+int
+main(int argc, char *argv[])
+{
+    std::vector<char *> args;
+    std::vector<SDL_Thread *> threads;
+    struct GameContext setup;
+    struct sim_pool pool;
+    int games = 1;
+    int jobs = 1;
+    int level = 2;
+    double start, secs;
+
+    args.push_back(argv[0]);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            level = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0) {
+            usage();
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (games < 1 || jobs < 1 || level < 0 || level > 2) {
+        usage();
+    }
+
+    Filesystem::init(argv[0]);
+    setup_options(args.size(), &args[0]);
+    options.headless = 1;
+    options.want_audio = 0;
+    Filesystem::addPath(options.dir_gamedata);
+    Filesystem::addPath(options.dir_savegame);
+    log_setThreshold(&_LOGV(LOG_ROOT_CAT), MAX(0, LP_NOTICE - (int)options.want_debug));
+    ImageCache::init(options.image_cache_kb * 1024, prefetch_load_image);
+
+    if (create_save_dir() != 0) {
+        CRITICAL3("can't create save directory `%s': %s",
+                  options.dir_savegame, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    LoadFailTable();
+    av_setup();
+
+    /* the main thread only sets up the game every campaign starts from */
+    game_context_init(&setup);
+    game_context_bind(&setup);
+
+    OpenEmUp();
+    MakeRecords();
+    sim_new_game(level);
+
+    pool.start = Data;
+    pool.seed = options.seed_set ? options.seed : (unsigned)(get_time() * 1000);
+    pool.results = (struct sim_result *)xcalloc(games, sizeof(struct sim_result));
+    pool.games = games;
+    pool.next = 0;
+    pool.lock = SDL_CreateMutex();
+
+    start = get_time();
+
+    for (int i = 0; i < MIN(jobs, games); i++) {
+        SDL_Thread *thread = SDL_CreateThread(sim_thread, &pool);
+
+        if (!thread) {
+            ERROR2("can't start simulation thread: %s", SDL_GetError());
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    /* play on this thread if none could be started */
+    if (threads.empty()) {
+        sim_thread(&pool);
+    }
+
+    for (size_t i = 0; i < threads.size(); i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    secs = get_time() - start;
+
+    for (int game = 0; game < games; game++) {
+        sim_report(game + 1, &pool.results[game]);
+    }
+
+    sim_summary(games, pool.results);
+    printf("seed %u\n", pool.seed);
+    printf("%d games in %.2f s, %.2f games/s\n", games, secs,
+           (secs > 0) ? games / secs : 0.0);
+
+    SDL_DestroyMutex(pool.lock);
+    free(pool.results);
+    game_context_free(&setup);
+
+    return EXIT_SUCCESS;
+}
@@ -41,6 +41,7 @@
 #include "admin.h"
 #include "game_main.h"
 #include "mis_c.h"
+#include "mission_odds.h"
 #include "mission_util.h"
 #include "news_suq.h"
 #include "place.h"
@@ -55,6 +56,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#define ODDS_ROLLOUTS 20000  // flights behind the odds shown
+
 /* VAS holds all possible payload configurations for the given mission.
  * Each payload consists of four components:
  *   0: Primary (a capsule)
@@ -65,11 +68,14 @@
  * potential payload combinations available at assembly time, each of
  * which is stored in VAS.
  */
-struct VInfo VAS[7][4];
-int VASqty;  // How many payload configurations there are
+GAME_LOCAL struct VInfo VAS[7][4];
+GAME_LOCAL int VASqty;  // How many payload configurations there are
+GAME_LOCAL_RESET(VAS);
+GAME_LOCAL_RESET(VASqty);
 
 // CAP,LM,SDM,DMO,EVA,PRO,INT,KIC
-char isDamaged[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+GAME_LOCAL char isDamaged[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+GAME_LOCAL_RESET(isDamaged);
 
 /* MI contains the location of a vehicle equipment image and its
  * positioning when drawn inside a vehicle casing.
@@ -172,6 +178,8 @@ void ShowRkt(char *Name, int sf, int qty, char mode, char isDmg);
 void DispVA(char plr, char f, const display::LegacySurface *hw);
 void DispRck(char plr, char wh, const display::LegacySurface *hw);
 void DispWts(int two, int one);
+void ShowOdds(char plr, char mis, char f, int rk, bool fits);
+bool RocketAllowed(char mcode, int rk);
 void LMAdd(char plr, char prog, char kic, char part);
 void VVals(char plr, char tx, Equipment *EQ, char v4, char v5);
 
@@ -984,6 +992,61 @@ void DispWts(int two, int one)
 }
 
 
+/* Prints the odds of the mission on the hardware selected, under the
+ * MISSION HARDWARE banner. Until that hardware can fly, the banner
+ * asks for it instead.
+ *
+ * \param plr   The player assembling the launch vehicle.
+ * \param mis   The pad the mission is on.
+ * \param f     The payload selected, an index into VAS.
+ * \param rk    The rocket selected, boosted if above 3.
+ * \param fits  The rocket can lift the payload.
+ */
+void ShowOdds(char plr, char mis, char f, int rk, bool fits)
+{
+    struct MissionType plan[2];
+    int part = Data->P[plr].Mission[mis].part;
+    int first = mis - part;
+    bool joint = Data->P[plr].Mission[first].Joint;
+
+    memcpy(plan, &Data->P[plr].Mission[first], (1 + joint) * sizeof(plan[0]));
+
+    for (int i = Mission_Capsule; i <= Mission_Probe_DM; i++) {
+        plan[part].Hard[i] = VAS[f][i].dex;
+    }
+
+    plan[part].Hard[Mission_PrimaryBooster] = rk + 1;
+
+    fill_rectangle(5, 113, 165, 122, 7 + plr * 3);
+    display::graphics.setForegroundColor(11);
+
+    // The other half of a joint mission has to be assembled first
+    if (f == 0 || !fits ||
+        (joint && plan[1 - part].Hard[Mission_PrimaryBooster] <= 0) ||
+        !DrawOdds(plr, plan, 10, 119)) {
+        draw_string(10, 119, "SELECT PAYLOADS AND BOOSTER");
+    }
+}
+
+
+/* Whether the VAB lets a rocket be picked for a mission: lunar ones
+ * leave out the smallest rocket, boosted or not, unless the cheat
+ * allows it.
+ *
+ * \param mcode  The mission code.
+ * \param rk     The rocket, boosted if above 3.
+ */
+bool RocketAllowed(char mcode, int rk)
+{
+    if (((mcode >= 42 && mcode <= 57) || (mcode >= 7 && mcode <= 13)) &&
+        (rk == 4 || rk == 0)) {
+        return options.cheat_altasOnMoon != 0;
+    }
+
+    return true;
+}
+
+
 void VAB(char plr)
 {
     int ccc, rk;                // Payload index & rocket index
@@ -1072,6 +1135,7 @@ void VAB(char plr)
         DispWts(weight, pay[rk]);
         //display cost (XX of XX)
         ShowAutopurchase(plr, ccc, rk, &qty[0]);
+        ShowOdds(plr, mis, ccc, rk, weight <= pay[rk]);
 
         FadeIn(2, 10, 0, 0);
         WaitForMouseUp();
@@ -1324,12 +1388,8 @@ void VAB(char plr)
                     rk = 0;
                 }
 
-                if (((Misdef(mis) >= 42 && Misdef(mis) <= 57) ||
-                     (Misdef(mis) >= 7 && Misdef(mis) <= 13)) &&
-                    (rk == 4 || rk == 0)) {
-                    if (options.cheat_altasOnMoon == 0) {
-                        rk++;
-                    }
+                if (!RocketAllowed(Misdef(mis), rk)) {
+                    rk++;
                 }
 
                 //display cost (XX of XX)
@@ -1338,6 +1398,7 @@ void VAB(char plr)
                         isDamaged[rk]);
                 DispWts(weight, pay[rk]);
                 DispRck(plr, rk, hw.get());
+                ShowOdds(plr, mis, ccc, rk, weight <= pay[rk]);
                 WaitForMouseUp();
 
                 if (key > 0) {
@@ -1367,6 +1428,7 @@ void VAB(char plr)
                 DispVA(plr, ccc, hw.get());
                 //display cost (XX of XX)
                 ShowAutopurchase(plr, ccc, rk, &qty[0]);
+                ShowOdds(plr, mis, ccc, rk, weight <= pay[rk]);
                 WaitForMouseUp();
 
                 if (key > 0) {
@@ -1628,4 +1690,155 @@ void VVals(char plr, char tx, Equipment *EQ, char v4, char v5)
     return;
 }
 
+
+/* Assembles a part of a planned mission the way the VAB first offers
+ * to: the first payload whose programs have all been started, on the
+ * smallest started rocket the VAB allows that can lift it. Nothing is
+ * bought or set aside, and VAS and Mis are left as they were.
+ *
+ * \param plr   The player planning the mission.
+ * \param plan  The mission, followed by its second part if joint.
+ * \param part  0 or 1, the part whose Hard is filled in.
+ * \return  false if no hardware at hand can fly that part.
+ */
+bool DefaultHardware(char plr, struct MissionType *plan, char part)
+{
+    struct MissionType *m = &plan[part];
+    struct VInfo keepVAS[7][4];
+    int keepQty = VASqty;
+    struct mStr keepMis = Mis;
+    char prog = m->Prog - 1;
+    int f, i, rk = 7, weight = 0;
+
+    memcpy(keepVAS, VAS, sizeof(VAS));
+
+    // An uncrewed first part carries hardware for the crewed second
+    if (part == 0 && m->Joint && m->Men == 0) {
+        prog = plan[1].Prog - 1;
+    }
+
+    BuildVAB(plr, m->MissionCode, 1, part, prog);
+
+    for (f = 1; f <= MAX(VASqty, 1); f++) {
+        for (i = 0; i < 4; i++) {
+            if (VAS[f][i].dex >= 0 && VAS[f][i].qty == PROGRAM_NOT_STARTED) {
+                break;
+            }
+        }
+
+        if (i == 4) {
+            break;
+        }
+    }
+
+    if (f <= MAX(VASqty, 1)) {
+        for (i = 0; i < 4; i++) {
+            weight += VAS[f][i].wt;
+        }
+
+        for (rk = 0; rk < 7; rk++) {
+            const Equipment &rocket = Data->P[plr].Rocket[rk % 4];
+            const Equipment &boosters = Data->P[plr].Rocket[ROCKET_HW_BOOSTERS];
+            int pay = rocket.MaxPay + (rk > 3 ? boosters.MaxPay : 0);
+
+            if (RocketAllowed(m->MissionCode, rk) &&
+                rocket.Num != PROGRAM_NOT_STARTED && pay >= weight &&
+                (rk <= 3 || boosters.Num != PROGRAM_NOT_STARTED)) {
+                break;
+            }
+        }
+    }
+
+    if (rk < 7) {
+        for (i = Mission_Capsule; i <= Mission_Probe_DM; i++) {
+            m->Hard[i] = VAS[f][i].dex;
+        }
+
+        m->Hard[Mission_PrimaryBooster] = rk + 1;
+    }
+
+    memcpy(VAS, keepVAS, sizeof(VAS));
+    VASqty = keepQty;
+    Mis = keepMis;
+
+    return rk < 7;
+}
+
+
+/* Prints the odds of a planned mission: its chance of success and,
+ * if crewed, of losing crew. They are worked out once for a plan, and
+ * remembered by mission_odds() until the game changes. If no rollout
+ * could be flown, they are printed as unknown.
+ *
+ * \param plr   The player planning the mission.
+ * \param plan  The mission, followed by its second part if joint,
+ *              with its hardware assigned.
+ * \param x     Where to print.
+ * \param y
+ * \return  false, with nothing printed, if the mission can't fly.
+ */
+bool DrawOdds(char plr, const struct MissionType *plan, int x, int y)
+{
+    struct mission_odds odds;
+    bool crewed = plan[0].Men > 0 || (plan[0].Joint && plan[1].Men > 0);
+
+    if (mission_odds(plr, plan, ODDS_ROLLOUTS, &odds) != 0) {
+        return false;
+    }
+
+    if (odds.rollouts == 0) {
+        draw_string(x, y, "ODDS UNKNOWN");
+        return true;
+    }
+
+    draw_string(x, y, "SUCCESS ");
+    draw_number(0, 0, (int)(100 * odds.p[ODDS_SUCCESS] + 0.5));
+    draw_string(0, 0, "%");
+
+    if (crewed) {
+        draw_string(0, 0, "  CREW LOST ");
+        draw_number(0, 0, (int)(100 * (odds.p[ODDS_DEATH] +
+                                       odds.p[ODDS_ALL_DEAD]) + 0.5));
+        draw_string(0, 0, "%");
+    }
+
+    return true;
+}
+
+
+/* Prints the odds of the mission on a pad for the Launch Pad menu.
+ *
+ * A mission of this season needs its hardware assembled first. A
+ * future one is given the hardware the VAB would first offer it,
+ * although hardware may change before it flies.
+ *
+ * \param plr     The player planning the mission.
+ * \param pad     The pad of the first part of the mission.
+ * \param future  Whether it's the mission planned for next season.
+ * \param x       Where to print.
+ * \param y
+ */
+void DrawPadOdds(char plr, char pad, bool future, int x, int y)
+{
+    struct MissionType plan[2];
+    const struct MissionType *pads =
+        future ? Data->P[plr].Future : Data->P[plr].Mission;
+    int parts = 1 + pads[pad].Joint;
+
+    if (pads[pad].MissionCode == Mission_None || pads[pad].part != 0) {
+        return;
+    }
+
+    memcpy(plan, &pads[pad], parts * sizeof(plan[0]));
+
+    for (int i = 0; i < parts; i++) {
+        if (future ? !DefaultHardware(plr, plan, i)
+            : plan[i].Hard[Mission_PrimaryBooster] <= 0) {
+            return;
+        }
+    }
+
+    DrawOdds(plr, plan, x, y);
+}
+
 /* vim: set noet ts=4 sw=4 tw=77: */
@@ -1,10 +1,15 @@
 #ifndef VAB_H
 #define VAB_H
 
+#include "game_context.h"
+
 void VAB(char plr);
 void BuildVAB(char plr, char mis, char ty, char pa, char pr);
+bool DefaultHardware(char plr, struct MissionType *plan, char part);
+bool DrawOdds(char plr, const struct MissionType *plan, int x, int y);
+void DrawPadOdds(char plr, char pad, bool future, int x, int y);
 
-extern struct VInfo VAS[7][4];
-extern int VASqty;
+extern GAME_LOCAL struct VInfo VAS[7][4];
+extern GAME_LOCAL int VASqty;
 
 #endif // VAB_H
@@ -0,0 +1,377 @@
+// This file plays a list of video clips, opening each one ahead of time.
+
+#include "video_sequence.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "Buzz_inc.h"
+#include "mmfile.h"
+#include "utils.h"
+
+LOG_DEFAULT_CATEGORY(LOG_ROOT_CAT)
+
+/* frames decoded ahead of the one being shown, per clip */
+#define SEQUENCE_FRAMES 4
+
+enum clip_state {
+    CLIP_IDLE,
+    CLIP_OPENING,       /* the worker has it */
+    CLIP_READY,         /* open, with its first frame decoded */
+    CLIP_FAILED,
+    CLIP_CLOSED
+};
+
+struct video_clip {
+    char *path;         /* found by locate_file(), or NULL */
+    mm_file mf;
+    float fps;
+    mm_frame_ring ring;
+    int ended;          /* 1 at the end of the video, -1 on error */
+    double last;        /* presentation time of the last frame taken */
+    enum clip_state state;
+};
+
+/*
+ * The worker opens clips[wanted] if it is idle, and decodes frames of
+ * ready clips from current to wanted into their rings until they are
+ * full or the clip ends.  Clip states, ring positions, ended, current
+ * and wanted only change with the lock held.  The mm_file of a ready
+ * clip belongs to the worker until the clip has ended.
+ */
+struct video_sequence {
+    struct video_clip *clips;
+    int count;
+    int current;        /* clip being played */
+    int opened;         /* last clip seen ready by the main thread */
+    int wanted;         /* clip the worker should open next */
+    int quit;
+    int taken;          /* the front frame of the current clip was returned */
+    double waited;      /* seconds spent waiting for the worker */
+    double base;        /* presentation time at which the current clip starts */
+    const SDL_Overlay *ovl; /* layout of the decoded frames */
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *changed;
+};
+
+static enum clip_state
+clip_open(struct video_clip *clip, const SDL_Overlay *ovl)
+{
+    if (!clip->path || mm_open_mapped(&clip->mf, clip->path) < 0) {
+        return CLIP_FAILED;
+    }
+
+    /** \todo do not ignore width/height */
+    if (!clip->mf.video ||
+        mm_video_info(&clip->mf, NULL, NULL, &clip->fps) <= 0) {
+        mm_close(&clip->mf);
+        return CLIP_FAILED;
+    }
+
+    if (mm_ring_init(&clip->ring, SEQUENCE_FRAMES, ovl) < 0) {
+        mm_close(&clip->mf);
+        return CLIP_FAILED;
+    }
+
+    return CLIP_READY;
+}
+
+/* a ready clip from current to wanted with room for a frame, or NULL */
+static struct video_clip *
+sequence_fillable(struct video_sequence *seq)
+{
+    for (int i = seq->current; i <= seq->wanted && i < seq->count; i++) {
+        struct video_clip *clip = &seq->clips[i];
+
+        if (clip->state == CLIP_READY && !clip->ended &&
+            mm_ring_back(&clip->ring)) {
+            return clip;
+        }
+    }
+
+    return NULL;
+}
+
+static int
+sequence_thread(void *arg)
+{
+    struct video_sequence *seq = (struct video_sequence *)arg;
+
+    SDL_mutexP(seq->lock);
+
+    while (!seq->quit) {
+        struct video_clip *clip = sequence_fillable(seq);
+
+        /* the clip on screen comes first, then opening the next one */
+        if (clip == &seq->clips[seq->current] ||
+            (clip && (seq->wanted >= seq->count ||
+                      seq->clips[seq->wanted].state != CLIP_IDLE))) {
+            mm_frame *frame = mm_ring_back(&clip->ring);
+            int rv;
+
+            SDL_mutexV(seq->lock);
+            rv = mm_decode_video_to(&clip->mf, &clip->ring, frame);
+            SDL_mutexP(seq->lock);
+
+            if (rv > 0) {
+                mm_ring_push(&clip->ring);
+            } else {
+                clip->ended = (rv < 0) ? -1 : 1;
+            }
+
+            SDL_CondBroadcast(seq->changed);
+            continue;
+        }
+
+        if (seq->wanted < seq->count &&
+            seq->clips[seq->wanted].state == CLIP_IDLE) {
+            enum clip_state state;
+
+            clip = &seq->clips[seq->wanted];
+            clip->state = CLIP_OPENING;
+            SDL_mutexV(seq->lock);
+            state = clip_open(clip, seq->ovl);
+            SDL_mutexP(seq->lock);
+            clip->state = state;
+            SDL_CondBroadcast(seq->changed);
+            continue;
+        }
+
+        SDL_CondWait(seq->changed, seq->lock);
+    }
+
+    SDL_mutexV(seq->lock);
+    return 0;
+}
+
+/* have the worker open a clip, if it hasn't been asked to already */
+static void
+sequence_want(struct video_sequence *seq, int index)
+{
+    SDL_mutexP(seq->lock);
+
+    if (seq->wanted < index) {
+        seq->wanted = index;
+        SDL_CondBroadcast(seq->changed);
+    }
+
+    SDL_mutexV(seq->lock);
+}
+
+/* wait until the current clip is open, or failed to */
+static enum clip_state
+sequence_wait(struct video_sequence *seq)
+{
+    struct video_clip *clip = &seq->clips[seq->current];
+    double start = get_time();
+    enum clip_state state;
+
+    sequence_want(seq, seq->current);
+
+    SDL_mutexP(seq->lock);
+
+    while (clip->state == CLIP_IDLE || clip->state == CLIP_OPENING) {
+        SDL_CondWait(seq->changed, seq->lock);
+    }
+
+    state = clip->state;
+    SDL_mutexV(seq->lock);
+
+    seq->waited += get_time() - start;
+    return state;
+}
+
+/* wait for the next frame of the current clip, or NULL at its end */
+static mm_frame *
+sequence_frame(struct video_sequence *seq)
+{
+    struct video_clip *clip = &seq->clips[seq->current];
+    double start = get_time();
+    mm_frame *frame;
+
+    SDL_mutexP(seq->lock);
+
+    if (seq->taken) {
+        mm_ring_pop(&clip->ring);
+        seq->taken = 0;
+        SDL_CondBroadcast(seq->changed);
+    }
+
+    while ((frame = mm_ring_front(&clip->ring)) == NULL && !clip->ended) {
+        SDL_CondWait(seq->changed, seq->lock);
+    }
+
+    SDL_mutexV(seq->lock);
+
+    seq->waited += get_time() - start;
+    return frame;
+}
+
+/**
+ * Start opening the first clip of a list.
+ *
+ * \param names file names, looked up like any other #FT_VIDEO file
+ * \param ovl overlay the frames will be shown on; frames are decoded
+ * ahead in its layout
+ * \return the sequence, or NULL if the list is empty or the worker can't
+ * be started
+ */
+struct video_sequence *
+video_sequence_open(const std::vector<std::string> &names,
+                    const SDL_Overlay *ovl)
+{
+    struct video_sequence *seq;
+
+    if (names.empty()) {
+        return NULL;
+    }
+
+    seq = (struct video_sequence *)xcalloc(1, sizeof(*seq));
+    seq->count = names.size();
+    seq->opened = -1;
+    seq->ovl = ovl;
+    seq->clips = (struct video_clip *)xcalloc(seq->count,
+                 sizeof(struct video_clip));
+
+    /* look the files up once, before the worker starts */
+    for (int i = 0; i < seq->count; i++) {
+        seq->clips[i].path = locate_file(names[i].c_str(), FT_VIDEO);
+        seq->clips[i].state = CLIP_IDLE;
+
+        if (!seq->clips[i].path) {
+            WARNING2("can't find video file `%s'", names[i].c_str());
+        }
+    }
+
+    seq->lock = SDL_CreateMutex();
+    seq->changed = SDL_CreateCond();
+    seq->thread = SDL_CreateThread(sequence_thread, seq);
+
+    if (!seq->thread) {
+        ERROR2("can't start video sequence thread: %s", SDL_GetError());
+        seq->quit = 1;
+        video_sequence_close(seq);
+        return NULL;
+    }
+
+    return seq;
+}
+
+/** Stop the worker and close every clip. */
+void
+video_sequence_close(struct video_sequence *seq)
+{
+    if (!seq) {
+        return;
+    }
+
+    if (seq->thread) {
+        SDL_mutexP(seq->lock);
+        seq->quit = 1;
+        SDL_CondBroadcast(seq->changed);
+        SDL_mutexV(seq->lock);
+        SDL_WaitThread(seq->thread, NULL);
+    }
+
+    for (int i = 0; i < seq->count; i++) {
+        if (seq->clips[i].state == CLIP_READY) {
+            mm_close(&seq->clips[i].mf);
+            mm_ring_free(&seq->clips[i].ring);
+        }
+
+        free(seq->clips[i].path);
+    }
+
+    DEBUG3("video sequence of %d clips waited %.1f ms for clips to open",
+           seq->count, seq->waited * 1000);
+
+    SDL_DestroyCond(seq->changed);
+    SDL_DestroyMutex(seq->lock);
+    free(seq->clips);
+    free(seq);
+}
+
+/**
+ * Take the next frame of the sequence, moving on to the next clip at the
+ * end of one.  The frame is shown by video_sequence_show(), or dropped
+ * by the next call.
+ *
+ * \param pts set to the presentation time of the frame, counted from the
+ * start of the first clip
+ * \param fps set to the frame rate of the clip the frame came from
+ * \return 1 if there is a frame, 0 at the end of the last clip, or -1
+ * if a clip can't be played
+ */
+int
+video_sequence_next(struct video_sequence *seq, double *pts, float *fps)
+{
+    assert(seq);
+
+    while (seq->current < seq->count) {
+        struct video_clip *clip = &seq->clips[seq->current];
+        mm_frame *frame;
+
+        if (seq->opened != seq->current) {
+            if (sequence_wait(seq) != CLIP_READY) {
+                return -1;
+            }
+
+            seq->opened = seq->current;
+            clip->last = 0;
+        }
+
+        sequence_want(seq, seq->current + 1);
+
+        if ((frame = sequence_frame(seq)) != NULL) {
+            seq->taken = 1;
+            clip->last = MAX(frame->pts, 0);
+
+            if (pts) {
+                *pts = seq->base + clip->last;
+            }
+
+            if (fps) {
+                *fps = clip->fps;
+            }
+
+            return 1;
+        }
+
+        if (clip->ended < 0) {
+            return -1;
+        }
+
+        DEBUG2("video clip %d finished", seq->current);
+        seq->base += clip->last + 1.0 / clip->fps;
+        mm_close(&clip->mf);
+        mm_ring_free(&clip->ring);
+        SDL_mutexP(seq->lock);
+        clip->state = CLIP_CLOSED;
+        seq->current++;
+        SDL_mutexV(seq->lock);
+    }
+
+    return 0;
+}
+
+/**
+ * Copy the frame taken by video_sequence_next() to an overlay.
+ *
+ * \return 0 on success, -1 on error
+ */
+int
+video_sequence_show(struct video_sequence *seq, SDL_Overlay *ovl)
+{
+    struct video_clip *clip;
+
+    assert(seq);
+    assert(ovl);
+    assert(seq->taken);
+
+    clip = &seq->clips[seq->current];
+
+    /* only the worker moves the back of the ring */
+    return mm_show_frame(&clip->ring, &clip->ring.frames[clip->ring.head],
+                         ovl);
+}
@@ -0,0 +1,26 @@
+#ifndef VIDEO_SEQUENCE_H
+#define VIDEO_SEQUENCE_H
+
+#include <string>
+#include <vector>
+
+#include <SDL/SDL.h>
+
+/**
+ * \file video_sequence.h Video clips played back to back.
+ *
+ * A background thread decodes a few frames ahead of the one on screen,
+ * and while one clip plays it opens the next one and decodes its first
+ * frames, so the switch from one clip to the next costs no more than an
+ * ordinary frame.
+ */
+
+struct video_sequence;
+
+struct video_sequence *video_sequence_open(
+    const std::vector<std::string> &names, const SDL_Overlay *ovl);
+void video_sequence_close(struct video_sequence *seq);
+int video_sequence_next(struct video_sequence *seq, double *pts, float *fps);
+int video_sequence_show(struct video_sequence *seq, SDL_Overlay *ovl);
+
+#endif /* VIDEO_SEQUENCE_H */
@@ -0,0 +1,786 @@
+/*
+ * asset_pipeline walks a data directory and decodes and validates every
+ * .dat, .cdr, .but, .png and .ogg file in it, spread over all cores.
+ *
+ * For each asset it writes either a JSON description (-f json) or a
+ * binary file with the decoded contents (-f binary) under the output
+ * directory, mirroring the layout of the data directory:
+ *
+ *   png          image header and palette / the decoded rows
+ *   ogg          streams, codecs, sizes and durations, with every page
+ *                CRC checked / the demuxed packets
+ *   dat cdr but  record counts where the layout is known / the bytes
+ *
+ * output/manifest.json records a content hash for each asset, so a
+ * later run only redoes the assets that changed.
+ *
+ * usage: asset_pipeline [-j threads] [-f json|binary] <data dir> <output dir>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <png.h>
+#include <jsoncpp/json/json.h>
+
+#define MANIFEST_VERSION 1
+#define BINARY_MAGIC "RISA"
+
+/* record sizes from src/game/gamedata.h and data_decoder.cpp */
+#define MISSION_RECORD 226          /* struct mStr */
+#define SEQ_RECORD (10 + 5 * 4)     /* sizeof_oGROUP */
+#define CREW_RECORD 20              /* struct ManPool */
+#define FSEQ_TABLES 50
+#define FSEQ_TABLE (8 + 4 + 2)      /* sizeof_Table */
+
+typedef std::vector<uint8_t> bytes;
+
+struct asset {
+    std::string path;               /* relative to the data directory */
+    std::string kind;               /* lower case extension */
+    std::string hash;
+    bool skipped;
+    bool failed;
+    std::string error;
+};
+
+static struct {
+    std::string data_dir;
+    std::string out_dir;
+    bool binary;
+    std::map<std::string, std::string> old_hashes;
+    std::vector<asset> assets;
+    size_t next;                    /* next asset for a worker */
+    pthread_mutex_t lock;
+} pipeline;
+
+static double now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* -------------------------------------------------------------------- */
+/* files */
+
+static std::string lower_extension(const std::string &name)
+{
+    size_t dot = name.rfind('.');
+    std::string ext;
+
+    if (dot == std::string::npos) {
+        return ext;
+    }
+
+    for (size_t i = dot + 1; i < name.size(); i++) {
+        ext += tolower((unsigned char) name[i]);
+    }
+
+    return ext;
+}
+
+static void find_assets(const std::string &dir, const std::string &prefix)
+{
+    DIR *d = opendir(dir.c_str());
+    struct dirent *ent;
+
+    if (!d) {
+        perror(dir.c_str());
+        return;
+    }
+
+    while ((ent = readdir(d)) != NULL) {
+        std::string name = ent->d_name;
+        std::string full = dir + "/" + name;
+        std::string ext = lower_extension(name);
+        struct stat st;
+
+        if (name[0] == '.' || stat(full.c_str(), &st) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            find_assets(full, prefix + name + "/");
+        } else if (ext == "dat" || ext == "cdr" || ext == "but" ||
+                   ext == "png" || ext == "ogg") {
+            asset a;
+
+            a.path = prefix + name;
+            a.kind = ext;
+            a.skipped = false;
+            a.failed = false;
+            pipeline.assets.push_back(a);
+        }
+    }
+
+    closedir(d);
+}
+
+static bool read_file(const std::string &path, bytes &data)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    uint8_t buf[65536];
+    size_t n;
+
+    if (!fp) {
+        return false;
+    }
+
+    data.clear();
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+/* create the directories leading to a file; other workers may race us */
+static void make_parents(const std::string &path)
+{
+    for (size_t i = pipeline.out_dir.size() + 1; i < path.size(); i++) {
+        if (path[i] == '/') {
+            mkdir(path.substr(0, i).c_str(), 0755);
+        }
+    }
+}
+
+static bool write_file(const std::string &path, const void *data, size_t size)
+{
+    std::string tmp = path + ".tmp";
+    FILE *fp;
+
+    make_parents(path);
+
+    if ((fp = fopen(tmp.c_str(), "wb")) == NULL) {
+        return false;
+    }
+
+    bool ok = fwrite(data, 1, size, fp) == size;
+
+    if (fclose(fp) != 0 || !ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static bool exists(const std::string &path)
+{
+    struct stat st;
+
+    return stat(path.c_str(), &st) == 0;
+}
+
+static std::string output_path(const asset &a)
+{
+    return pipeline.out_dir + "/" + a.path + (pipeline.binary ? ".bin" : ".json");
+}
+
+/* 64-bit FNV-1a, as a hex string */
+static std::string content_hash(const bytes &data)
+{
+    uint64_t h = 14695981039346656037ULL;
+    char hex[17];
+
+    for (size_t i = 0; i < data.size(); i++) {
+        h = (h ^ data[i]) * 1099511628211ULL;
+    }
+
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) h);
+    return hex;
+}
+
+static void put32(bytes &out, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        out.push_back((v >> (8 * i)) & 0xff);
+    }
+}
+
+static uint32_t get_le(const uint8_t *p, int n)
+{
+    uint32_t v = 0;
+
+    for (int i = n - 1; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+static uint32_t get_be(const uint8_t *p, int n)
+{
+    uint32_t v = 0;
+
+    for (int i = 0; i < n; i++) {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+/* -------------------------------------------------------------------- */
+/* decoders: each fills in a description and the decoded contents, or
+ * returns an error message */
+
+struct png_source {
+    const bytes *data;
+    size_t pos;
+};
+
+static void png_read_memory(png_structp png, png_bytep out, png_size_t size)
+{
+    png_source *src = (png_source *) png_get_io_ptr(png);
+
+    if (src->pos + size > src->data->size()) {
+        png_error(png, "truncated file");
+    }
+
+    memcpy(out, &(*src->data)[src->pos], size);
+    src->pos += size;
+}
+
+static std::string decode_png(const bytes &data, Json::Value &info,
+                              bytes &out)
+{
+    png_source src = { &data, 0 };
+    png_structp png;
+    png_infop png_info;
+    std::vector<png_bytep> rows;
+    png_uint_32 w, h;
+    int depth, color, interlace;
+
+    if (data.size() < 8 || png_sig_cmp((png_bytep) &data[0], 0, 8)) {
+        return "not a PNG file";
+    }
+
+    png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_info = png ? png_create_info_struct(png) : NULL;
+
+    if (!png_info) {
+        png_destroy_read_struct(&png, NULL, NULL);
+        return "out of memory";
+    }
+
+    /* libpng reports bad CRCs and broken zlib data by jumping here */
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_read_struct(&png, &png_info, NULL);
+        return "corrupt PNG data";
+    }
+
+    /* by default a bad CRC on an ancillary chunk is only a warning */
+    png_set_crc_action(png, PNG_CRC_ERROR_QUIT, PNG_CRC_ERROR_QUIT);
+    png_set_read_fn(png, &src, png_read_memory);
+    png_read_info(png, png_info);
+    png_get_IHDR(png, png_info, &w, &h, &depth, &color, &interlace, NULL,
+                 NULL);
+
+    info["width"] = (Json::UInt) w;
+    info["height"] = (Json::UInt) h;
+    info["bit_depth"] = depth;
+    info["color_type"] = color;
+    info["interlaced"] = interlace != PNG_INTERLACE_NONE;
+
+    if (color == PNG_COLOR_TYPE_PALETTE) {
+        png_colorp palette;
+        int colors = 0;
+
+        png_get_PLTE(png, png_info, &palette, &colors);
+        info["palette_colors"] = colors;
+    }
+
+    png_set_interlace_handling(png);
+    png_read_update_info(png, png_info);
+
+    size_t stride = png_get_rowbytes(png, png_info);
+    size_t header = out.size();
+
+    put32(out, w);
+    put32(out, h);
+    put32(out, stride);
+    out.resize(header + 12 + stride * h);
+    rows.resize(h);
+
+    for (png_uint_32 y = 0; y < h; y++) {
+        rows[y] = &out[header + 12 + y * stride];
+    }
+
+    png_read_image(png, rows.empty() ? NULL : &rows[0]);
+    png_read_end(png, NULL);
+    png_destroy_read_struct(&png, &png_info, NULL);
+    return "";
+}
+
+static uint32_t ogg_crc_table[256];
+
+static void init_ogg_crc(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t r = i << 24;
+
+        for (int j = 0; j < 8; j++) {
+            r = (r & 0x80000000UL) ? (r << 1) ^ 0x04c11db7UL : (r << 1);
+        }
+
+        ogg_crc_table[i] = r;
+    }
+}
+
+/* the page CRC, computed with the CRC field taken as zero */
+static uint32_t ogg_crc(const uint8_t *page, size_t size)
+{
+    uint32_t crc = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        uint8_t b = (i >= 22 && i < 26) ? 0 : page[i];
+
+        crc = (crc << 8) ^ ogg_crc_table[((crc >> 24) & 0xff) ^ b];
+    }
+
+    return crc;
+}
+
+struct ogg_stream_info {
+    std::string codec;
+    unsigned pages;
+    unsigned packets;
+    uint64_t granule;
+    bytes partial;                  /* packet continued on the next page */
+    /* from the identification header */
+    uint32_t width, height, fps_num, fps_den, channels, rate;
+    int shift;
+};
+
+static void ogg_ident(ogg_stream_info &s, const bytes &pkt)
+{
+    const uint8_t *p = pkt.empty() ? NULL : &pkt[0];
+
+    if (pkt.size() >= 42 && memcmp(p, "\x80theora", 7) == 0) {
+        s.codec = "theora";
+        s.width = get_be(p + 14, 3);
+        s.height = get_be(p + 17, 3);
+        s.fps_num = get_be(p + 22, 4);
+        s.fps_den = get_be(p + 26, 4);
+        s.shift = (get_be(p + 40, 2) >> 5) & 31;
+    } else if (pkt.size() >= 16 && memcmp(p, "\x01vorbis", 7) == 0) {
+        s.codec = "vorbis";
+        s.channels = p[11];
+        s.rate = get_le(p + 12, 4);
+    } else {
+        s.codec = "unknown";
+    }
+}
+
+static std::string decode_ogg(const bytes &data, Json::Value &info,
+                              bytes &out)
+{
+    std::map<uint32_t, ogg_stream_info> streams;
+    std::vector<uint32_t> order;
+    size_t pos = 0;
+    unsigned pages = 0;
+
+    while (pos < data.size()) {
+        const uint8_t *p = &data[pos];
+        size_t left = data.size() - pos;
+
+        if (left < 27 || memcmp(p, "OggS", 4) != 0) {
+            return "bad page at " + Json::valueToString((Json::UInt) pos);
+        }
+
+        if (p[4] != 0) {
+            return "unknown page version";
+        }
+
+        size_t header = 27 + p[26];
+        size_t body = 0;
+
+        if (left < header) {
+            return "truncated page header";
+        }
+
+        for (size_t i = 27; i < header; i++) {
+            body += p[i];
+        }
+
+        if (left < header + body) {
+            return "truncated page";
+        }
+
+        if (ogg_crc(p, header + body) != get_le(p + 22, 4)) {
+            return "page CRC mismatch at " + Json::valueToString((Json::UInt) pos);
+        }
+
+        uint32_t serial = get_le(p + 14, 4);
+        uint64_t granule = get_le(p + 6, 4) | ((uint64_t) get_le(p + 10, 4) << 32);
+
+        if (!streams.count(serial)) {
+            if (!(p[5] & 2)) {
+                return "page of a stream without a first page";
+            }
+
+            order.push_back(serial);
+        }
+
+        ogg_stream_info &s = streams[serial];
+        const uint8_t *seg = p + header;
+
+        if (!(p[5] & 1)) {
+            s.partial.clear();      /* not continued: drop any leftover */
+        }
+
+        s.pages++;
+
+        if (granule != (uint64_t) -1) {
+            s.granule = granule;
+        }
+
+        for (size_t i = 27; i < header; i++) {
+            s.partial.insert(s.partial.end(), seg, seg + p[i]);
+            seg += p[i];
+
+            if (p[i] < 255) {
+                if (s.packets == 0) {
+                    ogg_ident(s, s.partial);
+                }
+
+                put32(out, serial);
+                put32(out, s.partial.size());
+                out.insert(out.end(), s.partial.begin(), s.partial.end());
+                s.packets++;
+                s.partial.clear();
+            }
+        }
+
+        pos += header + body;
+        pages++;
+    }
+
+    Json::Value list(Json::arrayValue);
+
+    for (size_t i = 0; i < order.size(); i++) {
+        ogg_stream_info &s = streams[order[i]];
+        Json::Value v(Json::objectValue);
+
+        v["serial"] = (Json::UInt) order[i];
+        v["codec"] = s.codec;
+        v["pages"] = s.pages;
+        v["packets"] = s.packets;
+
+        if (s.codec == "theora" && s.fps_num && s.fps_den) {
+            uint64_t frames = (s.granule >> s.shift) +
+                              (s.granule & ((1ULL << s.shift) - 1));
+
+            v["width"] = s.width;
+            v["height"] = s.height;
+            v["fps"] = (double) s.fps_num / s.fps_den;
+            v["frames"] = (Json::UInt) frames;
+            v["seconds"] = (double) frames * s.fps_den / s.fps_num;
+        } else if (s.codec == "vorbis" && s.rate) {
+            v["channels"] = s.channels;
+            v["rate"] = s.rate;
+            v["seconds"] = (double) s.granule / s.rate;
+        }
+
+        list.append(v);
+    }
+
+    info["pages"] = pages;
+    info["streams"] = list;
+    return "";
+}
+
+/* data files: check the layouts that are known, pass the bytes on */
+static std::string decode_table(const asset &a, const bytes &data,
+                                Json::Value &info, bytes &out)
+{
+    std::string name = a.path.substr(a.path.rfind('/') + 1);
+    size_t record = 0;
+
+    for (size_t i = 0; i < name.size(); i++) {
+        name[i] = tolower((unsigned char) name[i]);
+    }
+
+    if (name == "mission.dat") {
+        record = MISSION_RECORD;
+    } else if (name == "seq.dat") {
+        record = SEQ_RECORD;
+    } else if (name == "crew.dat" || name == "user.dat") {
+        record = CREW_RECORD;
+    } else if (name == "fseq.dat") {
+        if (data.size() < FSEQ_TABLES * FSEQ_TABLE) {
+            return "table index truncated";
+        }
+
+        for (int i = 0; i < FSEQ_TABLES; i++) {
+            const uint8_t *t = &data[i * FSEQ_TABLE + 8];
+            uint32_t offset = get_le(t, 4);
+            uint32_t size = get_le(t + 4, 2);
+
+            if (offset + size > data.size()) {
+                return "table " + Json::valueToString(i) + " out of range";
+            }
+        }
+
+        info["tables"] = FSEQ_TABLES;
+    }
+
+    if (record) {
+        if (data.size() % record != 0) {
+            return "size is not a whole number of records";
+        }
+
+        info["record_size"] = (Json::UInt) record;
+        info["records"] = (Json::UInt) (data.size() / record);
+    }
+
+    out.insert(out.end(), data.begin(), data.end());
+    return "";
+}
+
+/* -------------------------------------------------------------------- */
+/* workers */
+
+static void process(asset &a)
+{
+    bytes data, out;
+    Json::Value info(Json::objectValue);
+    std::string error;
+    std::string dest = output_path(a);
+
+    if (!read_file(pipeline.data_dir + "/" + a.path, data)) {
+        a.failed = true;
+        a.error = strerror(errno);
+        return;
+    }
+
+    a.hash = content_hash(data);
+
+    std::map<std::string, std::string>::const_iterator old =
+        pipeline.old_hashes.find(a.path);
+
+    if (old != pipeline.old_hashes.end() && old->second == a.hash &&
+        exists(dest)) {
+        a.skipped = true;
+        return;
+    }
+
+    if (pipeline.binary) {
+        out.insert(out.end(), BINARY_MAGIC, BINARY_MAGIC + 4);
+        put32(out, MANIFEST_VERSION);
+        out.insert(out.end(), a.kind.begin(), a.kind.end());
+        out.resize(12, 0);
+    }
+
+    if (a.kind == "png") {
+        error = decode_png(data, info, out);
+    } else if (a.kind == "ogg") {
+        error = decode_ogg(data, info, out);
+    } else {
+        error = decode_table(a, data, info, out);
+    }
+
+    if (!error.empty()) {
+        a.failed = true;
+        a.error = error;
+        return;
+    }
+
+    if (!pipeline.binary) {
+        info["path"] = a.path;
+        info["kind"] = a.kind;
+        info["size"] = (Json::UInt) data.size();
+        info["hash"] = a.hash;
+
+        std::string text = Json::StyledWriter().write(info);
+        out.assign(text.begin(), text.end());
+    }
+
+    if (!write_file(dest, out.empty() ? NULL : &out[0], out.size())) {
+        a.failed = true;
+        a.error = "can't write " + dest;
+    }
+}
+
+static void *worker(void *)
+{
+    for (;;) {
+        size_t i;
+
+        pthread_mutex_lock(&pipeline.lock);
+        i = pipeline.next++;
+        pthread_mutex_unlock(&pipeline.lock);
+
+        if (i >= pipeline.assets.size()) {
+            return NULL;
+        }
+
+        process(pipeline.assets[i]);
+    }
+}
+
+/* -------------------------------------------------------------------- */
+/* manifest */
+
+static std::string manifest_path(void)
+{
+    return pipeline.out_dir + "/manifest.json";
+}
+
+static void read_manifest(void)
+{
+    std::ifstream in(manifest_path().c_str());
+    Json::Reader reader;
+    Json::Value root;
+
+    if (!in || !reader.parse(in, root) || !root.isObject()) {
+        return;
+    }
+
+    /* outputs of another format or version are all redone */
+    if (root["version"].asInt() != MANIFEST_VERSION ||
+        root["format"].asString() != (pipeline.binary ? "binary" : "json")) {
+        return;
+    }
+
+    const Json::Value &assets = root["assets"];
+    Json::Value::Members names = assets.getMemberNames();
+
+    for (size_t i = 0; i < names.size(); i++) {
+        pipeline.old_hashes[names[i]] = assets[names[i]]["hash"].asString();
+    }
+}
+
+static bool write_manifest(void)
+{
+    Json::Value root(Json::objectValue);
+    Json::Value assets(Json::objectValue);
+
+    root["version"] = MANIFEST_VERSION;
+    root["format"] = pipeline.binary ? "binary" : "json";
+
+    for (size_t i = 0; i < pipeline.assets.size(); i++) {
+        const asset &a = pipeline.assets[i];
+
+        /* failed assets are left out so they are tried again */
+        if (!a.failed) {
+            Json::Value v(Json::objectValue);
+
+            v["hash"] = a.hash;
+            v["kind"] = a.kind;
+            assets[a.path] = v;
+        }
+    }
+
+    root["assets"] = assets;
+
+    std::string text = Json::StyledWriter().write(root);
+    return write_file(manifest_path(), text.data(), text.size());
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-j threads] [-f json|binary] "
+            "<data dir> <output dir>\n", name);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *format = "json";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:f:")) != -1) {
+        switch (opt) {
+        case 'j':
+            threads = atoi(optarg);
+            break;
+
+        case 'f':
+            format = optarg;
+            break;
+
+        default:
+            usage(argv[0]);
+        }
+    }
+
+    if (argc - optind != 2 || threads < 1 ||
+        (strcmp(format, "json") && strcmp(format, "binary"))) {
+        usage(argv[0]);
+    }
+
+    pipeline.data_dir = argv[optind];
+    pipeline.out_dir = argv[optind + 1];
+    pipeline.binary = !strcmp(format, "binary");
+    pthread_mutex_init(&pipeline.lock, NULL);
+    init_ogg_crc();
+
+    if (mkdir(pipeline.out_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(pipeline.out_dir.c_str());
+        return 1;
+    }
+
+    double start = now();
+
+    find_assets(pipeline.data_dir, "");
+    read_manifest();
+
+    std::vector<pthread_t> workers(threads);
+
+    for (long i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, worker, NULL);
+    }
+
+    for (long i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    unsigned done = 0, skipped = 0, failed = 0;
+
+    for (size_t i = 0; i < pipeline.assets.size(); i++) {
+        const asset &a = pipeline.assets[i];
+
+        if (a.failed) {
+            fprintf(stderr, "%s: %s\n", a.path.c_str(), a.error.c_str());
+            failed++;
+        } else if (a.skipped) {
+            skipped++;
+        } else {
+            done++;
+        }
+    }
+
+    if (!write_manifest()) {
+        fprintf(stderr, "can't write %s\n", manifest_path().c_str());
+        failed++;
+    }
+
+    printf("%u assets: %u processed, %u unchanged, %u failed "
+           "in %.2f s on %ld threads\n",
+           (unsigned) pipeline.assets.size(), done, skipped, failed,
+           now() - start, threads);
+
+    return failed ? 1 : 0;
+}
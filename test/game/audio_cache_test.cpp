@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "game/audio_cache.h"
+
+// Every file decodes to 100 bytes, except "missing" which fails.
+static int loads;
+
+static ssize_t fake_loader(const char *name, char **data, size_t *size)
+{
+    loads++;
+
+    if (!strcmp(name, "missing")) {
+        return -1;
+    }
+
+    *size = 100;
+    *data = (char *)malloc(*size);
+    memset(*data, name[0], *size);
+    return 100;
+}
+
+struct AudioCacheFixture {
+    AudioCacheFixture()
+    {
+        loads = 0;
+        audio_cache_init(250, fake_loader);
+    }
+    ~AudioCacheFixture()
+    {
+        audio_cache_shutdown();
+    }
+
+    struct audio_cache_stats stats()
+    {
+        struct audio_cache_stats s;
+        audio_cache_get_stats(&s);
+        return s;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(audio_cache_suite, AudioCacheFixture)
+
+BOOST_AUTO_TEST_CASE(audio_cache_hit_test)
+{
+    struct audio_pcm *a = audio_cache_get("a");
+    audio_cache_release(a);
+
+    struct audio_pcm *b = audio_cache_get("a");
+
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(b->size, 100u);
+    BOOST_CHECK_EQUAL(b->data[0], 'a');
+    BOOST_CHECK_EQUAL(loads, 1);
+    BOOST_CHECK_EQUAL(stats().hits, 1ul);
+    BOOST_CHECK_EQUAL(stats().misses, 1ul);
+    audio_cache_release(b);
+}
+
+BOOST_AUTO_TEST_CASE(audio_cache_failure_test)
+{
+    BOOST_CHECK(audio_cache_get("missing") == NULL);
+    BOOST_CHECK_EQUAL(stats().entries, 0u);
+    BOOST_CHECK_EQUAL(stats().bytes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(audio_cache_lru_test)
+{
+    audio_cache_release(audio_cache_get("a"));
+    audio_cache_release(audio_cache_get("b"));
+    audio_cache_release(audio_cache_get("a"));
+
+    // over budget: "b" is the least recently used
+    audio_cache_release(audio_cache_get("c"));
+
+    BOOST_CHECK_EQUAL(stats().evictions, 1ul);
+    BOOST_CHECK_EQUAL(stats().entries, 2u);
+
+    audio_cache_release(audio_cache_get("a"));
+    BOOST_CHECK_EQUAL(loads, 3);
+
+    audio_cache_release(audio_cache_get("b"));
+    BOOST_CHECK_EQUAL(loads, 4);
+}
+
+BOOST_AUTO_TEST_CASE(audio_cache_refcount_test)
+{
+    struct audio_pcm *a = audio_cache_get("a");
+    audio_cache_release(audio_cache_get("b"));
+    audio_cache_release(audio_cache_get("c"));
+
+    // "a" is the oldest but still referenced, so "b" goes instead
+    BOOST_CHECK_EQUAL(stats().evictions, 1ul);
+    BOOST_CHECK_EQUAL(a->data[0], 'a');
+
+    struct audio_pcm *d = audio_cache_get("d");
+
+    // nothing left to evict but "c"; "a" and "d" overrun the budget
+    BOOST_CHECK_EQUAL(stats().evictions, 2ul);
+    BOOST_CHECK_EQUAL(stats().bytes, 200u);
+
+    audio_cache_release(a);
+    audio_cache_release(d);
+    BOOST_CHECK_EQUAL(stats().bytes, 200u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,41 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+
+#include "game/data.h"
+#include "game/game_context.h"
+#include "game/game_main.h"
+
+BOOST_AUTO_TEST_SUITE(game_context_suite)
+
+BOOST_AUTO_TEST_CASE(game_context_reset_test)
+{
+    struct GameContext ctx;
+
+    game_context_init(&ctx);
+    game_context_reset(&ctx);
+    BOOST_CHECK(Data == ctx.data);
+
+    // what a game leaves behind
+    manOnMoon = 3;
+    dayOnMoon = 1;
+    MAIL = 0;
+    pNeg[1][2] = 1;
+    Data->Year = 70;
+    interimData.eventSize = 16;
+    interimData.eventBuffer = (char *)calloc(1, interimData.eventSize);
+
+    // is gone from the next game on the same thread
+    game_context_reset(&ctx);
+    BOOST_CHECK_EQUAL(manOnMoon, 0);
+    BOOST_CHECK_EQUAL(dayOnMoon, 20);
+    BOOST_CHECK_EQUAL(MAIL, -1);
+    BOOST_CHECK_EQUAL(pNeg[1][2], 0);
+    BOOST_CHECK_EQUAL(Data->Year, 0);
+    BOOST_CHECK(interimData.eventBuffer == NULL);
+    BOOST_CHECK(Data == ctx.data);
+
+    game_context_free(&ctx);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
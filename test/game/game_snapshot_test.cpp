@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "game/data.h"
+#include "game/game_context.h"
+#include "game/game_main.h"
+#include "game/game_snapshot.h"
+
+BOOST_AUTO_TEST_SUITE(game_snapshot_suite)
+
+// a thread-local game for each test, with some events recorded
+struct snapshot_fixture {
+    struct GameContext ctx;
+
+    snapshot_fixture()
+    {
+        game_context_init(&ctx);
+        game_context_reset(&ctx);
+        rng_seed(&game_rng, 1);
+        Data->P[0].Cash = 100;
+        Data->Year = 57;
+        interimData.eventSize = 16;
+        interimData.eventBuffer = (char *)calloc(1, interimData.eventSize);
+        interimData.tempEvents = (OLDNEWS *)interimData.eventBuffer;
+    }
+
+    ~snapshot_fixture()
+    {
+        game_context_free(&ctx);
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(game_snapshot_restore_test, snapshot_fixture)
+{
+    struct game_snapshot *snap = game_snapshot_fork();
+    uint64_t roll = rng_next(&game_rng);
+
+    Data->P[0].Cash = 5;
+    Data->Year = 60;
+    interimData.eventBuffer = (char *)realloc(interimData.eventBuffer, 32);
+    interimData.eventSize = 32;
+    strcpy(interimData.eventBuffer, "something happened");
+
+    game_snapshot_restore(snap);
+
+    BOOST_CHECK_EQUAL(Data->P[0].Cash, 100);
+    BOOST_CHECK_EQUAL(Data->Year, 57);
+    BOOST_CHECK_EQUAL(interimData.eventSize, 16U);
+    BOOST_CHECK_EQUAL(interimData.eventBuffer[0], 0);
+    BOOST_CHECK_EQUAL(rng_next(&game_rng), roll);
+
+    game_snapshot_free(snap);
+}
+
+BOOST_FIXTURE_TEST_CASE(game_snapshot_diff_test, snapshot_fixture)
+{
+    struct game_snapshot *a = game_snapshot_fork();
+    struct game_snapshot *b = game_snapshot_fork();
+    std::vector<struct snapshot_change> changes;
+
+    BOOST_CHECK_EQUAL(game_snapshot_diff(a, b, &changes), 0);
+    BOOST_CHECK(changes.empty());
+
+    Data->P[1].Cash = 7;
+    Data->Year = 58;
+    game_snapshot_take(b);
+
+    BOOST_REQUIRE_EQUAL(game_snapshot_diff(a, b, &changes), 2);
+    BOOST_CHECK_EQUAL(changes[0].field, "Year");
+    BOOST_CHECK_EQUAL(changes[0].player, -1);
+    BOOST_CHECK_EQUAL(changes[1].field, "Cash");
+    BOOST_CHECK_EQUAL(changes[1].player, 1);
+
+    game_snapshot_free(a);
+    game_snapshot_free(b);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+
+#include "game/glyph_atlas.h"
+
+namespace
+{
+
+const int WIDTH = 48;
+const int HEIGHT = 24;
+
+void plot(struct glyph_pen *pen, int x, int y)
+{
+    char *pixels = static_cast<char *>(pen->data);
+
+    if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+        pixels[y * WIDTH + x] = 1;
+    }
+}
+
+};
+
+BOOST_AUTO_TEST_SUITE(glyph_atlas_suite)
+
+BOOST_AUTO_TEST_CASE(glyph_matches_strokes_test)
+{
+    char stroked[WIDTH * HEIGHT];
+    char blitted[WIDTH * HEIGHT];
+
+    for (int c = 1; c < 256; c++) {
+        const char chr = static_cast<char>(c);
+        struct glyph_pen pen = { 20, 12, plot, stroked };
+        int x = 20, y = 12;
+
+        memset(stroked, 0, sizeof(stroked));
+        memset(blitted, 0, sizeof(blitted));
+
+        glyph_stroke(&pen, chr);
+        glyph_draw(blitted, WIDTH, WIDTH, HEIGHT, &x, &y, &chr, 1, 1, NULL);
+
+        BOOST_CHECK_MESSAGE(memcmp(stroked, blitted, sizeof(stroked)) == 0,
+                            "glyph " << c << " differs from its strokes");
+        BOOST_CHECK_EQUAL(x, pen.x);
+        BOOST_CHECK_EQUAL(y, pen.y);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(glyph_clips_test)
+{
+    char pixels[WIDTH * HEIGHT];
+    struct glyph_rect touched;
+    int x = WIDTH - 3, y = 2;
+
+    memset(pixels, 0, sizeof(pixels));
+    glyph_draw(pixels, WIDTH, WIDTH, HEIGHT, &x, &y, "MW", 2, 1, &touched);
+
+    BOOST_CHECK_EQUAL(x, WIDTH - 3 + 12);
+    BOOST_CHECK_GE(touched.x, WIDTH - 3);
+    BOOST_CHECK_EQUAL(touched.x + touched.w, WIDTH);
+    BOOST_CHECK_EQUAL(touched.y, 0);
+}
+
+BOOST_AUTO_TEST_CASE(glyph_text_width_test)
+{
+    BOOST_CHECK_EQUAL(glyph_text_width(""), 0);
+    BOOST_CHECK_EQUAL(glyph_text_width("A"), 5);
+    BOOST_CHECK_EQUAL(glyph_text_width("mission"), 37);
+    BOOST_CHECK_EQUAL(glyph_text_width("1-2"), 14);
+    BOOST_CHECK_EQUAL(glyph_text_width("A^"), 9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
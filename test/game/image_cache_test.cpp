@@ -0,0 +1,79 @@
+#include <boost/test/unit_test.hpp>
+
+#include "display/palette.h"
+#include "game/image_cache.h"
+
+namespace
+{
+
+int decodes;
+
+// Stands in for decoding a PNG: a 10x10 image, whatever the name
+ImageCache::Image fakeDecode(const std::string &filename)
+{
+    decodes++;
+    return ImageCache::Image(
+               new display::PalettizedSurface(10, 10, display::Palette()));
+}
+
+// Enough for two of the fake images, but not three
+const size_t BUDGET = 2 * (10 * 10 + 1280) + 100;
+
+};
+
+BOOST_AUTO_TEST_SUITE(image_cache_suite)
+
+BOOST_AUTO_TEST_CASE(image_cache_hit_test)
+{
+    ImageCache::init(BUDGET, fakeDecode);
+    ImageCache::clear();
+    decodes = 0;
+
+    ImageCache::Image first = ImageCache::get("images/a.png");
+    ImageCache::Image second = ImageCache::get("images/a.png");
+
+    BOOST_CHECK_EQUAL(decodes, 1);
+    BOOST_CHECK(first == second);
+}
+
+BOOST_AUTO_TEST_CASE(image_cache_eviction_test)
+{
+    ImageCache::init(BUDGET, fakeDecode);
+    ImageCache::clear();
+    decodes = 0;
+
+    // Held images can't be evicted, even over budget
+    ImageCache::Image a = ImageCache::get("images/a.png");
+    ImageCache::Image b = ImageCache::get("images/b.png");
+    ImageCache::Image c = ImageCache::get("images/c.png");
+    BOOST_CHECK_EQUAL(ImageCache::stats().entries, 3u);
+
+    // Once nothing holds them, the least recently used one goes
+    a.reset();
+    b.reset();
+    c.reset();
+    ImageCache::get("images/c.png");
+    ImageCache::get("images/d.png");
+
+    BOOST_CHECK_EQUAL(decodes, 4);
+    BOOST_CHECK_LE(ImageCache::stats().bytes, BUDGET);
+
+    ImageCache::get("images/d.png");
+    BOOST_CHECK_EQUAL(decodes, 4);
+    ImageCache::get("images/a.png");
+    BOOST_CHECK_EQUAL(decodes, 5);
+}
+
+BOOST_AUTO_TEST_CASE(image_cache_disabled_test)
+{
+    ImageCache::init(0, fakeDecode);
+    decodes = 0;
+
+    ImageCache::get("images/a.png");
+    ImageCache::get("images/a.png");
+
+    BOOST_CHECK_EQUAL(decodes, 2);
+    BOOST_CHECK_EQUAL(ImageCache::stats().entries, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+#include <boost/test/unit_test.hpp>
+
+#include "game/media_clock.h"
+#include "game/utils.h"
+
+// Only paths that return without sleeping are tested, since sleeping
+// handles SDL events.
+
+BOOST_AUTO_TEST_SUITE(media_clock_suite)
+
+BOOST_AUTO_TEST_CASE(media_clock_due_test)
+{
+    struct media_clock mc;
+
+    media_clock_start(&mc, "test");
+    mc.start = 100;
+
+    BOOST_CHECK_CLOSE(media_clock_due(&mc, 0.5, 100), 0.5, 1e-9);
+    BOOST_CHECK_CLOSE(media_clock_due(&mc, 0.5, 101), -0.5, 1e-9);
+
+    media_clock_hold(&mc, 2);
+    BOOST_CHECK_CLOSE(media_clock_due(&mc, 0.5, 101), 1.5, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(media_clock_drop_test)
+{
+    struct media_clock mc;
+    double frame = 1.0 / 15;
+
+    media_clock_start(&mc, "test");
+
+    // three frames late, but not late enough to restart the clock
+    media_clock_restart(&mc, 3 * frame);
+
+    for (int i = 0; i < MEDIA_CLOCK_MAX_DROPS; i++) {
+        BOOST_CHECK_EQUAL(media_clock_wait(&mc, 0, frame, 0.001), 0);
+    }
+
+    BOOST_CHECK_EQUAL(mc.decoded, (unsigned long) MEDIA_CLOCK_MAX_DROPS);
+    BOOST_CHECK_EQUAL(mc.dropped, (unsigned long) MEDIA_CLOCK_MAX_DROPS);
+    BOOST_CHECK_CLOSE(mc.decode_secs, MEDIA_CLOCK_MAX_DROPS * 0.001, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(media_clock_resync_test)
+{
+    struct media_clock mc;
+
+    media_clock_start(&mc, "test");
+
+    // a long stall shows the frame and makes it due now
+    media_clock_restart(&mc, 10);
+    BOOST_CHECK_EQUAL(media_clock_wait(&mc, 1, 1.0 / 15, 0), 1);
+    BOOST_CHECK_EQUAL(mc.dropped, 0UL);
+    BOOST_CHECK_SMALL(media_clock_due(&mc, 1, get_time()), 0.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "game/data.h"
+#include "game/mission_odds.h"
+
+BOOST_AUTO_TEST_SUITE(mission_odds_suite)
+
+// an unmanned mission of one launch, which ends it on success
+static void
+launch_only(struct odds_model *m, int safety)
+{
+    Equipment *rocket;
+
+    memset(m, 0, sizeof(*m));
+    m->data = (struct Players *)calloc(1, sizeof(struct Players));
+    m->data->Def.Lev1 = m->data->Def.Lev2 = 1;
+    memset(m->cap, -1, sizeof(m->cap));
+    memset(m->lm, -1, sizeof(m->lm));
+    memset(m->doc, -1, sizeof(m->doc));
+    memset(m->eva, -1, sizeof(m->eva));
+    m->ai = 1;
+    m->steps = 1;
+
+    rocket = &m->data->P[0].Rocket[0];
+    strcpy(rocket->Name, "ATLAS");
+    memcpy(rocket->ID, "R1", 2);
+    rocket->MisSaf = rocket->Safety = rocket->Base = safety;
+    rocket->MaxSafety = 99;
+    m->mh[0][Mission_PrimaryBooster] = rocket;
+
+    strcpy(m->mev[0].Name, "AUR1");
+    m->mev[0].E = rocket;
+    m->mev[0].fgoto = -1;
+    m->mev[0].sgoto = 100;
+}
+
+BOOST_AUTO_TEST_CASE(mission_odds_interval_test)
+{
+    double low, high;
+
+    mission_odds_interval(0, 100, &low, &high);
+    BOOST_CHECK_EQUAL(low, 0);
+    BOOST_CHECK_CLOSE(high, 0.037, 1.0);
+
+    mission_odds_interval(50, 100, &low, &high);
+    BOOST_CHECK_CLOSE(low, 0.404, 1.0);
+    BOOST_CHECK_CLOSE(high, 0.596, 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(mission_odds_outcome_test)
+{
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 1), ODDS_SUCCESS);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(1, 1003), ODDS_FAILURE);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 1003), ODDS_PARTIAL);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 1999), ODDS_FAILURE);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 2100), ODDS_INJURY);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 3100), ODDS_DEATH);
+    BOOST_CHECK_EQUAL(mission_odds_outcome(0, 4600), ODDS_ALL_DEAD);
+}
+
+BOOST_AUTO_TEST_CASE(mission_odds_run_test)
+{
+    struct odds_model m;
+    struct mission_odds odds;
+
+    // the computer player rolls no more than 98
+    launch_only(&m, 99);
+    mission_odds_run(&m, 100000, 1957, &odds);
+    BOOST_CHECK_EQUAL(odds.rollouts, 100000);
+    BOOST_CHECK_EQUAL(odds.count[ODDS_SUCCESS], 100000);
+    BOOST_CHECK(odds.low[ODDS_SUCCESS] > 0.99);
+    mission_odds_model_free(&m);
+}
+
+BOOST_AUTO_TEST_CASE(mission_odds_restore_test)
+{
+    struct odds_model m;
+    struct mission_odds odds;
+
+    // every launch fails, unless the flight still has its save card
+    launch_only(&m, 0);
+    m.data->P[0].Rocket[0].SaveCard = 1;
+    mission_odds_run(&m, 5000, 1, &odds);
+    BOOST_CHECK_EQUAL(odds.count[ODDS_SUCCESS], 5000);
+
+    // and the game's own copy is left alone
+    BOOST_CHECK_EQUAL(m.data->P[0].Rocket[0].SaveCard, 1);
+    BOOST_CHECK_EQUAL(m.data->P[0].Rocket[0].MisSucc, 0);
+    mission_odds_model_free(&m);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+
+#include "game/mixer.h"
+
+BOOST_AUTO_TEST_SUITE(mixer_suite)
+
+BOOST_AUTO_TEST_CASE(mixer_saturates_test)
+{
+    int16_t dst[32];
+    int16_t src[32];
+    struct mixer_voice voice;
+
+    for (int i = 0; i < 32; i++) {
+        dst[i] = 30000;
+        src[i] = 30000;
+    }
+
+    mixer_init_voice(&voice, MIXER_UNITY_GAIN);
+    mixer_mix(dst, src, 32, &voice);
+
+    for (int i = 0; i < 32; i++) {
+        BOOST_CHECK_EQUAL(dst[i], INT16_MAX);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mixer_ramp_test)
+{
+    int16_t dst[MIXER_RAMP_SAMPLES * 2];
+    int16_t src[MIXER_RAMP_SAMPLES * 2];
+    struct mixer_voice voice;
+
+    memset(dst, 0, sizeof(dst));
+
+    for (int i = 0; i < MIXER_RAMP_SAMPLES * 2; i++) {
+        src[i] = 10000;
+    }
+
+    mixer_init_voice(&voice, 0);
+    mixer_set_gain(&voice, MIXER_UNITY_GAIN);
+    mixer_mix(dst, src, MIXER_RAMP_SAMPLES * 2, &voice);
+
+    // the volume rises gradually, then stays at the target
+    BOOST_CHECK(dst[0] < dst[MIXER_RAMP_SAMPLES / 2]);
+    BOOST_CHECK(dst[MIXER_RAMP_SAMPLES / 2] < dst[MIXER_RAMP_SAMPLES * 2 - 1]);
+    BOOST_CHECK_EQUAL(voice.gain, MIXER_UNITY_GAIN);
+}
+
+BOOST_AUTO_TEST_CASE(mixer_kernels_match_test)
+{
+    int16_t src[1000];
+    int16_t scalar[1000];
+    int16_t fast[1000];
+
+    for (int i = 0; i < 1000; i++) {
+        src[i] = (int16_t)(i * 7919);
+        scalar[i] = fast[i] = (int16_t)(i * 104729);
+    }
+
+    struct mixer_voice v1, v2;
+    mixer_init_voice(&v1, mixer_gain(100, 128, 2));
+    mixer_init_voice(&v2, mixer_gain(100, 128, 2));
+
+    mixer_use_scalar(1);
+    mixer_mix(scalar, src, 997, &v1);
+    mixer_use_scalar(0);
+    mixer_mix(fast, src, 997, &v2);
+
+    BOOST_CHECK(memcmp(scalar, fast, sizeof(scalar)) == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+#include <boost/test/unit_test.hpp>
+
+#include "display/palette.h"
+
+using display::Palette;
+
+BOOST_AUTO_TEST_SUITE(palette_suite)
+
+BOOST_AUTO_TEST_CASE(palette_hash_follows_colors_test)
+{
+    Palette a, b;
+
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+
+    a.set(17, Color(10, 20, 30));
+    BOOST_CHECK(a.hash() != b.hash());
+    BOOST_CHECK(!a.matches(b));
+
+    b.set(17, Color(10, 20, 30));
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+    BOOST_CHECK(a.matches(b));
+
+    // Swapping two colors around must not look the same
+    a.set(18, Color(40, 50, 60));
+    b.set(17, Color(40, 50, 60));
+    b.set(18, Color(10, 20, 30));
+    BOOST_CHECK(a.hash() != b.hash());
+
+    a.set(17, Color(0, 0, 0, 0));
+    a.set(18, Color(0, 0, 0, 0));
+    BOOST_CHECK_EQUAL(a.hash(), Palette().hash());
+}
+
+BOOST_AUTO_TEST_CASE(palette_copy_hash_test)
+{
+    Palette a;
+
+    for (int i = 0; i < 256; i++) {
+        a.set(i, Color(i, 255 - i, i / 2));
+    }
+
+    Palette b(a);
+    Palette c(static_cast<const display::PaletteInterface &>(a));
+    Palette d;
+
+    d.copy_from(a);
+
+    BOOST_CHECK_EQUAL(b.hash(), a.hash());
+    BOOST_CHECK_EQUAL(c.hash(), a.hash());
+    BOOST_CHECK_EQUAL(d.hash(), a.hash());
+    BOOST_CHECK(d.matches(a));
+
+    // A copy that changes nothing leaves the palette alone
+    unsigned int version = d.version();
+    d.copy_from(a);
+    BOOST_CHECK_EQUAL(d.version(), version);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
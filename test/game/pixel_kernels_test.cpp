@@ -0,0 +1,132 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include "display/pixel_kernels.h"
+
+using display::PixelKernels;
+
+namespace
+{
+
+// Enough pixels to cover the vector loops and an odd tail
+const unsigned int COUNT = 32 * 5 + 16 + 7;
+
+std::vector<uint8_t> noise(unsigned int seed)
+{
+    std::vector<uint8_t> pixels(COUNT);
+
+    srand(seed);
+
+    for (unsigned int i = 0; i < COUNT; i++) {
+        // Plenty of matches for the tests to find
+        pixels[i] = (rand() % 3 == 0) ? 7 : rand() & 0xff;
+    }
+
+    return pixels;
+}
+
+// The loop LegacySurface::maskCopy() used to run
+void referenceMask(std::vector<uint8_t> &dst, const std::vector<uint8_t> &src,
+                   uint8_t maskValue, PixelKernels::MaskTest test, uint8_t offset)
+{
+    for (unsigned int i = 0; i < dst.size(); i++) {
+        bool pass = false;
+
+        switch (test) {
+        case PixelKernels::SourceEqual:
+            pass = src[i] == maskValue;
+            break;
+
+        case PixelKernels::SourceNotEqual:
+            pass = src[i] != maskValue;
+            break;
+
+        case PixelKernels::DestinationEqual:
+            pass = dst[i] == maskValue;
+            break;
+
+        case PixelKernels::DestinationNotEqual:
+            pass = dst[i] != maskValue;
+            break;
+        }
+
+        if (pass) {
+            dst[i] = src[i] + offset;
+        }
+    }
+}
+
+};
+
+BOOST_AUTO_TEST_SUITE(pixel_kernels_suite)
+
+BOOST_AUTO_TEST_CASE(pixel_kernels_mask_copy_test)
+{
+    const PixelKernels::Kernel kernels[] = {
+        PixelKernels::Scalar, PixelKernels::SSE2, PixelKernels::AVX2
+    };
+
+    for (int k = 0; k < 3; k++) {
+        if (!PixelKernels::supported(kernels[k])) {
+            continue;
+        }
+
+        PixelKernels pk(kernels[k]);
+
+        for (int test = 0; test < 4; test++) {
+            PixelKernels::MaskTest mode = static_cast<PixelKernels::MaskTest>(test);
+            std::vector<uint8_t> src = noise(1), dst = noise(2), expected = dst;
+
+            referenceMask(expected, src, 7, mode, 200);
+            pk.maskCopy(&dst[0], &src[0], COUNT, 7, mode, 200);
+
+            BOOST_CHECK_MESSAGE(dst == expected,
+                                PixelKernels::kernelName(kernels[k])
+                                << " maskCopy mode " << test);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pixel_kernels_filter_xor_test)
+{
+    const PixelKernels::Kernel kernels[] = {
+        PixelKernels::Scalar, PixelKernels::SSE2, PixelKernels::AVX2
+    };
+
+    for (int k = 0; k < 3; k++) {
+        if (!PixelKernels::supported(kernels[k])) {
+            continue;
+        }
+
+        PixelKernels pk(kernels[k]);
+        const char *name = PixelKernels::kernelName(kernels[k]);
+
+        for (int test = 0; test < 3; test++) {
+            std::vector<uint8_t> pixels = noise(3), expected = pixels;
+
+            for (unsigned int i = 0; i < COUNT; i++) {
+                if (test == PixelKernels::Any ||
+                    (expected[i] == 7) == (test == PixelKernels::Equal)) {
+                    expected[i] += 100;
+                }
+            }
+
+            pk.filter(&pixels[0], COUNT, 7, 100,
+                      static_cast<PixelKernels::FilterTest>(test));
+            BOOST_CHECK_MESSAGE(pixels == expected, name << " filter mode " << test);
+        }
+
+        std::vector<uint8_t> src = noise(4), dst = noise(5), expected = dst;
+
+        for (unsigned int i = 0; i < COUNT; i++) {
+            expected[i] ^= src[i];
+        }
+
+        pk.xorCopy(&dst[0], &src[0], COUNT);
+        BOOST_CHECK_MESSAGE(dst == expected, name << " xorCopy");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
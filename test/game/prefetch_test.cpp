@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+
+#include <SDL/SDL.h>
+
+#include "display/palette.h"
+#include "game/image_cache.h"
+#include "game/prefetch.h"
+
+namespace
+{
+
+volatile int decodes;
+
+// Stands in for decoding a PNG, slowly enough to be caught at it
+ImageCache::Image slowDecode(const std::string &filename)
+{
+    decodes++;
+    SDL_Delay(50);
+    return ImageCache::Image(
+               new display::PalettizedSurface(10, 10, display::Palette()));
+}
+
+ssize_t noAudio(const char *path, char **data, size_t *size)
+{
+    return -1;
+}
+
+void setUp()
+{
+    ImageCache::init(64 * 1024, prefetch_load_image);
+    ImageCache::clear();
+    prefetch_init(slowDecode, noAudio);
+    decodes = 0;
+}
+
+};
+
+BOOST_AUTO_TEST_SUITE(prefetch_suite)
+
+BOOST_AUTO_TEST_CASE(prefetch_collect_test)
+{
+    setUp();
+
+    prefetch_image("images/a.png", PREFETCH_NEXT);
+
+    for (int i = 0; i < 1000 && !ImageCache::cached("images/a.png"); i++) {
+        SDL_Delay(5);
+        prefetch_collect();
+    }
+
+    BOOST_REQUIRE(ImageCache::cached("images/a.png"));
+    ImageCache::get("images/a.png");
+    BOOST_CHECK_EQUAL(decodes, 1);
+
+    struct prefetch_stats stats;
+    prefetch_get_stats(&stats);
+    BOOST_CHECK_EQUAL(stats.collected, 1u);
+
+    prefetch_shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_wait_test)
+{
+    setUp();
+
+    prefetch_image("images/a.png", PREFETCH_NEXT);
+
+    while (decodes == 0) {
+        SDL_Delay(1);
+    }
+
+    // The worker is decoding it, so this waits instead of decoding again
+    ImageCache::Image image = ImageCache::get("images/a.png");
+    BOOST_CHECK(image);
+    BOOST_CHECK_EQUAL(decodes, 1);
+
+    struct prefetch_stats stats;
+    prefetch_get_stats(&stats);
+    BOOST_CHECK_EQUAL(stats.waited, 1u);
+
+    prefetch_shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_unhinted_test)
+{
+    setUp();
+
+    ImageCache::get("images/a.png");
+    BOOST_CHECK_EQUAL(decodes, 1);
+
+    // Cached images aren't decoded again
+    prefetch_image("images/a.png", PREFETCH_NEXT);
+    SDL_Delay(20);
+    BOOST_CHECK_EQUAL(decodes, 1);
+
+    prefetch_shutdown();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
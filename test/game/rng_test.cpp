@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+
+#include <math.h>
+#include <string.h>
+
+#include "game/rng.h"
+
+BOOST_AUTO_TEST_SUITE(rng_suite)
+
+BOOST_AUTO_TEST_CASE(rng_seed_test)
+{
+    struct rng a, b, c;
+
+    rng_seed(&a, 1977);
+    rng_seed(&b, 1977);
+    rng_seed(&c, 1978);
+
+    for (int i = 0; i < 1000; i++) {
+        uint64_t x = rng_next(&a);
+
+        BOOST_REQUIRE_EQUAL(x, rng_next(&b));
+        BOOST_CHECK(x != rng_next(&c));
+    }
+}
+
+// a stream nobody seeded mustn't be stuck on 0
+BOOST_AUTO_TEST_CASE(rng_unseeded_test)
+{
+    struct rng r, seeded;
+    int zeros = 0;
+
+    memset(&r, 0, sizeof(r));
+    rng_seed(&seeded, 0);
+
+    for (int i = 0; i < 100; i++) {
+        uint64_t x = rng_next(&r);
+
+        BOOST_REQUIRE_EQUAL(x, rng_next(&seeded));
+        zeros += (x == 0);
+    }
+
+    BOOST_CHECK_EQUAL(zeros, 0);
+}
+
+BOOST_AUTO_TEST_CASE(rng_below_test)
+{
+    struct rng r;
+    int seen[7] = {0};
+
+    rng_seed(&r, 1);
+
+    BOOST_CHECK_EQUAL(rng_below(&r, 0), 0);
+    BOOST_CHECK_EQUAL(rng_below(&r, 1), 0);
+
+    for (int i = 0; i < 7000; i++) {
+        int x = rng_below(&r, 7);
+
+        BOOST_REQUIRE(x >= 0 && x < 7);
+        seen[x]++;
+    }
+
+    for (int i = 0; i < 7; i++) {
+        BOOST_CHECK(seen[i] > 800 && seen[i] < 1200);
+    }
+}
+
+// the table lookup must match the 250 rolls it replaces
+BOOST_AUTO_TEST_CASE(rng_bell_test)
+{
+    const int draws = 20000;
+    struct rng r;
+    double table = 0, rolled = 0;
+    double table_sq = 0, rolled_sq = 0;
+
+    rng_seed(&r, 57);
+
+    for (int n = 0; n < draws; n++) {
+        int x = rng_bell(&r);
+        int nval;
+
+        BOOST_REQUIRE(x >= 0 && x < RNG_BELL_VALUES);
+        table += x;
+        table_sq += x * x;
+
+        do {
+            nval = 107;
+
+            for (int i = 0; i < 250; i++) {
+                nval += rng_below(&r, 7) - 3;
+            }
+        } while (nval < 50 || nval > 150);
+
+        rolled += nval - 50;
+        rolled_sq += (nval - 50) * (nval - 50);
+    }
+
+    table /= draws;
+    rolled /= draws;
+    BOOST_CHECK_CLOSE(table, rolled, 1.0);
+    BOOST_CHECK_CLOSE(sqrt(table_sq / draws - table * table),
+                      sqrt(rolled_sq / draws - rolled * rolled), 3.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
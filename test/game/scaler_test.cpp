@@ -0,0 +1,65 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include "display/scaler.h"
+
+using display::Scaler;
+
+namespace
+{
+
+// Enough pixels to cover the vector loops and an odd tail
+const unsigned int WIDTH = 32 * 2 + 8 + 5;
+const unsigned int HEIGHT = 4;
+
+// Convert the area at (1, 1) of a noise screen with the given kernel
+std::vector<uint8_t> convert(Scaler::Kernel kernel, unsigned int factor,
+                             unsigned int bytesPerPixel)
+{
+    std::vector<uint8_t> src(WIDTH * HEIGHT);
+    uint32_t colors[256];
+    // odd pitch, so rows don't start on a vector boundary
+    const unsigned int pitch = WIDTH * factor * bytesPerPixel + 3;
+    std::vector<uint8_t> dst(pitch * HEIGHT * factor, 0xcd);
+
+    srand(factor * 10 + bytesPerPixel);
+
+    for (unsigned int i = 0; i < src.size(); i++) {
+        src[i] = rand() & 0xff;
+    }
+
+    for (unsigned int i = 0; i < 256; i++) {
+        colors[i] = rand() & ((bytesPerPixel == 2) ? 0xffff : 0xffffff);
+    }
+
+    Scaler(factor, kernel).scaleConvert(&src[0], WIDTH, &dst[0], pitch,
+                                        bytesPerPixel, colors,
+                                        1, 1, WIDTH - 1, HEIGHT - 1);
+    return dst;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(scaler_suite)
+
+BOOST_AUTO_TEST_CASE(scale_convert_kernels_match_scalar)
+{
+    const Scaler::Kernel kernels[] = { Scaler::SSE2, Scaler::AVX2 };
+
+    for (unsigned int k = 0; k < 2; k++) {
+        if (!Scaler::supported(kernels[k])) {
+            continue;
+        }
+
+        for (unsigned int bpp = 2; bpp <= 4; bpp++) {
+            for (unsigned int f = Scaler::MIN_FACTOR; f <= Scaler::MAX_FACTOR; f++) {
+                BOOST_CHECK_MESSAGE(convert(kernels[k], f, bpp) == convert(Scaler::Scalar, f, bpp),
+                                    Scaler::kernelName(kernels[k]) << " " << bpp << "bpp " << f << "x");
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
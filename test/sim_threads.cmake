@@ -0,0 +1,44 @@
+# Plays the same campaigns with one thread and with several, which must
+# give the same game for game results.
+#
+# usage: cmake -D SIM=raceintospace-sim -D DATA=data -D SAVE=dir
+#              [-D GAMES=4] [-D JOBS=4] [-D SEED=1] -P sim_threads.cmake
+
+if (NOT GAMES)
+  set(GAMES 4)
+endif (NOT GAMES)
+if (NOT JOBS)
+  set(JOBS 4)
+endif (NOT JOBS)
+if (NOT SEED)
+  set(SEED 1)
+endif (NOT SEED)
+
+file(MAKE_DIRECTORY ${SAVE})
+
+foreach (jobs 1 ${JOBS})
+  execute_process(
+    COMMAND ${SIM} -g ${GAMES} -j ${jobs} -s ${SEED}
+            BARIS_DATA=${DATA} BARIS_SAVE=${SAVE}
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result
+    )
+
+  if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${SIM} -j ${jobs} failed: ${result}\n${output}")
+  endif (NOT result EQUAL 0)
+
+  # only the games, not the timings
+  string(REGEX MATCHALL "game [0-9]+: [^\n]*" games_${jobs} "${output}")
+  list(LENGTH games_${jobs} played)
+
+  if (NOT played EQUAL GAMES)
+    message(FATAL_ERROR "-j ${jobs} played ${played} of ${GAMES} games:\n${output}")
+  endif (NOT played EQUAL GAMES)
+endforeach (jobs)
+
+if (NOT "${games_1}" STREQUAL "${games_${JOBS}}")
+  string(REPLACE ";" "\n" one "${games_1}")
+  string(REPLACE ";" "\n" many "${games_${JOBS}}")
+  message(FATAL_ERROR "-j 1 and -j ${JOBS} differ\n-j 1:\n${one}\n-j ${JOBS}:\n${many}")
+endif (NOT "${games_1}" STREQUAL "${games_${JOBS}}")